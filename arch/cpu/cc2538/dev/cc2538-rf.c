@@ -595,6 +595,7 @@ init(void)
 
   set_poll_mode(poll_mode);
 
+  process_set_priority(&cc2538_rf_process, PROCESS_PRIORITY_HIGH);
   process_start(&cc2538_rf_process, NULL);
 
   rf_flags |= RF_ON;
@@ -35,5 +35,8 @@
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE     1
 #define GPIO_HAL_CONF_PORT_PIN_NUMBERING 0
 /*---------------------------------------------------------------------------*/
+#define ATOMIC_CONF_ARCH_HEADER_PATH         "atomic-native.h"
+#define MEMORY_BARRIER_CONF_ARCH_HEADER_PATH "memory-barrier-native.h"
+/*---------------------------------------------------------------------------*/
 #endif /* NATIVE_DEF_H_ */
 /*---------------------------------------------------------------------------*/
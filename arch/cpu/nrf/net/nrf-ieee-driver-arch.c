@@ -568,6 +568,7 @@ init(void)
   nrf_clock_event_clear(NRF_CLOCK, NRF_CLOCK_EVENT_HFCLKSTARTED);
 
   /* Start the RF driver process */
+  process_set_priority(&nrf_ieee_rf_process, PROCESS_PRIORITY_HIGH);
   process_start(&nrf_ieee_rf_process, NULL);
 
   /* Prepare the RX buffer */
@@ -524,6 +524,7 @@ init(void)
   nrf_clock_event_clear(NRF_CLOCK_EVENT_HFCLKSTARTED);
 
   /* Start the RF driver process */
+  process_set_priority(&nrf52840_ieee_rf_process, PROCESS_PRIORITY_HIGH);
   process_start(&nrf52840_ieee_rf_process, NULL);
 
   /* Prepare the RX buffer */
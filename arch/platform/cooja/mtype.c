@@ -42,6 +42,7 @@
 #include "contiki.h"
 #include "sys/cc.h"
 #include "sys/cooja_mt.h"
+#include "sys/deadline.h"
 
 /* The main function, implemented in contiki-main.c */
 int main(void);
@@ -57,6 +58,12 @@ intptr_t referenceVar;
  */
 static struct cooja_mt_thread rtimer_thread;
 static struct cooja_mt_thread process_run_thread;
+
+/*
+ * Whether the mote was left idle at the end of the last tick, and when.
+ */
+static int idle;
+static rtimer_clock_t idle_start;
 /*---------------------------------------------------------------------------*/
 static void
 rtimer_thread_loop(void *data)
@@ -93,6 +100,12 @@ cooja_tick(void)
 {
   simProcessRunValue = 0;
 
+  /* Account for the idle time since the last tick. Without the
+     deadline-driven wake-ups, the mote would tick every clock tick. */
+  if(idle) {
+    deadline_wakeup(RTIMER_NOW() - idle_start, RTIMER_SECOND / CLOCK_SECOND);
+  }
+
   /* Let all simulation interfaces act first */
   doActionsBeforeTick();
 
@@ -119,4 +132,7 @@ cooja_tick(void)
 
   /* Save nearest expiration time */
   simEtimerNextExpirationTime = etimer_next_expiration_time();
+
+  idle = simProcessRunValue == 0;
+  idle_start = RTIMER_NOW();
 }
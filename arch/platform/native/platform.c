@@ -68,6 +68,8 @@
 #include "net/ipv6/uip-ds6.h"
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
+#include "sys/deadline.h"
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "Native"
@@ -299,11 +301,29 @@ platform_main_loop()
     int i;
     int retval;
     struct timeval tv;
+    rtimer_clock_t deadline;
+    rtimer_clock_t idle_start;
+    int idle;
 
     retval = process_run();
 
-    tv.tv_sec = retval ? 0 : SELECT_TIMEOUT / 1000;
-    tv.tv_usec = retval ? 1 : (SELECT_TIMEOUT * 1000) % 1000000;
+    idle = retval == 0;
+    if(!idle) {
+      tv.tv_sec = 0;
+      tv.tv_usec = 1;
+    } else if(deadline_next(&deadline)) {
+      /* Sleep until the next timer is due. */
+      idle_start = RTIMER_NOW();
+      deadline = RTIMER_CLOCK_LT(deadline, idle_start) ?
+        0 : deadline - idle_start;
+      tv.tv_sec = deadline / RTIMER_SECOND;
+      tv.tv_usec = (uint64_t)(deadline % RTIMER_SECOND) * 1000000 /
+        RTIMER_SECOND;
+    } else {
+      tv.tv_sec = SELECT_TIMEOUT / 1000;
+      tv.tv_usec = (SELECT_TIMEOUT * 1000) % 1000000;
+    }
+    idle_start = RTIMER_NOW();
 
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
@@ -328,6 +348,11 @@ platform_main_loop()
       }
     }
 
+    if(idle) {
+      deadline_wakeup(RTIMER_NOW() - idle_start,
+                      (rtimer_clock_t)SELECT_TIMEOUT * RTIMER_SECOND / 1000);
+    }
+
     etimer_request_poll();
   }
 }
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *   Compares the cost of queue operations on the singly-linked list, the
+ *   tail list and the doubly-linked list at queue lengths seen in the
+ *   network stack (a few packets per neighbour up to a routing table).
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/list.h"
+#include "lib/tail-list.h"
+#include "lib/dbl-list.h"
+#include "lib/random.h"
+#include "dev/watchdog.h"
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+PROCESS(list_benchmark_process, "List benchmark process");
+AUTOSTART_PROCESSES(&list_benchmark_process);
+/*---------------------------------------------------------------------------*/
+/* How long each (workload, variant, size) combination runs */
+#define BENCH_DURATION      (RTIMER_SECOND / 4)
+/* Operations between two reads of the clock */
+#define BENCH_BATCH         256
+#define BENCH_ELEMENTS_MAX  64
+/*---------------------------------------------------------------------------*/
+typedef struct bench_elem_s {
+  struct bench_elem_s *next;
+  struct bench_elem_s *previous;
+} bench_elem_t;
+
+static bench_elem_t elements[BENCH_ELEMENTS_MAX];
+static uint8_t picks[BENCH_BATCH];
+static const uint8_t sizes[] = { 4, 16, 64 };
+
+LIST(bench_list);
+TAIL_LIST(bench_tail_list);
+DBL_LIST(bench_dbl_list);
+/*---------------------------------------------------------------------------*/
+static void
+fill_list(int n)
+{
+  int i;
+
+  list_init(bench_list);
+  for(i = 0; i < n; i++) {
+    list_add(bench_list, &elements[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fifo_list(int n)
+{
+  int i;
+  void *e;
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    e = list_pop(bench_list);
+    list_add(bench_list, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+churn_list(int n)
+{
+  int i;
+  void *e;
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    e = &elements[picks[i] % n];
+    list_remove(bench_list, e);
+    list_add(bench_list, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_tail_list(int n)
+{
+  int i;
+
+  tail_list_init(bench_tail_list);
+  for(i = 0; i < n; i++) {
+    tail_list_add(bench_tail_list, &elements[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fifo_tail_list(int n)
+{
+  int i;
+  void *e;
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    e = tail_list_pop(bench_tail_list);
+    tail_list_add(bench_tail_list, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+churn_tail_list(int n)
+{
+  int i;
+  void *e;
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    e = &elements[picks[i] % n];
+    tail_list_remove(bench_tail_list, e);
+    tail_list_add(bench_tail_list, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_dbl_list(int n)
+{
+  int i;
+
+  dbl_list_init(bench_dbl_list);
+  for(i = 0; i < n; i++) {
+    dbl_list_add_tail(bench_dbl_list, &elements[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fifo_dbl_list(int n)
+{
+  int i;
+  void *e;
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    e = dbl_list_head(bench_dbl_list);
+    dbl_list_unlink(bench_dbl_list, e);
+    dbl_list_add_tail(bench_dbl_list, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+churn_dbl_list(int n)
+{
+  int i;
+  void *e;
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    e = &elements[picks[i] % n];
+    dbl_list_unlink(bench_dbl_list, e);
+    dbl_list_add_tail(bench_dbl_list, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct variant {
+  const char *name;
+  void (*fill)(int n);
+  void (*fifo)(int n);
+  void (*churn)(int n);
+};
+
+static const struct variant variants[] = {
+  { "list", fill_list, fifo_list, churn_list },
+  { "tail-list", fill_tail_list, fifo_tail_list, churn_tail_list },
+  { "dbl-list", fill_dbl_list, fifo_dbl_list, churn_dbl_list },
+};
+#define VARIANT_COUNT (sizeof(variants) / sizeof(variants[0]))
+/*---------------------------------------------------------------------------*/
+/* Returns the average cost of one operation, in nanoseconds */
+static unsigned long
+run(void (*fill)(int n), void (*batch)(int n), int n)
+{
+  rtimer_clock_t start;
+  int32_t elapsed;
+  uint32_t ops = 0;
+
+  memset(elements, 0, sizeof(elements));
+  fill(n);
+
+  start = RTIMER_NOW();
+  do {
+    batch(n);
+    ops += BENCH_BATCH;
+    watchdog_periodic();
+    elapsed = RTIMER_CLOCK_DIFF(RTIMER_NOW(), start);
+  } while(elapsed < BENCH_DURATION);
+
+  return (unsigned long)((uint64_t)elapsed * 1000000000 / RTIMER_SECOND / ops);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_workload(const char *workload, int churn)
+{
+  int i, v;
+
+  for(i = 0; i < sizeof(sizes); i++) {
+    printf("%-6s %4u", workload, sizes[i]);
+    for(v = 0; v < VARIANT_COUNT; v++) {
+      printf(" %10lu",
+             run(variants[v].fill,
+                 churn ? variants[v].churn : variants[v].fifo, sizes[i]));
+    }
+    printf("\n");
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(list_benchmark_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < BENCH_BATCH; i++) {
+    picks[i] = random_rand();
+  }
+
+  /*
+   * fifo:  take the head and append it at the tail (a packet queue)
+   * churn: remove a random element and append it at the tail (a
+   *        transaction table where entries complete out of order)
+   */
+  printf("List benchmark: ns per operation\n");
+  printf("%-6s %4s %10s %10s %10s\n", "work", "len",
+         variants[0].name, variants[1].name, variants[2].name);
+  run_workload("fifo", 0);
+  run_workload("churn", 1);
+  printf("Done\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
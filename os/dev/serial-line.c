@@ -132,6 +132,7 @@ void
 serial_line_init(void)
 {
   ringbuf_init(&rxbuf, rxbuf_data, sizeof(rxbuf_data));
+  process_set_priority(&serial_line_process, PROCESS_PRIORITY_HIGH);
   process_start(&serial_line_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
@@ -45,6 +45,19 @@
 #define AES_128_BLOCK_SIZE 16
 #define AES_128_KEY_LENGTH 16
 
+/*
+ * When AES_128_CONF_WITH_TTABLE is enabled, the software AES driver
+ * combines SubBytes, ShiftRows and MixColumns into lookups in a
+ * 1 kilobyte table of 32-bit words. This is several times faster on
+ * 32-bit processors, but takes more code space, so it is disabled by
+ * default.
+ */
+#ifdef AES_128_CONF_WITH_TTABLE
+#define AES_128_WITH_TTABLE AES_128_CONF_WITH_TTABLE
+#else /* AES_128_CONF_WITH_TTABLE */
+#define AES_128_WITH_TTABLE 0
+#endif /* AES_128_CONF_WITH_TTABLE */
+
 #ifdef AES_128_CONF
 #define AES_128            AES_128_CONF
 #else /* AES_128_CONF */
@@ -57,7 +70,9 @@
 struct aes_128_driver {
   
   /**
-   * \brief Sets the current key.
+   * \brief Sets the current key. The software driver keeps the key
+   *        schedule, and only expands a key that differs from the
+   *        previous one.
    */
   void (* set_key)(const uint8_t *key);
   
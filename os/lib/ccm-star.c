@@ -64,85 +64,28 @@ set_iv(uint8_t *iv,
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
+/* Adds the additional authenticated data to the CBC-MAC state x */
 static void
-ctr_step(const uint8_t *nonce,
-    uint16_t pos,
-    uint8_t *m_and_result,
-    uint16_t m_len,
-    uint16_t counter)
+mic_add_auth_data(uint8_t *x, const uint8_t *a, uint16_t a_len)
 {
-  uint8_t a[AES_128_BLOCK_SIZE];
+  uint32_t pos; /* 32-bits as can need to exceed a_len to reach end of loop */
   uint8_t i;
 
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  AES_128.encrypt(a);
-
-  for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
+  x[0] = x[0] ^ (a_len >> 8);
+  x[1] = x[1] ^ a_len;
+  for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
+    x[i] ^= a[i - 2];
   }
-}
-/*---------------------------------------------------------------------------*/
-static void
-mic(const uint8_t *nonce,
-    const uint8_t *m, uint16_t m_len,
-    const uint8_t *a, uint16_t a_len,
-    uint8_t *result,
-    uint8_t mic_len)
-{
-  uint8_t x[AES_128_BLOCK_SIZE];
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint8_t i;
 
-  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
   AES_128.encrypt(x);
 
-  if(a_len) {
-    x[0] = x[0] ^ (a_len >> 8);
-    x[1] = x[1] ^ a_len;
-    for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-      x[i] ^= a[i - 2];
-    }
-
-    AES_128.encrypt(x);
-
-    pos = 14;
-    while(pos < a_len) {
-      for(i = 0; (pos + i < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= a[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
-  }
-
-  if(m_len) {
-    pos = 0;
-    while(pos < m_len) {
-      for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= m[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
+  pos = 14;
+  while(pos < a_len) {
+    for(i = 0; (pos + i < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
+      x[i] ^= a[pos + i];
     }
-  }
-
-  ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0);
-
-  memcpy(result, x, mic_len);
-}
-/*---------------------------------------------------------------------------*/
-static void
-ctr(const uint8_t *nonce, uint8_t *m, uint16_t m_len)
-{
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint16_t counter;
-
-  pos = 0;
-  counter = 1;
-  while(pos < m_len) {
-    ctr_step(nonce, pos, m, m_len, counter++);
     pos += AES_128_BLOCK_SIZE;
+    AES_128.encrypt(x);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -152,6 +95,11 @@ set_key(const uint8_t *key)
   AES_128.set_key(key);
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Authenticates and encrypts, or decrypts and authenticates, the
+ * message in one pass. Each block of m is added to the CBC-MAC while
+ * it is plaintext, and XORed with its key stream block.
+ */
 static void
 aead(const uint8_t* nonce,
     uint8_t* m, uint16_t m_len,
@@ -159,24 +107,50 @@ aead(const uint8_t* nonce,
     uint8_t *result, uint8_t mic_len,
     int forward)
 {
+  uint8_t x[AES_128_BLOCK_SIZE]; /* CBC-MAC state */
+  uint8_t s[AES_128_BLOCK_SIZE]; /* key stream block */
+  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
+  uint16_t counter;
+  uint8_t i;
+  uint8_t len;
+
   if(a_len > MAX_A_LEN || !MIC_LEN_VALID(mic_len)) {
     return;
   }
 
-  if(!forward) {
-    /* decrypt */
-    ctr(nonce, m, m_len);
+  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
+  AES_128.encrypt(x);
+
+  if(a_len) {
+    mic_add_auth_data(x, a, a_len);
   }
 
-  mic(nonce,
-    m, m_len,
-    a, a_len,
-    result,
-    mic_len);
+  counter = 1;
+  for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+    len = m_len - pos < AES_128_BLOCK_SIZE ? m_len - pos : AES_128_BLOCK_SIZE;
+
+    set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+    AES_128.encrypt(s);
+
+    if(forward) {
+      for(i = 0; i < len; i++) {
+        x[i] ^= m[pos + i];
+        m[pos + i] ^= s[i];
+      }
+    } else {
+      for(i = 0; i < len; i++) {
+        m[pos + i] ^= s[i];
+        x[i] ^= m[pos + i];
+      }
+    }
+    AES_128.encrypt(x);
+  }
 
-  if(forward) {
-    /* encrypt */
-    ctr(nonce, m, m_len);
+  /* The MIC is encrypted with the key stream block for counter 0 */
+  set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  AES_128.encrypt(s);
+  for(i = 0; i < mic_len; i++) {
+    result[i] = x[i] ^ s[i];
   }
 }
 /*---------------------------------------------------------------------------*/
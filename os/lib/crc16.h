@@ -55,6 +55,34 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+#include "contiki.h"
+
+/**
+ * \name CRC16 implementations
+ *
+ * The bitwise implementation needs no tables. The nibble table takes
+ * 32 bytes, the byte table 512 bytes, and slice-by-4, which processes
+ * four bytes per step in crc16_data(), 2 kilobytes.
+ * @{
+ */
+#define CRC16_IMPL_BITWISE 0
+#define CRC16_IMPL_NIBBLE  1
+#define CRC16_IMPL_TABLE   2
+#define CRC16_IMPL_SLICE4  3
+/** @} */
+
+#ifdef CRC16_CONF_IMPL
+#define CRC16_IMPL CRC16_CONF_IMPL
+#else /* CRC16_CONF_IMPL */
+#define CRC16_IMPL CRC16_IMPL_BITWISE
+#endif /* CRC16_CONF_IMPL */
+
+/*
+ * Platforms with a CRC engine that computes the same CRC can define
+ * CRC16_CONF_DATA as the name of a function with the signature of
+ * crc16_data(), which is then used for all data areas.
+ */
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -65,10 +93,10 @@
  *             with one byte. It can be used as a running checksum, or
  *             to checksum an entire data block.
  *
- *             \note The algorithm used in this implementation is
+ *             \note With the default bitwise implementation, this is
  *             tailored for a running checksum and does not perform as
  *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             entire data block. See CRC16_CONF_IMPL.
  *
  */
 unsigned short crc16_add(unsigned char b, unsigned short crc);
@@ -80,12 +108,13 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  * \param acc  The accumulated CRC that is to be updated (or zero).
  * \return     The CRC16 checksum.
  *
- *             This function calculates the CRC16 checksum of a data area.
+ *             This function calculates the CRC16 checksum of a data
+ *             area. The checksum of a data area split in several parts
+ *             can be calculated by passing the result for each part
+ *             as acc for the next one.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             The implementation is selected with CRC16_CONF_IMPL,
+ *             or by the platform with CRC16_CONF_DATA.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
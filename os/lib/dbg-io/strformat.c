@@ -31,6 +31,7 @@
 /*---------------------------------------------------------------------------*/
 #include "contiki.h"
 
+#include <limits.h>
 #include <string.h>
 #include <strformat.h>
 /*---------------------------------------------------------------------------*/
@@ -56,6 +57,16 @@
 #ifndef POINTER_INT
 #define POINTER_INT uintptr_t
 #endif
+
+/*
+ * Output is collected in a buffer of this size on the stack and passed to
+ * write_str() in as few calls as possible. 0 passes every piece directly.
+ */
+#ifdef STRFORMAT_CONF_BUFFER_SIZE
+#define STRFORMAT_BUFFER_SIZE STRFORMAT_CONF_BUFFER_SIZE
+#else
+#define STRFORMAT_BUFFER_SIZE 32
+#endif
 /*---------------------------------------------------------------------------*/
 typedef uint32_t FormatFlags;
 /*---------------------------------------------------------------------------*/
@@ -134,6 +145,14 @@ typedef uint32_t FormatFlags;
 /*---------------------------------------------------------------------------*/
 #define CHECKCB(res) { if((res) != STRFORMAT_OK) { va_end(ap); return -1; } }
 /*---------------------------------------------------------------------------*/
+struct output {
+  const strformat_context_t *ctxt;
+#if STRFORMAT_BUFFER_SIZE > 0
+  unsigned int len;
+  char buf[STRFORMAT_BUFFER_SIZE];
+#endif
+};
+/*---------------------------------------------------------------------------*/
 #define MAXCHARS_HEX ((sizeof(LARGEST_UNSIGNED) * 8) / 4)
 
 /* Largest number of characters needed for converting an unsigned integer. */
@@ -188,17 +207,46 @@ parse_uint(const char **posp)
   return v;
 }
 /*---------------------------------------------------------------------------*/
+static const char digit_pairs[] =
+  "00010203040506070809101112131415161718192021222324"
+  "25262728293031323334353637383940414243444546474849"
+  "50515253545556575859606162636465666768697071727374"
+  "75767778798081828384858687888990919293949596979899";
+/*---------------------------------------------------------------------------*/
 static unsigned int
 output_uint_decimal(char **posp, LARGEST_UNSIGNED v)
 {
   unsigned int len;
+  unsigned int d;
+  uint32_t v32;
   char *pos = *posp;
 
-  while(v > 0) {
+  /*
+   * Wide division is a library call on most targets, so only the digits
+   * that do not fit in 32 bits are produced with it. The rest are
+   * produced two at a time; the compiler turns division by the constant
+   * 100 into a multiplication.
+   */
+  while(v > UINT32_MAX) {
     *--pos = (v % 10) + '0';
     v /= 10;
   }
 
+  v32 = v;
+  while(v32 >= 100) {
+    d = (v32 % 100) * 2;
+    v32 /= 100;
+    *--pos = digit_pairs[d + 1];
+    *--pos = digit_pairs[d];
+  }
+  if(v32 >= 10) {
+    d = v32 * 2;
+    *--pos = digit_pairs[d + 1];
+    *--pos = digit_pairs[d];
+  } else if(v32 > 0) {
+    *--pos = v32 + '0';
+  }
+
   len = *posp - pos;
   *posp = pos;
 
@@ -210,11 +258,16 @@ output_uint_hex(char **posp, LARGEST_UNSIGNED v, unsigned int flags)
 {
   unsigned int len;
   const char *hex = (flags & CAPS_YES) ? "0123456789ABCDEF" : "0123456789abcdef";
+  uint32_t v32;
   char *pos = *posp;
 
-  while(v > 0) {
-    *--pos = hex[(v % 16)];
-    v /= 16;
+  while(v > UINT32_MAX) {
+    *--pos = hex[v & 0xf];
+    v >>= 4;
+  }
+
+  for(v32 = v; v32 > 0; v32 >>= 4) {
+    *--pos = hex[v32 & 0xf];
   }
 
   len = *posp - pos;
@@ -227,11 +280,16 @@ static unsigned int
 output_uint_octal(char **posp, LARGEST_UNSIGNED v)
 {
   unsigned int len;
+  uint32_t v32;
   char *pos = *posp;
 
-  while(v > 0) {
-    *--pos = (v % 8) + '0';
-    v /= 8;
+  while(v > UINT32_MAX) {
+    *--pos = (v & 7) + '0';
+    v >>= 3;
+  }
+
+  for(v32 = v; v32 > 0; v32 >>= 3) {
+    *--pos = (v32 & 7) + '0';
   }
 
   len = *posp - pos;
@@ -241,13 +299,51 @@ output_uint_octal(char **posp, LARGEST_UNSIGNED v)
 }
 /*---------------------------------------------------------------------------*/
 static strformat_result
-fill_space(const strformat_context_t *ctxt, unsigned int len)
+output_flush(struct output *out)
+{
+#if STRFORMAT_BUFFER_SIZE > 0
+  unsigned int len = out->len;
+
+  if(len > 0) {
+    out->len = 0;
+    return out->ctxt->write_str(out->ctxt->user_data, out->buf, len);
+  }
+#endif
+  return STRFORMAT_OK;
+}
+/*---------------------------------------------------------------------------*/
+static strformat_result
+output_write(struct output *out, const char *data, unsigned int len)
+{
+#if STRFORMAT_BUFFER_SIZE > 0
+  strformat_result res;
+
+  if(out->len + len > STRFORMAT_BUFFER_SIZE) {
+    res = output_flush(out);
+    if(res != STRFORMAT_OK) {
+      return res;
+    }
+    if(len > STRFORMAT_BUFFER_SIZE / 2) {
+      /* Long pieces go out directly instead of being copied */
+      return out->ctxt->write_str(out->ctxt->user_data, data, len);
+    }
+  }
+  memcpy(&out->buf[out->len], data, len);
+  out->len += len;
+  return STRFORMAT_OK;
+#else
+  return out->ctxt->write_str(out->ctxt->user_data, data, len);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static strformat_result
+fill_space(struct output *out, unsigned int len)
 {
   strformat_result res;
   static const char buffer[16] = "                ";
 
   while(len > 16) {
-    res = ctxt->write_str(ctxt->user_data, buffer, 16);
+    res = output_write(out, buffer, 16);
     if(res != STRFORMAT_OK) {
       return res;
     }
@@ -258,17 +354,17 @@ fill_space(const strformat_context_t *ctxt, unsigned int len)
     return STRFORMAT_OK;
   }
 
-  return ctxt->write_str(ctxt->user_data, buffer, len);
+  return output_write(out, buffer, len);
 }
 /*---------------------------------------------------------------------------*/
 static strformat_result
-fill_zero(const strformat_context_t *ctxt, unsigned int len)
+fill_zero(struct output *out, unsigned int len)
 {
   strformat_result res;
   static const char buffer[16] = "0000000000000000";
 
   while(len > 16) {
-    res = ctxt->write_str(ctxt->user_data, buffer, 16);
+    res = output_write(out, buffer, 16);
     if(res != STRFORMAT_OK) {
       return res;
     }
@@ -278,7 +374,7 @@ fill_zero(const strformat_context_t *ctxt, unsigned int len)
   if(len == 0) {
     return STRFORMAT_OK;
   }
-  return ctxt->write_str(ctxt->user_data, buffer, len);
+  return output_write(out, buffer, len);
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -297,6 +393,12 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
 {
   unsigned int written = 0;
   const char *pos = format;
+  struct output out;
+
+  out.ctxt = ctxt;
+#if STRFORMAT_BUFFER_SIZE > 0
+  out.len = 0;
+#endif
 
   while(*pos != '\0') {
     FormatFlags flags;
@@ -310,20 +412,18 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
     }
 
     if(pos != start) {
-      CHECKCB(ctxt->write_str(ctxt->user_data, start, pos - start));
+      CHECKCB(output_write(&out, start, pos - start));
       written += pos - start;
     }
 
     if(*pos == '\0') {
-      va_end(ap);
-      return written;
+      break;
     }
 
     pos++;
 
     if(*pos == '\0') {
-      va_end(ap);
-      return written;
+      break;
     }
 
     flags = parse_flags(&pos);
@@ -447,6 +547,7 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
       flags |= CONV_PERCENT;
       break;
     case '\0':
+      CHECKCB(output_flush(&out));
       va_end(ap);
       return written;
     }
@@ -454,7 +555,7 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
 
     switch(flags & CONV_MASK) {
     case CONV_PERCENT:
-      CHECKCB(ctxt->write_str(ctxt->user_data, "%", 1));
+      CHECKCB(output_write(&out, "%", 1));
       written++;
       break;
     case CONV_INTEGER:
@@ -503,7 +604,7 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
 #endif
         }
         if(value < 0) {
-          uvalue = -value;
+          uvalue = -(LARGEST_UNSIGNED)value;
           negative = 1;
         } else {
           uvalue = value;
@@ -594,23 +695,23 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
           precision_fill += field_fill;
           field_fill = 0; /* Do not double count padding */
         } else {
-          CHECKCB(fill_space(ctxt, field_fill));
+          CHECKCB(fill_space(&out, field_fill));
         }
       }
 
       if(prefix_len > 0) {
-        CHECKCB(ctxt->write_str(ctxt->user_data, prefix, prefix_len));
+        CHECKCB(output_write(&out, prefix, prefix_len));
       }
       written += prefix_len;
 
-      CHECKCB(fill_zero(ctxt, precision_fill));
+      CHECKCB(fill_zero(&out, precision_fill));
       written += precision_fill;
 
-      CHECKCB(ctxt->write_str(ctxt->user_data, conv_pos, conv_len));
+      CHECKCB(output_write(&out, conv_pos, conv_len));
       written += conv_len;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_LEFT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
       }
       written += field_fill;
     }
@@ -622,9 +723,9 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
       char *str = va_arg(ap, char *);
 
       if(str) {
-        char *pos = str;
-        while(*pos != '\0') pos++;
-        len = pos - str;
+        /* Do not read past the precision, the string may be unterminated */
+        unsigned int max = precision >= 0 ? precision : UINT_MAX;
+        for(len = 0; len < max && str[len] != '\0'; len++);
       } else {
         str = "(null)";
         len = 6;
@@ -637,14 +738,14 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
       field_fill = (minwidth > len) ? minwidth - len : 0;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_RIGHT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
       }
 
-      CHECKCB(ctxt->write_str(ctxt->user_data, str, len));
+      CHECKCB(output_write(&out, str, len));
       written += len;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_LEFT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
       }
       written += field_fill;
     }
@@ -673,14 +774,14 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
       field_fill = (minwidth > conv_len) ? minwidth - conv_len : 0;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_RIGHT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
       }
 
-      CHECKCB(ctxt->write_str(ctxt->user_data, conv_pos, conv_len));
+      CHECKCB(output_write(&out, conv_pos, conv_len));
       written += conv_len;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_LEFT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
       }
 
       written += field_fill;
@@ -692,17 +793,17 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
       unsigned int field_fill = (minwidth > 1) ? minwidth - 1 : 0;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_RIGHT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
         written += field_fill;
       }
 
-      CHECKCB(ctxt->write_str(ctxt->user_data, &ch, 1));
+      CHECKCB(output_write(&out, &ch, 1));
       written++;
 
       if((flags & JUSTIFY_MASK) == JUSTIFY_LEFT) {
-        CHECKCB(fill_space(ctxt, field_fill));
+        CHECKCB(fill_space(&out, field_fill));
+        written += field_fill;
       }
-      written += field_fill;
     }
     break;
     case CONV_WRITTEN:
@@ -714,6 +815,8 @@ format_str_v(const strformat_context_t *ctxt, const char *format, va_list ap)
     }
   }
 
+  CHECKCB(output_flush(&out));
+  va_end(ap);
   return written;
 }
 /*---------------------------------------------------------------------------*/
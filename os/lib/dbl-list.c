@@ -108,6 +108,45 @@ dbl_list_remove(dbl_list_t dll, const void *element)
 }
 /*---------------------------------------------------------------------------*/
 void
+dbl_list_unlink(dbl_list_t dll, void *element)
+{
+  struct dll *this = element;
+
+  if(this->previous) {
+    this->previous->next = this->next;
+  } else {
+    *dll = this->next;
+  }
+
+  if(this->next) {
+    this->next->previous = this->previous;
+  }
+
+  this->next = NULL;
+  this->previous = NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+dbl_list_link_after(dbl_list_t dll, void *existing, void *element)
+{
+  struct dll *this = element;
+  struct dll *previous = existing;
+
+  this->previous = previous;
+  if(previous) {
+    this->next = previous->next;
+    previous->next = this;
+  } else {
+    this->next = *dll;
+    *dll = this;
+  }
+
+  if(this->next) {
+    this->next->previous = this;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
 dbl_list_add_head(dbl_list_t dll, void *element)
 {
   struct dll *head;
@@ -176,6 +176,37 @@ void dbl_list_add_before(dbl_list_t dll, void *existing, void *element);
  */
 void dbl_list_remove(dbl_list_t dll, const void *element);
 
+/**
+ * \brief Remove an element that is known to be on a doubly-linked list.
+ * \param dll The doubly-linked list.
+ * \param element A pointer to the element to be removed.
+ *
+ * Unlike dbl_list_remove(), this function does not search the list to
+ * verify that \e element is on it, so it runs in constant time. Calling
+ * it for an element that is not on \e dll corrupts the list.
+ *
+ * Calling this function will update the list's head and item order. If you
+ * call this function as part of a list traversal, it is advised to stop
+ * traversing after this function returns.
+ */
+void dbl_list_unlink(dbl_list_t dll, void *element);
+
+/**
+ * \brief Add an element that is not on a doubly-linked list after another.
+ * \param dll The doubly-linked list.
+ * \param existing The element after which \e element is added, or NULL to
+ *        add it at the start of the list.
+ * \param element A pointer to the element to be added.
+ *
+ * Unlike dbl_list_add_after(), this function does not search the list to
+ * remove \e element first, so it runs in constant time. Calling it for an
+ * element that is already on \e dll corrupts the list.
+ *
+ * A caller that keeps track of the list's tail can use this function to
+ * append in constant time.
+ */
+void dbl_list_link_after(dbl_list_t dll, void *existing, void *element);
+
 /**
  * \brief Get the length of a doubly-linked list.
  * \param dll The doubly-linked list.
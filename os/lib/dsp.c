@@ -0,0 +1,672 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \addtogroup dsp
+ * @{
+ *
+ * \file
+ *   Fixed-point FFT, windowing and spectrum estimation
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/dsp.h"
+
+#include <string.h>
+
+#if DSP_WITH_SIMD
+#include <arm_acle.h>
+#endif
+/*---------------------------------------------------------------------------*/
+/* sin(2 * pi * i / DSP_FFT_MAX_SIZE) in Q15, for the first quarter wave */
+#if DSP_FFT_MAX_SIZE == 64
+static const int16_t sin_tab[DSP_FFT_MAX_SIZE / 4 + 1] = {
+  0, 3212, 6393, 9512, 12539, 15446, 18204, 20787, 23170, 25329, 27245,
+  28898, 30273, 31356, 32137, 32609, 32767
+};
+#elif DSP_FFT_MAX_SIZE == 128
+static const int16_t sin_tab[DSP_FFT_MAX_SIZE / 4 + 1] = {
+  0, 1608, 3212, 4808, 6393, 7962, 9512, 11039, 12539, 14010, 15446, 16846,
+  18204, 19519, 20787, 22005, 23170, 24279, 25329, 26319, 27245, 28105,
+  28898, 29621, 30273, 30852, 31356, 31785, 32137, 32412, 32609, 32728,
+  32767
+};
+#elif DSP_FFT_MAX_SIZE == 256
+static const int16_t sin_tab[DSP_FFT_MAX_SIZE / 4 + 1] = {
+  0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512,
+  10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846,
+  17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594, 23170,
+  23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105,
+  28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113, 31356,
+  31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728,
+  32757, 32767
+};
+#elif DSP_FFT_MAX_SIZE == 512
+static const int16_t sin_tab[DSP_FFT_MAX_SIZE / 4 + 1] = {
+  0, 402, 804, 1206, 1608, 2009, 2410, 2811, 3212, 3612, 4011, 4410, 4808,
+  5205, 5602, 5998, 6393, 6786, 7179, 7571, 7962, 8351, 8739, 9126, 9512,
+  9896, 10278, 10659, 11039, 11417, 11793, 12167, 12539, 12910, 13279, 13645,
+  14010, 14372, 14732, 15090, 15446, 15800, 16151, 16499, 16846, 17189,
+  17530, 17869, 18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475,
+  20787, 21096, 21403, 21705, 22005, 22301, 22594, 22884, 23170, 23452,
+  23731, 24007, 24279, 24547, 24811, 25072, 25329, 25582, 25832, 26077,
+  26319, 26556, 26790, 27019, 27245, 27466, 27683, 27896, 28105, 28310,
+  28510, 28706, 28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,
+  30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237, 31356, 31470,
+  31580, 31685, 31785, 31880, 31971, 32057, 32137, 32213, 32285, 32351,
+  32412, 32469, 32521, 32567, 32609, 32646, 32678, 32705, 32728, 32745,
+  32757, 32765, 32767
+};
+#elif DSP_FFT_MAX_SIZE == 1024
+static const int16_t sin_tab[DSP_FFT_MAX_SIZE / 4 + 1] = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2410,
+  2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609, 4808,
+  5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983, 7179,
+  7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319, 9512,
+  9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462,
+  13645, 13828, 14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+  15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018,
+  17189, 17360, 17530, 17700, 17869, 18037, 18204, 18371, 18537, 18703,
+  18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317,
+  20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311,
+  23452, 23592, 23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680,
+  24811, 24942, 25072, 25201, 25329, 25456, 25582, 25708, 25832, 25955,
+  26077, 26198, 26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+  27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001, 28105, 28208,
+  28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+  29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037,
+  30117, 30195, 30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+  30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297, 31356, 31414,
+  31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926,
+  31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250, 32285, 32318,
+  32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737,
+  32745, 32752, 32757, 32761, 32765, 32766, 32767
+};
+#else
+#error "DSP_FFT_MAX_SIZE must be 64, 128, 256, 512 or 1024"
+#endif
+/*---------------------------------------------------------------------------*/
+/* cos and sin of 2 * pi * i / DSP_FFT_MAX_SIZE, for 0 <= i < DSP_FFT_MAX_SIZE */
+static void
+twiddle(uint16_t i, int16_t *c, int16_t *s)
+{
+  const uint16_t q = DSP_FFT_MAX_SIZE / 4;
+
+  if(i <= q) {
+    *s = sin_tab[i];
+    *c = sin_tab[q - i];
+  } else if(i <= 2 * q) {
+    *s = sin_tab[2 * q - i];
+    *c = -sin_tab[i - q];
+  } else if(i <= 3 * q) {
+    *s = -sin_tab[i - 2 * q];
+    *c = -sin_tab[3 * q - i];
+  } else {
+    *s = -sin_tab[4 * q - i];
+    *c = sin_tab[i - 3 * q];
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_valid_size(uint16_t n, uint16_t min)
+{
+  return n >= min && n <= DSP_FFT_MAX_SIZE && (n & (n - 1)) == 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+dsp_window_hann(int16_t *x, uint16_t n)
+{
+  uint16_t step;
+  uint16_t i;
+  int16_t c;
+  int16_t s;
+  int16_t w;
+
+  if(!is_valid_size(n, 2)) {
+    return;
+  }
+  step = DSP_FFT_MAX_SIZE / n;
+
+  /* w[i] = (1 - cos(2 * pi * i / n)) / 2, which is symmetric around n / 2 */
+  x[0] = 0;
+  for(i = 1; i <= n / 2; i++) {
+    twiddle(i * step, &c, &s);
+    w = (int16_t)((32768 - (int32_t)c) >> 1);
+    x[i] = dsp_q15_mul(x[i], w);
+    if(i != n - i) {
+      x[n - i] = dsp_q15_mul(x[n - i], w);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+bit_reverse(int16_t *x, uint16_t n)
+{
+  uint16_t i;
+  uint16_t j;
+  uint16_t bit;
+  int16_t tmp;
+
+  for(i = 1, j = 0; i < n; i++) {
+    for(bit = n >> 1; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j |= bit;
+    if(i < j) {
+      tmp = x[2 * i];
+      x[2 * i] = x[2 * j];
+      x[2 * j] = tmp;
+      tmp = x[2 * i + 1];
+      x[2 * i + 1] = x[2 * j + 1];
+      x[2 * j + 1] = tmp;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The butterflies come in three scalings. The first stage quarters its
+   output, so that every later value stays within half of full scale in
+   magnitude, whatever the phase of the input. The inner stages halve
+   their output, rounding to nearest. The last stage of dsp_cfft()
+   saturates its output instead of halving it, which only clips
+   transforms that do not fit. */
+static inline int16_t
+sat16(int32_t v)
+{
+  return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v);
+}
+/*---------------------------------------------------------------------------*/
+#if DSP_WITH_SIMD
+/* 1 in both halves of a packed pair */
+#define PAIR_ONE 0x00010001
+
+static inline int32_t
+load_pair(const int16_t *p)
+{
+  int32_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+/*---------------------------------------------------------------------------*/
+static inline void
+store_pair(int16_t *p, int32_t v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+/*---------------------------------------------------------------------------*/
+/* b w, with w = (cos, sin) standing for cos - j sin. Both parts fit in
+   16 bits, as |b| is at most half of full scale. */
+static inline int32_t
+rotate(int32_t pb, int32_t w)
+{
+  int32_t re = __smlad(pb, w, 1 << 14) >> 15;
+  int32_t im = __smlsdx(w, pb, 1 << 14) >> 15;
+
+  return (int32_t)(((uint32_t)re & 0xffff) | ((uint32_t)im << 16));
+}
+/*---------------------------------------------------------------------------*/
+/* (a + t) / 2 and (a - t) / 2, rounded. a + 1 cannot saturate, as a is
+   at most half of full scale. */
+static inline void
+halve_pair(int16_t *a, int16_t *b, int32_t pa, int32_t t)
+{
+  pa = __sadd16(pa, PAIR_ONE);
+  store_pair(a, __shadd16(pa, t));
+  store_pair(b, __shsub16(pa, t));
+}
+/*---------------------------------------------------------------------------*/
+/* A scaled radix-2 butterfly on packed (re, im) pairs: (a + b w) / 2 and
+   (a - b w) / 2 */
+static inline void
+butterfly(int16_t *a, int16_t *b, int32_t w)
+{
+  halve_pair(a, b, load_pair(a), rotate(load_pair(b), w));
+}
+/*---------------------------------------------------------------------------*/
+/* The same butterfly, saturated instead of halved */
+static inline void
+butterfly_sat(int16_t *a, int16_t *b, int32_t w)
+{
+  int32_t pa = load_pair(a);
+  int32_t t = rotate(load_pair(b), w);
+
+  store_pair(a, __qadd16(pa, t));
+  store_pair(b, __qsub16(pa, t));
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1 */
+static inline void
+butterfly_1(int16_t *a, int16_t *b)
+{
+  halve_pair(a, b, load_pair(a), load_pair(b));
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1, quartered. Halving the halved value plus one
+   rounds (a + b) / 4 to nearest. */
+static inline void
+butterfly_1_quarter(int16_t *a, int16_t *b)
+{
+  int32_t pa = load_pair(a);
+  int32_t pb = load_pair(b);
+
+  store_pair(a, __shadd16(__shadd16(pa, pb), PAIR_ONE));
+  store_pair(b, __shadd16(__shsub16(pa, pb), PAIR_ONE));
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1, saturated */
+static inline void
+butterfly_1_sat(int16_t *a, int16_t *b)
+{
+  int32_t pa = load_pair(a);
+  int32_t pb = load_pair(b);
+
+  store_pair(a, __qadd16(pa, pb));
+  store_pair(b, __qsub16(pa, pb));
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1, halved and rounded down, for a two-point
+   transform of full-scale values */
+static inline void
+butterfly_1_floor(int16_t *a, int16_t *b)
+{
+  int32_t pa = load_pair(a);
+  int32_t pb = load_pair(b);
+
+  store_pair(a, __shadd16(pa, pb));
+  store_pair(b, __shsub16(pa, pb));
+}
+/*---------------------------------------------------------------------------*/
+static inline int32_t
+pack_twiddle(int16_t c, int16_t s)
+{
+  return (int32_t)(((uint32_t)c & 0xffff) | ((uint32_t)(uint16_t)s << 16));
+}
+#else /* DSP_WITH_SIMD */
+/*---------------------------------------------------------------------------*/
+/* b w, with w = (cos, sin) standing for cos - j sin */
+static inline void
+rotate(const int16_t *b, int32_t w, int32_t *re, int32_t *im)
+{
+  int32_t c = (int16_t)w;
+  int32_t s = w >> 16;
+
+  *re = (b[0] * c + b[1] * s + (1 << 14)) >> 15;
+  *im = (b[1] * c - b[0] * s + (1 << 14)) >> 15;
+}
+/*---------------------------------------------------------------------------*/
+/* (a + t) / 2 and (a - t) / 2, rounded */
+static inline void
+halve_pair(int16_t *a, int16_t *b, int32_t re, int32_t im)
+{
+  b[0] = (a[0] + 1 - re) >> 1;
+  b[1] = (a[1] + 1 - im) >> 1;
+  a[0] = (a[0] + 1 + re) >> 1;
+  a[1] = (a[1] + 1 + im) >> 1;
+}
+/*---------------------------------------------------------------------------*/
+/* A scaled radix-2 butterfly: (a + b w) / 2 and (a - b w) / 2 */
+static inline void
+butterfly(int16_t *a, int16_t *b, int32_t w)
+{
+  int32_t re;
+  int32_t im;
+
+  rotate(b, w, &re, &im);
+  halve_pair(a, b, re, im);
+}
+/*---------------------------------------------------------------------------*/
+/* The same butterfly, saturated instead of halved */
+static inline void
+butterfly_sat(int16_t *a, int16_t *b, int32_t w)
+{
+  int32_t re;
+  int32_t im;
+
+  rotate(b, w, &re, &im);
+  b[0] = sat16(a[0] - re);
+  b[1] = sat16(a[1] - im);
+  a[0] = sat16(a[0] + re);
+  a[1] = sat16(a[1] + im);
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1 */
+static inline void
+butterfly_1(int16_t *a, int16_t *b)
+{
+  halve_pair(a, b, b[0], b[1]);
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1, quartered and rounded */
+static inline void
+butterfly_1_quarter(int16_t *a, int16_t *b)
+{
+  int16_t re = b[0];
+  int16_t im = b[1];
+
+  b[0] = (a[0] - re + 2) >> 2;
+  b[1] = (a[1] - im + 2) >> 2;
+  a[0] = (a[0] + re + 2) >> 2;
+  a[1] = (a[1] + im + 2) >> 2;
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1, saturated */
+static inline void
+butterfly_1_sat(int16_t *a, int16_t *b)
+{
+  int16_t re = b[0];
+  int16_t im = b[1];
+
+  b[0] = sat16(a[0] - re);
+  b[1] = sat16(a[1] - im);
+  a[0] = sat16(a[0] + re);
+  a[1] = sat16(a[1] + im);
+}
+/*---------------------------------------------------------------------------*/
+/* The butterfly with w = 1, halved and rounded down, for a two-point
+   transform of full-scale values */
+static inline void
+butterfly_1_floor(int16_t *a, int16_t *b)
+{
+  int16_t re = b[0];
+  int16_t im = b[1];
+
+  b[0] = (a[0] - re) >> 1;
+  b[1] = (a[1] - im) >> 1;
+  a[0] = (a[0] + re) >> 1;
+  a[1] = (a[1] + im) >> 1;
+}
+/*---------------------------------------------------------------------------*/
+static inline int32_t
+pack_twiddle(int16_t c, int16_t s)
+{
+  return (int32_t)((uint16_t)c | ((uint32_t)(uint16_t)s << 16));
+}
+#endif /* DSP_WITH_SIMD */
+/*---------------------------------------------------------------------------*/
+/* The FFT of n complex samples, scaled by 1 / n, or by 1 / (2 n) when
+   halve_last is set. In the latter case, no stage saturates. */
+static void
+fft(int16_t *x, uint16_t n, int halve_last)
+{
+  uint16_t len;
+  uint16_t half;
+  uint16_t step;
+  uint16_t i;
+  uint16_t j;
+  int16_t c;
+  int16_t s;
+  int32_t w;
+
+  bit_reverse(x, n);
+
+  if(n == 2 && !halve_last) {
+    butterfly_1_floor(&x[0], &x[2]);
+    return;
+  }
+
+  for(i = 0; i < n; i += 2) {
+    butterfly_1_quarter(&x[2 * i], &x[2 * i + 2]);
+  }
+
+  for(len = 4; len <= n; len <<= 1) {
+    half = len >> 1;
+    step = DSP_FFT_MAX_SIZE / len;
+
+    if(len == n && !halve_last) {
+      for(i = 0; i < n; i += len) {
+        butterfly_1_sat(&x[2 * i], &x[2 * (i + half)]);
+      }
+      for(j = 1; j < half; j++) {
+        twiddle(j * step, &c, &s);
+        w = pack_twiddle(c, s);
+        for(i = j; i < n; i += len) {
+          butterfly_sat(&x[2 * i], &x[2 * (i + half)], w);
+        }
+      }
+      return;
+    }
+
+    for(i = 0; i < n; i += len) {
+      butterfly_1(&x[2 * i], &x[2 * (i + half)]);
+    }
+
+    /* The outer loop runs over the twiddles so that each is looked up
+       once per stage */
+    for(j = 1; j < half; j++) {
+      twiddle(j * step, &c, &s);
+      w = pack_twiddle(c, s);
+      for(i = j; i < n; i += len) {
+        butterfly(&x[2 * i], &x[2 * (i + half)], w);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+dsp_cfft(int16_t *x, uint16_t n)
+{
+  if(!is_valid_size(n, 2)) {
+    return -1;
+  }
+
+  fft(x, n, 0);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+dsp_rfft(int16_t *x, uint16_t n)
+{
+  uint16_t half;
+  uint16_t step;
+  uint16_t k;
+  int16_t *a;
+  int16_t *b;
+  int32_t e_re, e_im, o_re, o_im, t_re, t_im;
+  int16_t c;
+  int16_t s;
+
+  if(!is_valid_size(n, 4)) {
+    return -1;
+  }
+
+  /* The even and odd samples form the real and imaginary parts of a
+     complex sequence of half the length. Its transform Z is scaled by
+     1 / n, so that it stays within half of full scale. */
+  half = n / 2;
+  fft(x, half, 1);
+
+  /* Split Z into the transforms E and O of the even and odd samples, and
+     combine them into X[k] = E[k] + W^k O[k]. Bins k and half - k are
+     built from the same pair of inputs. */
+  step = DSP_FFT_MAX_SIZE / n;
+  for(k = 1; k < half / 2; k++) {
+    a = &x[2 * k];
+    b = &x[2 * (half - k)];
+
+    e_re = (a[0] + b[0]) >> 1;
+    e_im = (a[1] - b[1]) >> 1;
+    o_re = (a[1] + b[1]) >> 1;
+    o_im = (b[0] - a[0]) >> 1;
+
+    twiddle(k * step, &c, &s);
+    t_re = (o_re * c + o_im * s + (1 << 14)) >> 15;
+    t_im = (o_im * c - o_re * s + (1 << 14)) >> 15;
+
+    a[0] = sat16(e_re + t_re);
+    a[1] = sat16(e_im + t_im);
+    b[0] = sat16(e_re - t_re);
+    b[1] = sat16(t_im - e_im);
+  }
+
+  /* X[half / 2] is the conjugate of Z[half / 2] */
+  a = &x[2 * (half / 2)];
+  a[1] = -a[1];
+
+  /* The real bins at 0 and n / 2 share the first pair */
+  e_re = x[0];
+  o_re = x[1];
+  x[0] = sat16(e_re + o_re);
+  x[1] = sat16(e_re - o_re);
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+dsp_sqrt(uint32_t v)
+{
+  uint32_t res = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > v) {
+    bit >>= 2;
+  }
+  while(bit != 0) {
+    if(v >= res + bit) {
+      v -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)res;
+}
+/*---------------------------------------------------------------------------*/
+static inline uint32_t
+bin_power(int32_t re, int32_t im)
+{
+  return (uint32_t)(re * re) + (uint32_t)(im * im);
+}
+/*---------------------------------------------------------------------------*/
+void
+dsp_magnitude(const int16_t *x, uint16_t *mag, uint16_t n)
+{
+  uint16_t k;
+
+  mag[0] = x[0] < 0 ? -x[0] : x[0];
+  mag[n / 2] = x[1] < 0 ? -x[1] : x[1];
+  for(k = 1; k < n / 2; k++) {
+    mag[k] = dsp_sqrt(bin_power(x[2 * k], x[2 * k + 1]));
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+dsp_power(const int16_t *x, uint32_t *power, uint16_t n)
+{
+  uint16_t k;
+
+  power[0] = bin_power(x[0], 0);
+  power[n / 2] = bin_power(x[1], 0);
+  for(k = 1; k < n / 2; k++) {
+    power[k] = bin_power(x[2 * k], x[2 * k + 1]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+dsp_psd_init(struct dsp_psd *psd, int16_t *block, uint32_t *power,
+             uint16_t n, uint8_t shift)
+{
+  psd->block = block;
+  psd->power = power;
+  psd->n = n;
+  psd->fill = 0;
+  psd->blocks = 0;
+  psd->shift = shift;
+  memset(power, 0, (n / 2 + 1) * sizeof(uint32_t));
+}
+/*---------------------------------------------------------------------------*/
+static void
+psd_average(struct dsp_psd *psd, uint16_t k, uint32_t p)
+{
+  uint32_t *avg = &psd->power[k];
+
+  if(psd->blocks == 0) {
+    *avg = p;
+  } else if(p > *avg) {
+    *avg += (p - *avg) >> psd->shift;
+  } else {
+    *avg -= (*avg - p) >> psd->shift;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+psd_process_block(struct dsp_psd *psd)
+{
+  const int16_t *x = psd->block;
+  uint16_t n = psd->n;
+  uint16_t k;
+
+  dsp_window_hann(psd->block, n);
+  dsp_rfft(psd->block, n);
+
+  /* Average straight from the packed spectrum */
+  psd_average(psd, 0, bin_power(x[0], 0));
+  psd_average(psd, n / 2, bin_power(x[1], 0));
+  for(k = 1; k < n / 2; k++) {
+    psd_average(psd, k, bin_power(x[2 * k], x[2 * k + 1]));
+  }
+
+  if(psd->blocks < UINT16_MAX) {
+    psd->blocks++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+dsp_psd_add(struct dsp_psd *psd, const int16_t *samples, uint16_t count)
+{
+  uint16_t completed = 0;
+  uint16_t len;
+
+  if(!is_valid_size(psd->n, 4)) {
+    return 0;
+  }
+
+  while(count > 0) {
+    len = psd->n - psd->fill;
+    if(len > count) {
+      len = count;
+    }
+    memcpy(&psd->block[psd->fill], samples, len * sizeof(int16_t));
+    psd->fill += len;
+    samples += len;
+    count -= len;
+
+    if(psd->fill == psd->n) {
+      psd_process_block(psd);
+      psd->fill = 0;
+      completed++;
+    }
+  }
+  return completed;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/** \addtogroup lib
+ * @{
+ *
+ * \defgroup dsp Fixed-point DSP kernels
+ *
+ * Spectral analysis of sensor samples in Q15 fixed point: an in-place
+ * real FFT, a Hann window, the magnitude spectrum, and a power spectral
+ * density (PSD) that is averaged over a stream of samples. It sits next
+ * to \ref ifft.h "ifft()", which handles 8-bit samples only and returns
+ * an approximate magnitude.
+ *
+ * The twiddle factors are a quarter-wave sine table chosen at compile
+ * time for DSP_FFT_MAX_SIZE. Any power-of-two size from 4 up to that
+ * size can be used at runtime; smaller sizes step through the same table.
+ *
+ * The transform of \e n samples is scaled by 1/n. The first FFT stage
+ * quarters its output and the last one does not halve it, so that the
+ * values in between stay within half of full scale whatever the phase of
+ * the input. Bins that do not fit in 16 bits saturate, which only
+ * happens with full-scale complex samples whose real and imaginary parts
+ * line up. A full-scale sine wave of amplitude A shows up as two bins of
+ * A/2, or as a single bin of A/2 in the output of dsp_rfft().
+ *
+ * On cores with the ARMv7E-M DSP extension, such as the Cortex-M4, the
+ * butterflies work on packed (re, im) pairs with the dual 16-bit
+ * multiply and halving add instructions. Other cores use portable C that
+ * gives bit-identical results. The SIMD path loads pairs as 32-bit words,
+ * so buffers should be 32-bit aligned.
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef DSP_H_
+#define DSP_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+/*---------------------------------------------------------------------------*/
+/**
+ * The largest FFT size, which selects the twiddle table. One of 64, 128,
+ * 256, 512 or 1024. The table takes DSP_FFT_MAX_SIZE / 2 + 2 bytes.
+ */
+#ifdef DSP_CONF_FFT_MAX_SIZE
+#define DSP_FFT_MAX_SIZE DSP_CONF_FFT_MAX_SIZE
+#else
+#define DSP_FFT_MAX_SIZE 256
+#endif
+
+/** Use the ARMv7E-M SIMD instructions when the compiler targets them */
+#ifdef DSP_CONF_WITH_SIMD
+#define DSP_WITH_SIMD DSP_CONF_WITH_SIMD
+#elif defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#define DSP_WITH_SIMD 1
+#else
+#define DSP_WITH_SIMD 0
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Multiply two Q15 values.
+ * \param a The first value.
+ * \param b The second value.
+ * \return a * b in Q15, rounded towards minus infinity
+ */
+static inline int16_t
+dsp_q15_mul(int16_t a, int16_t b)
+{
+  return (int16_t)(((int32_t)a * b) >> 15);
+}
+
+/**
+ * \brief Apply a Hann window to a block of samples, in place.
+ * \param x The samples.
+ * \param n The number of samples, a power of two up to DSP_FFT_MAX_SIZE.
+ */
+void dsp_window_hann(int16_t *x, uint16_t n);
+
+/**
+ * \brief Compute the FFT of complex samples, in place.
+ * \param x The samples as interleaved (re, im) pairs, 2 * n values.
+ * \param n The number of complex samples, a power of two from 2 up to
+ *          DSP_FFT_MAX_SIZE.
+ * \retval 0 The transform was computed
+ * \retval -1 n is not a supported size
+ *
+ * On return, x holds X[k] / n for k = 0 .. n - 1 as (re, im) pairs,
+ * saturated to the range of int16_t.
+ */
+int dsp_cfft(int16_t *x, uint16_t n);
+
+/**
+ * \brief Compute the FFT of real samples, in place.
+ * \param x The samples, n values.
+ * \param n The number of samples, a power of two from 4 up to
+ *          DSP_FFT_MAX_SIZE.
+ * \retval 0 The transform was computed
+ * \retval -1 n is not a supported size
+ *
+ * The spectrum of real samples is symmetric, so only the bins from 0 to
+ * n / 2 are returned, scaled by 1 / n and packed into the n values of the
+ * input: x[0] is the real DC bin, x[1] the real bin at n / 2 (the Nyquist
+ * frequency), and x[2k], x[2k + 1] hold bin k for k = 1 .. n / 2 - 1.
+ * This is the layout of the CMSIS-DSP real FFT.
+ */
+int dsp_rfft(int16_t *x, uint16_t n);
+
+/**
+ * \brief Compute the magnitude spectrum from the output of dsp_rfft().
+ * \param x The packed spectrum, n values.
+ * \param mag The magnitudes of bins 0 .. n / 2, n / 2 + 1 values.
+ * \param n The FFT size.
+ *
+ * mag may not overlap x.
+ */
+void dsp_magnitude(const int16_t *x, uint16_t *mag, uint16_t n);
+
+/**
+ * \brief Compute the power spectrum from the output of dsp_rfft().
+ * \param x The packed spectrum, n values.
+ * \param power re * re + im * im for bins 0 .. n / 2, n / 2 + 1 values.
+ * \param n The FFT size.
+ */
+void dsp_power(const int16_t *x, uint32_t *power, uint16_t n);
+
+/**
+ * \brief Compute the integer square root.
+ * \param v The value.
+ * \return The square root of v, rounded down
+ */
+uint16_t dsp_sqrt(uint32_t v);
+/*---------------------------------------------------------------------------*/
+/**
+ * A power spectral density estimate, averaged over blocks of a sample
+ * stream. Each block is windowed and transformed, and its power spectrum
+ * is folded into an exponential moving average.
+ */
+struct dsp_psd {
+  /** The block being filled, n samples */
+  int16_t *block;
+  /** The averaged power of bins 0 .. n / 2, n / 2 + 1 values */
+  uint32_t *power;
+  /** The FFT size */
+  uint16_t n;
+  /** The number of samples in the current block */
+  uint16_t fill;
+  /** The number of blocks averaged so far */
+  uint16_t blocks;
+  /** The weight of a new block is 1 / 2^shift */
+  uint8_t shift;
+};
+
+/**
+ * \brief Initialise a PSD estimate.
+ * \param psd The estimate.
+ * \param block Storage for a block of n samples.
+ * \param power Storage for n / 2 + 1 power values.
+ * \param n The FFT size, a power of two from 4 up to DSP_FFT_MAX_SIZE.
+ * \param shift The averaging weight: each new block contributes
+ *              1 / 2^shift. 0 keeps only the latest block.
+ */
+void dsp_psd_init(struct dsp_psd *psd, int16_t *block, uint32_t *power,
+                  uint16_t n, uint8_t shift);
+
+/**
+ * \brief Feed samples to a PSD estimate.
+ * \param psd The estimate.
+ * \param samples The samples.
+ * \param count The number of samples.
+ * \return The number of blocks completed by these samples
+ *
+ * Samples are copied into the block until it is full, at which point it
+ * is windowed, transformed and averaged into psd->power.
+ */
+uint16_t dsp_psd_add(struct dsp_psd *psd, const int16_t *samples,
+                     uint16_t count);
+/*---------------------------------------------------------------------------*/
+#endif /* DSP_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ * @}
+ */
@@ -151,6 +151,10 @@ static struct heapmem_zone zones[HEAPMEM_MAX_ZONES] = {
   {.name = "GENERAL", .zone_size = HEAPMEM_ARENA_SIZE}
 };
 
+/* The peak usage of the heap and of the scratch arenas. */
+static size_t peak_allocated;
+static size_t peak_scratch;
+
 /*
  * We use a double-linked list of chunks, with a slight space overhead
  * compared to a single-linked list, but with the advantage of having
@@ -174,8 +178,25 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
+
+#if HEAPMEM_SIZE_CLASSES
+/*
+ * Free chunks with a size in the range [2^n, 2^(n+1)) are kept in
+ * free_lists[n]. Bit n in free_classes is set if and only if that
+ * list is non-empty, so that the smallest non-empty class that can
+ * satisfy a request can be found without walking any list.
+ */
+#define NUM_SIZE_CLASSES 32
+static chunk_t *free_lists[NUM_SIZE_CLASSES];
+static uint32_t free_classes;
+
+#define FREE_LIST(chunk) free_lists[size_class((chunk)->size)]
+#else
 static chunk_t *free_list;
 
+#define FREE_LIST(chunk) free_list
+#endif /* HEAPMEM_SIZE_CLASSES */
+
 #define IN_HEAP(ptr) ((char *)(ptr) >= (char *)heap_base) && \
                      ((char *)(ptr) < (char *)heap_base + heap_usage)
 
@@ -194,24 +215,61 @@ extend_space(size_t size)
   return old_usage;
 }
 
-/* free_chunk: Mark a chunk as being free, and put it on the free list. */
-static void
-free_chunk(chunk_t * const chunk)
+#if HEAPMEM_SIZE_CLASSES
+/* size_class: Get the index of the free list for chunks of a size. */
+static unsigned
+size_class(size_t size)
 {
-  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+#ifdef __GNUC__
+  unsigned class;
 
-  if(IS_LAST_CHUNK(chunk)) {
-    /* Release the chunk back into the wilderness. */
-    heap_usage -= sizeof(chunk_t) + chunk->size;
-  } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
-    }
-    free_list = chunk;
+  if(size < 2) {
+    return 0;
+  }
+  class = sizeof(unsigned long) * 8 - 1 - __builtin_clzl(size);
+  return class < NUM_SIZE_CLASSES ? class : NUM_SIZE_CLASSES - 1;
+#else /* __GNUC__ */
+  unsigned class = 0;
+
+  while(size > 1 && class < NUM_SIZE_CLASSES - 1) {
+    size >>= 1;
+    class++;
+  }
+  return class;
+#endif /* __GNUC__ */
+}
+
+/* first_class: Get the smallest non-empty size class in a set. */
+static unsigned
+first_class(uint32_t classes)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(classes);
+#else /* __GNUC__ */
+  unsigned class = 0;
+
+  while((classes & 1) == 0) {
+    classes >>= 1;
+    class++;
   }
+  return class;
+#endif /* __GNUC__ */
+}
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+/* insert_chunk_in_free_list: Put a chunk first on its free list. */
+static void
+insert_chunk_in_free_list(chunk_t * const chunk)
+{
+  chunk->prev = NULL;
+  chunk->next = FREE_LIST(chunk);
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk;
+  }
+  FREE_LIST(chunk) = chunk;
+#if HEAPMEM_SIZE_CLASSES
+  free_classes |= (uint32_t)1 << size_class(chunk->size);
+#endif /* HEAPMEM_SIZE_CLASSES */
 }
 
 /* remove_chunk_from_free_list: Mark a chunk as being allocated, and
@@ -219,11 +277,16 @@ free_chunk(chunk_t * const chunk)
 static void
 remove_chunk_from_free_list(chunk_t * const chunk)
 {
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
+  if(chunk == FREE_LIST(chunk)) {
+    FREE_LIST(chunk) = chunk->next;
+    if(chunk->next != NULL) {
+      chunk->next->prev = NULL;
+    }
+#if HEAPMEM_SIZE_CLASSES
+    else {
+      free_classes &= ~((uint32_t)1 << size_class(chunk->size));
     }
+#endif /* HEAPMEM_SIZE_CLASSES */
   } else {
     chunk->prev->next = chunk->next;
   }
@@ -233,6 +296,29 @@ remove_chunk_from_free_list(chunk_t * const chunk)
   }
 }
 
+static void coalesce_chunks(chunk_t *chunk);
+
+/* free_chunk: Mark a chunk as being free, and put it on the free list. */
+static void
+free_chunk(chunk_t * const chunk)
+{
+#if HEAPMEM_SIZE_CLASSES
+  /* Merge the chunk with the free chunks that follow it while it is
+     still marked as allocated, and thus not on any free list. */
+  coalesce_chunks(chunk);
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+  } else {
+    /* Put the chunk on the free list. */
+    insert_chunk_in_free_list(chunk);
+  }
+}
+
 /*
  * split_chunk: When allocating a chunk, we may have found one that is
  * larger than needed, so this function is called to keep the rest of
@@ -246,7 +332,8 @@ split_chunk(chunk_t * const chunk, size_t offset)
   if(offset + sizeof(chunk_t) < chunk->size) {
     chunk_t *new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
     new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
-    new_chunk->flags = 0;
+    /* The new chunk is released in the same way as an allocated one. */
+    new_chunk->flags = CHUNK_FLAG_ALLOCATED;
     free_chunk(new_chunk);
 
     chunk->size = offset;
@@ -259,15 +346,83 @@ split_chunk(chunk_t * const chunk, size_t offset)
 static void
 coalesce_chunks(chunk_t *chunk)
 {
+#if HEAPMEM_SIZE_CLASSES
+  /* A free chunk may change size class, so it is taken off its list
+     while it grows. */
+  bool listed = CHUNK_FREE(chunk) &&
+    (char *)NEXT_CHUNK(chunk) < &heap_base[heap_usage] &&
+    CHUNK_FREE(NEXT_CHUNK(chunk));
+  if(listed) {
+    remove_chunk_from_free_list(chunk);
+  }
+#endif /* HEAPMEM_SIZE_CLASSES */
+
   for(chunk_t *next = NEXT_CHUNK(chunk);
       (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
       next = NEXT_CHUNK(next)) {
+    remove_chunk_from_free_list(next);
     chunk->size += sizeof(chunk_t) + next->size;
     LOG_DBG("Coalesce chunk of %zu bytes\n", next->size);
-    remove_chunk_from_free_list(next);
   }
+
+#if HEAPMEM_SIZE_CLASSES
+  if(listed) {
+    insert_chunk_in_free_list(chunk);
+  }
+#endif /* HEAPMEM_SIZE_CLASSES */
 }
 
+#if HEAPMEM_SIZE_CLASSES
+/* defrag_chunks: Scan the free lists, from the smallest size class,
+   for chunks that can be coalesced, and stop within a bounded time. */
+static void
+defrag_chunks(void)
+{
+  /* Limit the time we spend on searching the free lists. */
+  int i = CHUNK_SEARCH_MAX;
+  for(unsigned class = 0; class < NUM_SIZE_CLASSES; class++) {
+    chunk_t *chunk = free_lists[class];
+    while(chunk != NULL) {
+      if(i-- == 0) {
+        return;
+      }
+      /* A coalesced chunk is moved to the head of a free list, so we
+         start over from the head of this one. */
+      size_t size = chunk->size;
+      coalesce_chunks(chunk);
+      chunk = chunk->size == size ? chunk->next : free_lists[class];
+    }
+  }
+}
+
+/* get_free_chunk: Take a chunk that can hold the requested size from
+   the free lists. */
+static chunk_t *
+get_free_chunk(const size_t size)
+{
+  unsigned class = size_class(size);
+
+  /*
+   * Chunks in the class of the requested size may be too small, so we
+   * only look at the first of them. Any chunk in a higher class is
+   * large enough, and we take the first chunk of the smallest one.
+   */
+  chunk_t *chunk = free_lists[class];
+  if(chunk == NULL || chunk->size < size) {
+    uint32_t larger = class < NUM_SIZE_CLASSES - 1 ?
+      free_classes & ~(((uint32_t)2 << class) - 1) : 0;
+    if(larger == 0) {
+      return NULL;
+    }
+    chunk = free_lists[first_class(larger)];
+  }
+
+  remove_chunk_from_free_list(chunk);
+  split_chunk(chunk, size);
+
+  return chunk;
+}
+#else /* HEAPMEM_SIZE_CLASSES */
 /* defrag_chunks: Scan the free list for chunks that can be coalesced,
    and stop within a bounded time. */
 static void
@@ -322,6 +477,22 @@ get_free_chunk(const size_t size)
 
   return best;
 }
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+/* update_peak: Record the total allocated space of all zones if it is
+   the largest so far. */
+static void
+update_peak(void)
+{
+  size_t allocated = 0;
+
+  for(heapmem_zone_t i = 0; i < HEAPMEM_MAX_ZONES; i++) {
+    allocated += zones[i].allocated;
+  }
+  if(allocated > peak_allocated) {
+    peak_allocated = allocated;
+  }
+}
 
 /*
  * heapmem_zone_register: Register a new zone, which is essentially a
@@ -404,10 +575,22 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
   chunk_t *chunk = get_free_chunk(size);
   if(chunk == NULL) {
     chunk = extend_space(sizeof(chunk_t) + size);
-    if(chunk == NULL) {
-      return NULL;
+    if(chunk != NULL) {
+      chunk->size = size;
     }
-    chunk->size = size;
+  }
+
+#if HEAPMEM_SIZE_CLASSES
+  if(chunk == NULL) {
+    /* Free chunks are only coalesced with the chunks that follow them
+       when they are freed, so merge more of them before giving up. */
+    defrag_chunks();
+    chunk = get_free_chunk(size);
+  }
+#endif /* HEAPMEM_SIZE_CLASSES */
+
+  if(chunk == NULL) {
+    return NULL;
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
@@ -421,6 +604,7 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
 
   chunk->zone = zone;
   zones[zone].allocated += sizeof(chunk_t) + size;
+  update_peak();
 
   return GET_PTR(chunk);
 
@@ -549,6 +733,7 @@ heapmem_realloc(void *ptr, size_t size)
     if(extend_space(size_adj) != NULL) {
       chunk->size = size;
       zones[chunk->zone].allocated += size_adj;
+      update_peak();
       return ptr;
     }
   } else {
@@ -563,6 +748,7 @@ heapmem_realloc(void *ptr, size_t size)
 	 its current place. */
       split_chunk(chunk, size);
       zones[chunk->zone].allocated += size_adj;
+      update_peak();
       return ptr;
     }
   }
@@ -585,6 +771,66 @@ heapmem_realloc(void *ptr, size_t size)
 }
 #endif /* HEAPMEM_REALLOC */
 
+/*
+ * heapmem_scratch_init: Reserve a scratch arena as a single chunk in
+ * the given zone. The zone accounting thus covers the whole arena,
+ * regardless of how much of it is in use.
+ */
+bool
+heapmem_scratch_init(heapmem_scratch_t *scratch,
+                     heapmem_zone_t zone, size_t size)
+{
+  scratch->base = heapmem_zone_alloc(zone, size);
+  scratch->size = scratch->base == NULL ? 0 : ALIGN(size);
+  scratch->used = 0;
+  scratch->peak = 0;
+
+  return scratch->base != NULL;
+}
+
+/* heapmem_scratch_deinit: Release the space of a scratch arena. */
+void
+heapmem_scratch_deinit(heapmem_scratch_t *scratch)
+{
+  if(scratch->base != NULL) {
+    heapmem_free(scratch->base);
+  }
+  scratch->base = NULL;
+  scratch->size = 0;
+  scratch->used = 0;
+}
+
+/*
+ * heapmem_scratch_alloc: Allocate an object from a scratch arena by
+ * incrementing its offset. Since the arena starts at an aligned
+ * address, and all sizes are aligned, all objects are aligned.
+ */
+void *
+heapmem_scratch_alloc(heapmem_scratch_t *scratch, size_t size)
+{
+  /* Fail early on too large allocation requests to prevent wrapping values. */
+  if(size > scratch->size - scratch->used) {
+    return NULL;
+  }
+
+  size = ALIGN(size);
+  if(size > scratch->size - scratch->used) {
+    return NULL;
+  }
+
+  void *ptr = scratch->base + scratch->used;
+  scratch->used += size;
+
+  if(scratch->used > scratch->peak) {
+    scratch->peak = scratch->used;
+    if(scratch->peak > peak_scratch) {
+      peak_scratch = scratch->peak;
+    }
+  }
+
+  return ptr;
+}
+
 /* heapmem_stats: Calculate statistics regarding memory usage. */
 void
 heapmem_stats(heapmem_stats_t *stats)
@@ -605,6 +851,8 @@ heapmem_stats(heapmem_stats_t *stats)
   stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
+  stats->peak_allocated = peak_allocated;
+  stats->peak_scratch = peak_scratch;
 }
 
 /* heapmem_alignment: return the minimum alignment of allocated addresses. */
@@ -52,6 +52,12 @@
  * heapmem_realloc(), because the chunk structure immediately precedes
  * the memory of the chunk.
  *
+ * Modules that allocate many short-lived objects while handling a
+ * request can instead use a scratch arena, which is a region of the
+ * heap from which objects are taken by incrementing an offset, and
+ * from which all objects are released at once when the request has
+ * been handled.
+ *
  * \note This module does not contain a corresponding function to the
  *       standard C function calloc().
  *
@@ -82,14 +88,37 @@
 #define HEAPMEM_DEBUG 0
 #endif
 /*****************************************************************************/
+/*
+ * The HEAPMEM_CONF_SIZE_CLASSES parameter determines whether free
+ * chunks are kept in segregated lists, one per power-of-two size
+ * class (non-zero value), or in a single list (zero value). With size
+ * classes, allocation and deallocation take constant time, and freed
+ * chunks are coalesced with the free chunks that follow them right
+ * away instead of during allocation.
+ */
+#ifdef HEAPMEM_CONF_SIZE_CLASSES
+#define HEAPMEM_SIZE_CLASSES HEAPMEM_CONF_SIZE_CLASSES
+#else
+#define HEAPMEM_SIZE_CLASSES 0
+#endif /* HEAPMEM_CONF_SIZE_CLASSES */
+/*****************************************************************************/
 typedef struct heapmem_stats {
   size_t allocated;
   size_t overhead;
   size_t available;
   size_t footprint;
   size_t chunks;
+  size_t peak_allocated;
+  size_t peak_scratch;
 } heapmem_stats_t;
 /*****************************************************************************/
+typedef struct heapmem_scratch {
+  char *base;
+  size_t size;
+  size_t used;
+  size_t peak;
+} heapmem_scratch_t;
+/*****************************************************************************/
 typedef uint8_t heapmem_zone_t;
 
 #define HEAPMEM_ZONE_INVALID (heapmem_zone_t)-1
@@ -183,6 +212,53 @@ bool heapmem_free(void *ptr);
 
 #endif /* HEAPMEM_DEBUG */
 
+/**
+ * \brief         Reserve a scratch arena in a zone of the heap.
+ * \param scratch A pointer to the scratch arena to initialize.
+ * \param zone    The zone in which to reserve the arena, typically one
+ *                obtained through heapmem_zone_register().
+ * \param size    The number of bytes to reserve for the arena.
+ * \return        A boolean indicating whether the space could be reserved.
+ *
+ * \sa            heapmem_scratch_alloc
+ * \sa            heapmem_scratch_reset
+ */
+bool heapmem_scratch_init(heapmem_scratch_t *scratch,
+                          heapmem_zone_t zone, size_t size);
+
+/**
+ * \brief         Release the space of a scratch arena back to the heap.
+ * \param scratch A pointer to a scratch arena that has been initialized
+ *                with heapmem_scratch_init().
+ *
+ * All objects allocated from the arena become invalid.
+ */
+void heapmem_scratch_deinit(heapmem_scratch_t *scratch);
+
+/**
+ * \brief         Allocate an object from a scratch arena.
+ * \param scratch A pointer to a scratch arena that has been initialized
+ *                with heapmem_scratch_init().
+ * \param size    The number of bytes to allocate.
+ * \return        A pointer to the allocated object, which has the same
+ *                alignment as the objects returned by heapmem_alloc(),
+ *                or NULL if the arena is full.
+ *
+ * Objects allocated from an arena cannot be freed individually.
+ */
+void *heapmem_scratch_alloc(heapmem_scratch_t *scratch, size_t size);
+
+/**
+ * \brief         Release all objects allocated from a scratch arena.
+ * \param scratch A pointer to a scratch arena that has been initialized
+ *                with heapmem_scratch_init().
+ */
+static inline void
+heapmem_scratch_reset(heapmem_scratch_t *scratch)
+{
+  scratch->used = 0;
+}
+
 /**
  * \brief       Obtain internal heapmem statistics regarding the
  *              allocated chunks.
@@ -195,6 +271,11 @@ bool heapmem_free(void *ptr);
  * and the number of chunks allocated. By using this information, developers
  * can tune their software to use the heapmem allocator more efficiently.
  *
+ * The peak_allocated field holds the largest amount of memory,
+ * including the overhead, that has been allocated at the same time,
+ * and the peak_scratch field holds the largest number of bytes that
+ * has been used in any scratch arena between two resets.
+ *
  */
 
 void heapmem_stats(heapmem_stats_t *stats);
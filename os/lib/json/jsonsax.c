@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "jsonsax.h"
+
+#include <string.h>
+/*--------------------------------------------------------------------*/
+enum {
+  ST_VALUE,         /* a value, at the start or after ':' or ',' */
+  ST_VALUE_OR_END,  /* a value or ']', after '[' */
+  ST_NAME,          /* a pair name, after ',' in an object */
+  ST_NAME_OR_END,   /* a pair name or '}', after '{' */
+  ST_COLON,
+  ST_COMMA_OR_END,
+  ST_STRING,
+  ST_ESCAPE,
+  ST_HEX,
+  ST_NUMBER,
+  ST_LITERAL,
+  ST_DONE,
+  ST_STOPPED,
+  ST_ERROR
+};
+
+#define FLAG_NAME     0x01
+#define FLAG_PARTIAL  0x02
+/*--------------------------------------------------------------------*/
+static bool
+is_ws(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+/*--------------------------------------------------------------------*/
+static bool
+is_digit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+/*--------------------------------------------------------------------*/
+static int
+hex_value(char c)
+{
+  if(is_digit(c)) {
+    return c - '0';
+  } else if(c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if(c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+/*--------------------------------------------------------------------*/
+/* -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? */
+static bool
+valid_number(const char *s)
+{
+  if(*s == '-') {
+    s++;
+  }
+  if(*s == '0') {
+    s++;
+  } else if(is_digit(*s)) {
+    while(is_digit(*s)) {
+      s++;
+    }
+  } else {
+    return false;
+  }
+  if(*s == '.') {
+    s++;
+    if(!is_digit(*s)) {
+      return false;
+    }
+    while(is_digit(*s)) {
+      s++;
+    }
+  }
+  if(*s == 'e' || *s == 'E') {
+    s++;
+    if(*s == '+' || *s == '-') {
+      s++;
+    }
+    if(!is_digit(*s)) {
+      return false;
+    }
+    while(is_digit(*s)) {
+      s++;
+    }
+  }
+  return *s == '\0';
+}
+/*--------------------------------------------------------------------*/
+static void
+fail(struct jsonsax_state *state, int error)
+{
+  state->state = ST_ERROR;
+  state->error = error;
+}
+/*--------------------------------------------------------------------*/
+static bool
+emit(struct jsonsax_state *state, int type, const char *value, int len)
+{
+  if(state->callback != NULL && state->callback(state, type, value, len)) {
+    state->state = ST_STOPPED;
+    return false;
+  }
+  return true;
+}
+/*--------------------------------------------------------------------*/
+static void
+end_value(struct jsonsax_state *state)
+{
+  state->state = state->depth == 0 ? ST_DONE : ST_COMMA_OR_END;
+}
+/*--------------------------------------------------------------------*/
+static bool
+open_container(struct jsonsax_state *state, char c)
+{
+  if(state->depth >= JSONSAX_MAX_DEPTH) {
+    fail(state, c == '{' ? JSON_ERROR_UNEXPECTED_OBJECT
+                         : JSON_ERROR_UNEXPECTED_ARRAY);
+    return false;
+  }
+  if(!emit(state, c, NULL, 0)) {
+    return false;
+  }
+  state->stack[state->depth++] = c;
+  state->state = c == '{' ? ST_NAME_OR_END : ST_VALUE_OR_END;
+  return true;
+}
+/*--------------------------------------------------------------------*/
+static bool
+close_container(struct jsonsax_state *state, char c)
+{
+  state->depth--;
+  if(!emit(state, c, NULL, 0)) {
+    return false;
+  }
+  end_value(state);
+  return true;
+}
+/*--------------------------------------------------------------------*/
+static bool
+end_number(struct jsonsax_state *state)
+{
+  state->token[state->index] = '\0';
+  if(!valid_number(state->token)) {
+    fail(state, JSON_ERROR_SYNTAX);
+    return false;
+  }
+  if(!emit(state, JSON_TYPE_NUMBER, state->token, state->index)) {
+    return false;
+  }
+  end_value(state);
+  return true;
+}
+/*--------------------------------------------------------------------*/
+/* start a value whose first character is c; returns false on error */
+static bool
+start_value(struct jsonsax_state *state, char c)
+{
+  switch(c) {
+  case '{':
+  case '[':
+    return open_container(state, c);
+  case '"':
+    state->flags = 0;
+    state->state = ST_STRING;
+    return true;
+  case 't':
+    state->literal = "true";
+    break;
+  case 'f':
+    state->literal = "false";
+    break;
+  case 'n':
+    state->literal = "null";
+    break;
+  default:
+    if(c == '-' || is_digit(c)) {
+      state->token[0] = c;
+      state->index = 1;
+      state->state = ST_NUMBER;
+      return true;
+    }
+    fail(state, c == '}' ? JSON_ERROR_UNEXPECTED_END_OF_OBJECT :
+                c == ']' ? JSON_ERROR_UNEXPECTED_END_OF_ARRAY :
+                JSON_ERROR_SYNTAX);
+    return false;
+  }
+  state->index = 1;
+  state->state = ST_LITERAL;
+  return true;
+}
+/*--------------------------------------------------------------------*/
+void
+jsonsax_init(struct jsonsax_state *state, jsonsax_callback_t callback,
+             void *user_data)
+{
+  memset(state, 0, sizeof(*state));
+  state->callback = callback;
+  state->user_data = user_data;
+  state->state = ST_VALUE;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonsax_feed(struct jsonsax_state *state, const char *buf, int len)
+{
+  const char *p = buf;
+  const char *end = buf + len;
+  /* start of the string fragment in this chunk */
+  const char *fragment = buf;
+  char c;
+
+  while(p < end && state->state < ST_STOPPED) {
+    c = *p;
+
+    switch(state->state) {
+    case ST_STRING:
+      while(c != '"' && c != '\\' && (unsigned char)c >= 0x20) {
+        if(++p == end) {
+          break;
+        }
+        c = *p;
+      }
+      if(p == end) {
+        continue;
+      }
+      if(c == '\\') {
+        state->state = ST_ESCAPE;
+      } else if(c == '"') {
+        state->flags &= ~FLAG_PARTIAL;
+        if(!emit(state, state->flags & FLAG_NAME ? JSON_TYPE_PAIR_NAME
+                                                 : JSON_TYPE_STRING,
+                 fragment, p - fragment)) {
+          break;
+        }
+        if(state->flags & FLAG_NAME) {
+          state->state = ST_COLON;
+        } else {
+          end_value(state);
+        }
+      } else {
+        fail(state, JSON_ERROR_SYNTAX);
+        continue;
+      }
+      break;
+
+    case ST_ESCAPE:
+      if(c == 'u') {
+        state->index = 0;
+        state->state = ST_HEX;
+      } else if(strchr("\"\\/bfnrt", c) != NULL && c != '\0') {
+        state->state = ST_STRING;
+      } else {
+        fail(state, JSON_ERROR_SYNTAX);
+        continue;
+      }
+      break;
+
+    case ST_HEX:
+      if(hex_value(c) < 0) {
+        fail(state, JSON_ERROR_SYNTAX);
+        continue;
+      }
+      if(++state->index == 4) {
+        state->state = ST_STRING;
+      }
+      break;
+
+    case ST_NUMBER:
+      if(is_digit(c) || c == '.' || c == 'e' || c == 'E' ||
+         c == '+' || c == '-') {
+        if(state->index >= JSONSAX_MAX_NUMBER_LEN) {
+          fail(state, JSON_ERROR_SYNTAX);
+          continue;
+        }
+        state->token[state->index++] = c;
+        break;
+      }
+      /* the character after the number is handled in its own state */
+      end_number(state);
+      continue;
+
+    case ST_LITERAL:
+      if(c != state->literal[state->index]) {
+        fail(state, JSON_ERROR_SYNTAX);
+        continue;
+      }
+      if(state->literal[++state->index] == '\0') {
+        if(!emit(state, state->literal[0], state->literal, state->index)) {
+          break;
+        }
+        end_value(state);
+      }
+      break;
+
+    default:
+      if(is_ws(c)) {
+        break;
+      }
+      switch(state->state) {
+      case ST_VALUE_OR_END:
+        if(c == ']') {
+          close_container(state, c);
+          break;
+        }
+        /* fall through */
+      case ST_VALUE:
+        start_value(state, c);
+        break;
+      case ST_NAME_OR_END:
+        if(c == '}') {
+          close_container(state, c);
+          break;
+        }
+        /* fall through */
+      case ST_NAME:
+        if(c == '"') {
+          state->flags = FLAG_NAME;
+          state->state = ST_STRING;
+        } else {
+          fail(state, c == '}' ? JSON_ERROR_UNEXPECTED_END_OF_OBJECT
+                               : JSON_ERROR_SYNTAX);
+        }
+        break;
+      case ST_COLON:
+        if(c == ':') {
+          state->state = ST_VALUE;
+        } else {
+          fail(state, JSON_ERROR_SYNTAX);
+        }
+        break;
+      case ST_COMMA_OR_END:
+        if(c == ',') {
+          state->state = state->stack[state->depth - 1] == '{' ?
+            ST_NAME : ST_VALUE;
+        } else if(c == '}' || c == ']') {
+          if(state->stack[state->depth - 1] == (c == '}' ? '{' : '[')) {
+            close_container(state, c);
+          } else {
+            fail(state, c == '}' ? JSON_ERROR_UNEXPECTED_END_OF_OBJECT
+                                 : JSON_ERROR_UNEXPECTED_END_OF_ARRAY);
+          }
+        } else {
+          fail(state, JSON_ERROR_SYNTAX);
+        }
+        break;
+      default:
+        /* ST_DONE: only whitespace may follow the document */
+        fail(state, JSON_ERROR_SYNTAX);
+        break;
+      }
+      if(state->state >= ST_STOPPED) {
+        continue;
+      }
+      if(state->state == ST_STRING) {
+        fragment = p + 1;
+      }
+      break;
+    }
+    p++;
+  }
+
+  state->offset += p - buf;
+
+  if(state->state == ST_ERROR) {
+    return JSONSAX_ERROR;
+  }
+  if(state->state == ST_STOPPED) {
+    return JSONSAX_STOPPED;
+  }
+
+  if(state->state >= ST_STRING && state->state <= ST_HEX && p > fragment) {
+    /* the string continues in the next chunk */
+    state->flags |= FLAG_PARTIAL;
+    if(!emit(state, state->flags & FLAG_NAME ? JSON_TYPE_PAIR_NAME
+                                             : JSON_TYPE_STRING,
+             fragment, p - fragment)) {
+      return JSONSAX_STOPPED;
+    }
+  }
+
+  return state->state == ST_DONE ? JSONSAX_DONE : JSONSAX_MORE;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonsax_finish(struct jsonsax_state *state)
+{
+  if(state->state == ST_NUMBER && state->depth == 0) {
+    end_number(state);
+  }
+
+  switch(state->state) {
+  case ST_DONE:
+    return JSONSAX_DONE;
+  case ST_STOPPED:
+    return JSONSAX_STOPPED;
+  case ST_ERROR:
+    return JSONSAX_ERROR;
+  default:
+    fail(state, JSON_ERROR_SYNTAX);
+    return JSONSAX_ERROR;
+  }
+}
+/*--------------------------------------------------------------------*/
+bool
+jsonsax_is_partial(const struct jsonsax_state *state)
+{
+  return (state->flags & FLAG_PARTIAL) != 0;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonsax_get_depth(const struct jsonsax_state *state)
+{
+  return state->depth;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonsax_get_type(const struct jsonsax_state *state)
+{
+  if(state->depth == 0) {
+    return 0;
+  }
+  return state->stack[state->depth - 1];
+}
+/*--------------------------------------------------------------------*/
+int
+jsonsax_get_error(const struct jsonsax_state *state)
+{
+  return state->error;
+}
+/*--------------------------------------------------------------------*/
+static int
+hex4(const char *s)
+{
+  int i, v, cp = 0;
+
+  for(i = 0; i < 4; i++) {
+    v = hex_value(s[i]);
+    if(v < 0) {
+      return -1;
+    }
+    cp = (cp << 4) | v;
+  }
+  return cp;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonsax_unescape(char *dst, int size, const char *src, int len)
+{
+  int i, o, n;
+  long cp;
+  int low;
+  char c;
+
+  if(size <= 0) {
+    return 0;
+  }
+
+  for(i = 0, o = 0; i < len && o < size - 1; i++) {
+    c = src[i];
+    if(c != '\\' || i + 1 >= len) {
+      dst[o++] = c;
+      continue;
+    }
+    c = src[++i];
+    switch(c) {
+    case 'b': dst[o++] = '\b'; break;
+    case 'f': dst[o++] = '\f'; break;
+    case 'n': dst[o++] = '\n'; break;
+    case 'r': dst[o++] = '\r'; break;
+    case 't': dst[o++] = '\t'; break;
+    case 'u':
+      if(i + 4 >= len || (cp = hex4(&src[i + 1])) < 0) {
+        goto out;
+      }
+      i += 4;
+      if(cp >= 0xd800 && cp < 0xdc00 && i + 6 < len &&
+         src[i + 1] == '\\' && src[i + 2] == 'u' &&
+         (low = hex4(&src[i + 3])) >= 0xdc00 && low < 0xe000) {
+        /* a surrogate pair */
+        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+        i += 6;
+      }
+      n = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+      if(o + n > size - 1) {
+        goto out;
+      }
+      if(n == 1) {
+        dst[o++] = cp;
+      } else if(n == 2) {
+        dst[o++] = 0xc0 | (cp >> 6);
+        dst[o++] = 0x80 | (cp & 0x3f);
+      } else if(n == 3) {
+        dst[o++] = 0xe0 | (cp >> 12);
+        dst[o++] = 0x80 | ((cp >> 6) & 0x3f);
+        dst[o++] = 0x80 | (cp & 0x3f);
+      } else {
+        dst[o++] = 0xf0 | (cp >> 18);
+        dst[o++] = 0x80 | ((cp >> 12) & 0x3f);
+        dst[o++] = 0x80 | ((cp >> 6) & 0x3f);
+        dst[o++] = 0x80 | (cp & 0x3f);
+      }
+      break;
+    default:
+      /* '"', '\\' and '/' stand for themselves */
+      dst[o++] = c;
+      break;
+    }
+  }
+out:
+  dst[o] = '\0';
+  return o;
+}
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A streaming, event-driven JSON parser.
+ *
+ *         Unlike jsonparse, which needs the whole document in one
+ *         buffer, this parser accepts the document in chunks of any
+ *         size as they arrive (e.g. CoAP Block1 blocks or MQTT
+ *         segments) and reports each token through a callback. The
+ *         parser state is a fixed-size struct whose size depends on
+ *         JSONSAX_MAX_DEPTH, not on the document.
+ *
+ *         Strings and pair names are reported as a pointer into the
+ *         chunk passed to jsonsax_feed() and a length, without copying.
+ *         The bytes are the raw contents between the quotes, with
+ *         escape sequences left as they are; jsonsax_unescape() decodes
+ *         them. A string that crosses a chunk boundary is reported in
+ *         several fragments, and jsonsax_is_partial() is true for all
+ *         but the last one. Numbers are short, so they are collected in
+ *         the state and reported as one NUL-terminated token.
+ */
+
+#ifndef JSONSAX_H_
+#define JSONSAX_H_
+
+#include "contiki.h"
+#include "json.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef JSONSAX_CONF_MAX_DEPTH
+#define JSONSAX_MAX_DEPTH JSONSAX_CONF_MAX_DEPTH
+#else
+#define JSONSAX_MAX_DEPTH 10
+#endif
+
+/* The longest number token accepted, not counting the terminating NUL */
+#ifdef JSONSAX_CONF_MAX_NUMBER_LEN
+#define JSONSAX_MAX_NUMBER_LEN JSONSAX_CONF_MAX_NUMBER_LEN
+#else
+#define JSONSAX_MAX_NUMBER_LEN 23
+#endif
+
+/* Return values of jsonsax_feed() and jsonsax_finish() */
+#define JSONSAX_MORE     0  /* The document is not complete yet */
+#define JSONSAX_DONE     1  /* A complete document has been parsed */
+#define JSONSAX_STOPPED  2  /* The callback asked the parser to stop */
+#define JSONSAX_ERROR   -1  /* Syntax error; see jsonsax_get_error() */
+
+struct jsonsax_state;
+
+/**
+ * \brief      Token callback.
+ * \param state The parser state
+ * \param type  JSON_TYPE_OBJECT or JSON_TYPE_ARRAY when a container
+ *              starts, '}' or ']' when it ends, JSON_TYPE_PAIR_NAME,
+ *              JSON_TYPE_STRING, JSON_TYPE_NUMBER, JSON_TYPE_TRUE,
+ *              JSON_TYPE_FALSE or JSON_TYPE_NULL for atomic tokens
+ * \param value The token's text, or NULL for container tokens
+ * \param len   The length of \e value
+ * \return      0 to continue parsing, non-zero to stop
+ */
+typedef int (*jsonsax_callback_t)(struct jsonsax_state *state, int type,
+                                  const char *value, int len);
+
+struct jsonsax_state {
+  jsonsax_callback_t callback;
+  void *user_data;
+  /* Number of bytes consumed so far, for locating errors */
+  uint32_t offset;
+  const char *literal;
+  uint8_t state;
+  uint8_t depth;
+  uint8_t error;
+  uint8_t flags;
+  /* Position in the current number, literal or \u escape */
+  uint8_t index;
+  char token[JSONSAX_MAX_NUMBER_LEN + 1];
+  char stack[JSONSAX_MAX_DEPTH];
+};
+
+/**
+ * \brief      Initialize a streaming JSON parser.
+ * \param state     A pointer to a parser state
+ * \param callback  The function called for each token
+ * \param user_data A pointer for the caller's use, kept in the state
+ */
+void jsonsax_init(struct jsonsax_state *state, jsonsax_callback_t callback,
+                  void *user_data);
+
+/**
+ * \brief      Parse the next chunk of a document.
+ * \param state The parser state
+ * \param buf   The chunk
+ * \param len   The length of the chunk
+ * \return      JSONSAX_MORE, JSONSAX_DONE, JSONSAX_STOPPED or JSONSAX_ERROR
+ *
+ *             Only whitespace may follow a complete document. Once the
+ *             parser has returned JSONSAX_STOPPED or JSONSAX_ERROR,
+ *             further calls return the same value.
+ */
+int jsonsax_feed(struct jsonsax_state *state, const char *buf, int len);
+
+/**
+ * \brief      Signal the end of the input.
+ * \param state The parser state
+ * \return      JSONSAX_DONE if the input held a complete document,
+ *              JSONSAX_STOPPED, or JSONSAX_ERROR otherwise
+ *
+ *             This is needed to complete a document that consists of a
+ *             single number, since nothing else marks its end.
+ */
+int jsonsax_finish(struct jsonsax_state *state);
+
+/**
+ * \brief      Check whether more fragments of the current string follow.
+ *
+ *             Only meaningful inside the callback for JSON_TYPE_STRING
+ *             and JSON_TYPE_PAIR_NAME tokens.
+ */
+bool jsonsax_is_partial(const struct jsonsax_state *state);
+
+/* get the nesting depth of the current token */
+int jsonsax_get_depth(const struct jsonsax_state *state);
+
+/* get the type of the innermost container: '{', '[' or 0 at top level */
+int jsonsax_get_type(const struct jsonsax_state *state);
+
+/* get the JSON_ERROR_ code of the last error */
+int jsonsax_get_error(const struct jsonsax_state *state);
+
+/**
+ * \brief      Decode the escape sequences of a raw string.
+ * \param dst  The output buffer
+ * \param size The size of the output buffer
+ * \param src  The raw string contents, as passed to the callback
+ * \param len  The length of \e src
+ * \return     The length of the decoded string
+ *
+ *             The output is NUL-terminated and truncated to fit. \\u
+ *             escapes are encoded as UTF-8. \e src must hold whole
+ *             escape sequences, so join the fragments of a partial
+ *             string before decoding it.
+ */
+int jsonsax_unescape(char *dst, int size, const char *src, int len);
+
+#endif /* JSONSAX_H_ */
@@ -50,32 +50,94 @@
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static void
+put_n(const struct jsontree_context *js_ctx, const char *text, int len)
+{
+  struct jsontree_output *out = js_ctx->out;
+  int n;
+
+  if(out == NULL) {
+    while(len-- > 0) {
+      js_ctx->putchar(*text++);
+    }
+    return;
+  }
+
+  if(out->kept < out->skip) {
+    /* already delivered by an earlier call */
+    n = out->skip - out->kept;
+    if(n > len) {
+      n = len;
+    }
+    out->kept += n;
+    text += n;
+    len -= n;
+  }
+
+  n = out->size - out->pos;
+  if(n > len) {
+    n = len;
+  }
+  memcpy(&out->buf[out->pos], text, n);
+  out->pos += n;
+  out->kept += n;
+  text += n;
+  len -= n;
+
+  if(len > 0) {
+    /* the buffer is full: keep the rest of the node for the next call */
+    if(out->overflow || out->carry_len + len > JSONTREE_CARRY_SIZE) {
+      out->overflow = 1;
+    } else {
+      memcpy(&out->carry[out->carry_len], text, len);
+      out->carry_len += len;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+put(const struct jsontree_context *js_ctx, char c)
+{
+  struct jsontree_output *out = js_ctx->out;
+
+  if(out == NULL) {
+    js_ctx->putchar(c);
+  } else if(out->kept >= out->skip && out->pos < out->size) {
+    out->buf[out->pos++] = c;
+    out->kept++;
+  } else {
+    put_n(js_ctx, &c, 1);
+  }
+}
 /*---------------------------------------------------------------------------*/
 void
 jsontree_write_atom(const struct jsontree_context *js_ctx, const char *text)
 {
   if(text == NULL) {
-    js_ctx->putchar('0');
+    put(js_ctx, '0');
   } else {
-    while(*text != '\0') {
-      js_ctx->putchar(*text++);
-    }
+    put_n(js_ctx, text, strlen(text));
   }
 }
 /*---------------------------------------------------------------------------*/
 void
 jsontree_write_string(const struct jsontree_context *js_ctx, const char *text)
 {
-  js_ctx->putchar('"');
+  const char *quote;
+
+  put(js_ctx, '"');
   if(text != NULL) {
-    while(*text != '\0') {
-      if(*text == '"') {
-        js_ctx->putchar('\\');
-      }
-      js_ctx->putchar(*text++);
+    /* copy the runs between quotes in one go */
+    while((quote = strchr(text, '"')) != NULL) {
+      put_n(js_ctx, text, quote - text);
+      put(js_ctx, '\\');
+      put(js_ctx, '"');
+      text = quote + 1;
     }
+    put_n(js_ctx, text, strlen(text));
   }
-  js_ctx->putchar('"');
+  put(js_ctx, '"');
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -84,26 +146,24 @@ jsontree_write_uint(const struct jsontree_context *js_ctx, unsigned int value)
   char buf[10];
   int l;
 
-  l = sizeof(buf) - 1;
+  l = sizeof(buf);
   do {
-    buf[l--] = '0' + (value % 10);
+    buf[--l] = '0' + (value % 10);
     value /= 10;
-  } while(value > 0 && l >= 0);
+  } while(value > 0 && l > 0);
 
-  while(++l < sizeof(buf)) {
-    js_ctx->putchar(buf[l]);
-  }
+  put_n(js_ctx, &buf[l], sizeof(buf) - l);
 }
 /*---------------------------------------------------------------------------*/
 void
 jsontree_write_int(const struct jsontree_context *js_ctx, int value)
 {
   if(value < 0) {
-    js_ctx->putchar('-');
-    value = -value;
+    put(js_ctx, '-');
+    jsontree_write_uint(js_ctx, -(unsigned int)value);
+  } else {
+    jsontree_write_uint(js_ctx, value);
   }
-
-  jsontree_write_uint(js_ctx, value);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -113,14 +173,24 @@ jsontree_setup(struct jsontree_context *js_ctx, struct jsontree_value *root,
   js_ctx->values[0] = root;
   js_ctx->putchar = putchar;
   js_ctx->path = 0;
+  js_ctx->out = NULL;
   jsontree_reset(js_ctx);
 }
 /*---------------------------------------------------------------------------*/
 void
+jsontree_setup_buffer(struct jsontree_context *js_ctx,
+                      struct jsontree_value *root)
+{
+  jsontree_setup(js_ctx, root, NULL);
+  js_ctx->out = &js_ctx->output;
+}
+/*---------------------------------------------------------------------------*/
+void
 jsontree_reset(struct jsontree_context *js_ctx)
 {
   js_ctx->depth = 0;
   js_ctx->index[0] = 0;
+  memset(&js_ctx->output, 0, sizeof(js_ctx->output));
 }
 /*---------------------------------------------------------------------------*/
 const char *
@@ -153,46 +223,46 @@ jsontree_print_next(struct jsontree_context *js_ctx)
 
     index = js_ctx->index[js_ctx->depth];
     if(index == 0) {
-      js_ctx->putchar(v->type);
+      put(js_ctx, v->type);
 #if JSONTREE_PRETTY
-      js_ctx->putchar('\n');
+      put(js_ctx, '\n');
 #endif
     }
     if(index >= o->count) {
 #if JSONTREE_PRETTY
-      js_ctx->putchar('\n');
+      put(js_ctx, '\n');
       indent = js_ctx->depth;
       while (indent--) {
-        js_ctx->putchar(' ');
-        js_ctx->putchar(' ');
+        put(js_ctx, ' ');
+        put(js_ctx, ' ');
       }
 #endif
-      js_ctx->putchar(v->type + 2);
+      put(js_ctx, v->type + 2);
       /* Default operation: back up one level! */
       break;
     }
 
     if(index > 0) {
-      js_ctx->putchar(',');
+      put(js_ctx, ',');
 #if JSONTREE_PRETTY
-      js_ctx->putchar('\n');
+      put(js_ctx, '\n');
 #endif
     }
 
 #if JSONTREE_PRETTY
     indent = js_ctx->depth + 1;
     while (indent--) {
-      js_ctx->putchar(' ');
-      js_ctx->putchar(' ');
+      put(js_ctx, ' ');
+      put(js_ctx, ' ');
     }
 #endif
 
     if(v->type == JSON_TYPE_OBJECT) {
       jsontree_write_string(js_ctx,
                             ((struct jsontree_object *)o)->pairs[index].name);
-      js_ctx->putchar(':');
+      put(js_ctx, ':');
 #if JSONTREE_PRETTY
-      js_ctx->putchar(' ');
+      put(js_ctx, ' ');
 #endif
       ov = ((struct jsontree_object *)o)->pairs[index].value;
     } else {
@@ -275,6 +345,76 @@ jsontree_print_next(struct jsontree_context *js_ctx)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+int
+jsontree_print_buffer(struct jsontree_context *js_ctx, char *buf, int size)
+{
+  struct jsontree_output *out = &js_ctx->output;
+  uint8_t depth;
+  uint16_t index, parent_index;
+  int callback_state;
+  int more;
+
+  if(size > UINT16_MAX) {
+    size = UINT16_MAX;
+  } else if(size < 0) {
+    size = 0;
+  }
+
+  out->buf = buf;
+  out->size = size;
+  out->pos = 0;
+
+  /* first the end of the node that did not fit last time */
+  if(out->carry_pos < out->carry_len) {
+    more = out->carry_len - out->carry_pos;
+    if(more > size) {
+      more = size;
+    }
+    memcpy(buf, &out->carry[out->carry_pos], more);
+    out->pos = more;
+    out->carry_pos += more;
+  }
+
+  while(!out->done && out->pos < out->size) {
+    /* remember what a node changes, so that it can be produced again */
+    depth = js_ctx->depth;
+    index = js_ctx->index[depth];
+    parent_index = depth > 0 ? js_ctx->index[depth - 1] : 0;
+    callback_state = js_ctx->callback_state;
+    out->kept = 0;
+    out->carry_len = 0;
+    out->carry_pos = 0;
+    out->overflow = 0;
+
+    more = jsontree_print_next(js_ctx);
+
+    if(out->overflow) {
+      js_ctx->depth = depth;
+      js_ctx->index[depth] = index;
+      if(depth > 0) {
+        js_ctx->index[depth - 1] = parent_index;
+      }
+      js_ctx->callback_state = callback_state;
+      out->carry_len = 0;
+      out->skip = out->kept;
+      break;
+    }
+    out->skip = 0;
+    if(!more) {
+      out->done = 1;
+    }
+  }
+
+  return out->pos;
+}
+/*---------------------------------------------------------------------------*/
+int
+jsontree_print_done(const struct jsontree_context *js_ctx)
+{
+  return js_ctx->output.done &&
+    js_ctx->output.carry_pos == js_ctx->output.carry_len;
+}
+/*---------------------------------------------------------------------------*/
 static struct jsontree_value *
 find_next(struct jsontree_context *js_ctx)
 {
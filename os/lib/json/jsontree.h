@@ -55,6 +55,31 @@
 #define JSONTREE_PRETTY 0
 #endif /* JSONTREE_CONF_PRETTY */
 
+/* Bytes of a node that can be kept for the next jsontree_print_buffer()
+   call when the buffer fills up, at most 255 */
+#ifdef JSONTREE_CONF_CARRY_SIZE
+#define JSONTREE_CARRY_SIZE JSONTREE_CONF_CARRY_SIZE
+#else
+#define JSONTREE_CARRY_SIZE 16
+#endif /* JSONTREE_CONF_CARRY_SIZE */
+
+/* State of buffered output, see jsontree_print_buffer() */
+struct jsontree_output {
+  char *buf;
+  uint16_t size;
+  uint16_t pos;
+  /* bytes of the current node already delivered by an earlier call */
+  uint16_t skip;
+  /* bytes of the current node skipped or stored so far */
+  uint16_t kept;
+  /* end of the last node, not yet delivered */
+  char carry[JSONTREE_CARRY_SIZE];
+  uint8_t carry_len;
+  uint8_t carry_pos;
+  uint8_t overflow;
+  uint8_t done;
+};
+
 struct jsontree_context {
   struct jsontree_value *values[JSONTREE_MAX_DEPTH];
   uint16_t index[JSONTREE_MAX_DEPTH];
@@ -62,6 +87,9 @@ struct jsontree_context {
   uint8_t depth;
   uint8_t path;
   int callback_state;
+  /* points to output when writing to a buffer, NULL when using putchar */
+  struct jsontree_output *out;
+  struct jsontree_output output;
 };
 
 struct jsontree_value {
@@ -143,6 +171,48 @@ void jsontree_setup(struct jsontree_context *js_ctx,
                     struct jsontree_value *root, int (* putchar)(int));
 void jsontree_reset(struct jsontree_context *js_ctx);
 
+/**
+ * \brief      Set up a context for output into caller-provided buffers.
+ * \param js_ctx The context
+ * \param root   The tree to serialize
+ *
+ *             Use jsontree_print_buffer() instead of jsontree_print_next()
+ *             with a context set up this way. Callbacks must write through
+ *             the jsontree_write_*() functions rather than js_ctx->putchar,
+ *             which is NULL.
+ */
+void jsontree_setup_buffer(struct jsontree_context *js_ctx,
+                           struct jsontree_value *root);
+
+/**
+ * \brief      Serialize the next part of a tree into a buffer.
+ * \param js_ctx The context, set up with jsontree_setup_buffer()
+ * \param buf    The buffer, e.g. a CoAP payload buffer
+ * \param size   The size of the buffer
+ * \return       The number of bytes written
+ *
+ *             Each call continues where the previous one stopped, so a
+ *             large tree can be sent in CoAP Block2 blocks or http-socket
+ *             chunks without serializing it from the start for each
+ *             block. When a node does not fit, the part that fits is
+ *             written and up to JSONTREE_CARRY_SIZE remaining bytes are
+ *             kept for the next call. A node with a longer remainder is
+ *             produced again by the next call, which drops the bytes
+ *             already delivered. The values and callbacks of such a node
+ *             must therefore give the same output for the same
+ *             callback_state until it is complete.
+ *
+ *             Sizes above UINT16_MAX are clamped, negative sizes are
+ *             treated as 0.
+ *
+ *             jsontree_print_done() tells whether anything is left.
+ */
+int jsontree_print_buffer(struct jsontree_context *js_ctx, char *buf,
+                          int size);
+
+/* check whether jsontree_print_buffer() has written the whole tree */
+int jsontree_print_done(const struct jsontree_context *js_ctx);
+
 const char *jsontree_path_name(const struct jsontree_context *js_ctx,
                                int depth);
 
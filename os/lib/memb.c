@@ -47,14 +47,129 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/*---------------------------------------------------------------------------*/
+#if MEMB_BITMAP
+#ifdef __GNUC__
+#define count_trailing_ones(w) ((unsigned)__builtin_ctz(~(w)))
+#else /* __GNUC__ */
+static unsigned
+count_trailing_ones(memb_bitmap_t w)
+{
+  unsigned n;
+
+  for(n = 0; w & 1; w >>= 1) {
+    n++;
+  }
+  return n;
+}
+#endif /* __GNUC__ */
+#endif /* MEMB_BITMAP */
+/*---------------------------------------------------------------------------*/
+static inline void
+count_alloc(struct memb *m)
+{
+#if MEMB_BITMAP || MEMB_STATS
+  m->count++;
+#endif /* MEMB_BITMAP || MEMB_STATS */
+#if MEMB_STATS
+  if(m->count > m->high_water) {
+    m->high_water = m->count;
+  }
+#endif /* MEMB_STATS */
+}
+/*---------------------------------------------------------------------------*/
+static inline void
+count_failure(struct memb *m)
+{
+#if MEMB_STATS
+  if(m->failures < (unsigned short)~0) {
+    m->failures++;
+  }
+#endif /* MEMB_STATS */
+}
+/*---------------------------------------------------------------------------*/
+static inline void
+count_free(struct memb *m)
+{
+#if MEMB_BITMAP || MEMB_STATS
+  m->count--;
+#endif /* MEMB_BITMAP || MEMB_STATS */
+}
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
+#if MEMB_BITMAP
+  memset(m->used, 0, MEMB_BITMAP_WORDS(m->num) * sizeof(memb_bitmap_t));
+#else /* MEMB_BITMAP */
   memset(m->used, 0, m->num);
+#endif /* MEMB_BITMAP */
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_BITMAP || MEMB_STATS
+  m->count = 0;
+#endif /* MEMB_BITMAP || MEMB_STATS */
+#if MEMB_STATS
+  m->high_water = 0;
+  m->failures = 0;
+#endif /* MEMB_STATS */
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_BITMAP
+void *
+memb_alloc(struct memb *m)
+{
+  unsigned w;
+  unsigned i;
+
+  if(m->count < m->num) {
+    for(w = 0; w < MEMB_BITMAP_WORDS(m->num); w++) {
+      if(m->used[w] != (memb_bitmap_t)~0) {
+        /* The bits past the last block are never set, so the first
+           clear bit of a word is a free block as long as the count
+           says there is one. */
+        i = count_trailing_ones(m->used[w]);
+        m->used[w] |= (memb_bitmap_t)1 << i;
+        count_alloc(m);
+        return (void *)((char *)m->mem +
+                        (w * MEMB_BITMAP_WORD_BITS + i) * m->size);
+      }
+    }
+  }
+
+  /* No free block was found, so we return NULL to indicate failure to
+     allocate block. */
+  count_failure(m);
+  return NULL;
 }
 /*---------------------------------------------------------------------------*/
+int
+memb_free(struct memb *m, void *ptr)
+{
+  size_t offset;
+  size_t i;
+  memb_bitmap_t bit;
+
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+
+  /* Pointers into the middle of a block are not valid. */
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+
+  i = offset / m->size;
+  bit = (memb_bitmap_t)1 << (i % MEMB_BITMAP_WORD_BITS);
+  if((m->used[i / MEMB_BITMAP_WORD_BITS] & bit) == 0) {
+    /* Double free. */
+    return -1;
+  }
+  m->used[i / MEMB_BITMAP_WORD_BITS] &= ~bit;
+  count_free(m);
+  return 0;
+}
+#else /* MEMB_BITMAP */
 void *
 memb_alloc(struct memb *m)
 {
@@ -65,12 +180,14 @@ memb_alloc(struct memb *m)
       /* If this block was unused, we set the used flag on
 	 and return a pointer to the memory block. */
       m->used[i] = true;
+      count_alloc(m);
       return (void *)((char *)m->mem + (i * m->size));
     }
   }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
+  count_failure(m);
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -90,12 +207,14 @@ memb_free(struct memb *m, void *ptr)
       if (m->used[i] == false)
         return -1;
       m->used[i] = false;
+      count_free(m);
       return 0;
     }
     ptr2 += m->size;
   }
   return -1;
 }
+#endif /* MEMB_BITMAP */
 /*---------------------------------------------------------------------------*/
 int
 memb_inmemb(struct memb *m, void *ptr)
@@ -107,6 +226,9 @@ memb_inmemb(struct memb *m, void *ptr)
 size_t
 memb_numfree(struct memb *m)
 {
+#if MEMB_BITMAP
+  return m->num - m->count;
+#else /* MEMB_BITMAP */
   int i;
   size_t num_free = 0;
 
@@ -117,5 +239,6 @@ memb_numfree(struct memb *m)
   }
 
   return num_free;
+#endif /* MEMB_BITMAP */
 }
 /** @} */
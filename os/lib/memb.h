@@ -67,6 +67,37 @@
 #include <stdlib.h>
 #include "sys/cc.h"
 
+/*
+ * When MEMB_CONF_BITMAP is enabled, the allocation state of the
+ * blocks is kept in a bitmap of machine words instead of an array of
+ * booleans. memb_alloc() then finds a free block a word at a time by
+ * counting trailing ones, memb_free() locates the block by pointer
+ * arithmetic, and memb_numfree() returns a maintained count.
+ */
+#ifdef MEMB_CONF_BITMAP
+#define MEMB_BITMAP MEMB_CONF_BITMAP
+#else
+#define MEMB_BITMAP 0
+#endif
+
+/*
+ * When MEMB_CONF_STATS is enabled, each memory block keeps a
+ * high-water mark of allocated blocks and a count of failed
+ * allocations.
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else
+#define MEMB_STATS 0
+#endif
+
+#if MEMB_BITMAP
+typedef unsigned int memb_bitmap_t;
+#define MEMB_BITMAP_WORD_BITS (sizeof(memb_bitmap_t) * 8)
+#define MEMB_BITMAP_WORDS(num) \
+        (((num) + MEMB_BITMAP_WORD_BITS - 1) / MEMB_BITMAP_WORD_BITS)
+#endif /* MEMB_BITMAP */
+
 /**
  * Declare a memory block.
  *
@@ -88,18 +119,38 @@ MEMB(connections, struct connection, 16);
  * \param num The total number of memory chunks in the block.
  *
  */
+#if MEMB_BITMAP
+#define MEMB(name, structure, num) \
+        static memb_bitmap_t CC_CONCAT(name,_memb_used)[MEMB_BITMAP_WORDS(num)]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_used), \
+                                          (void *)CC_CONCAT(name,_memb_mem)}
+#else /* MEMB_BITMAP */
 #define MEMB(name, structure, num) \
         static bool CC_CONCAT(name,_memb_used)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
                                           (void *)CC_CONCAT(name,_memb_mem)}
+#endif /* MEMB_BITMAP */
 
 struct memb {
   unsigned short size;
   unsigned short num;
+#if MEMB_BITMAP
+  memb_bitmap_t *used;
+#else /* MEMB_BITMAP */
   bool *used;
+#endif /* MEMB_BITMAP */
   void *mem;
+#if MEMB_BITMAP || MEMB_STATS
+  unsigned short count;
+#endif /* MEMB_BITMAP || MEMB_STATS */
+#if MEMB_STATS
+  unsigned short high_water;
+  unsigned short failures;
+#endif /* MEMB_STATS */
 };
 
 /**
@@ -150,6 +201,31 @@ int memb_inmemb(struct memb *m, void *ptr);
  */
 size_t memb_numfree(struct memb *m);
 
+#if MEMB_STATS
+/**
+ * Get the largest number of blocks that have been allocated at the
+ * same time since memb_init() was called.
+ *
+ * \param m A set of memory blocks previously declared with MEMB().
+ */
+static inline size_t
+memb_high_water(struct memb *m)
+{
+  return m->high_water;
+}
+
+/**
+ * Get the number of failed allocations since memb_init() was called.
+ *
+ * \param m A set of memory blocks previously declared with MEMB().
+ */
+static inline size_t
+memb_failures(struct memb *m)
+{
+  return m->failures;
+}
+#endif /* MEMB_STATS */
+
 /** @} */
 /** @} */
 
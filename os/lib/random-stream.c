@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Per-subsystem pseudo-random streams, using xoshiro128**
+ *         by David Blackman and Sebastiano Vigna.
+ */
+
+#include "lib/random.h"
+
+#include <stdbool.h>
+/*---------------------------------------------------------------------------*/
+/* Seeds the default stream while the others are seeded from random_rand() */
+#define FIXED_SEED 0x5eed5eedUL
+/*---------------------------------------------------------------------------*/
+static uint32_t state[RANDOM_STREAM_COUNT][4];
+static bool seeded;
+/*---------------------------------------------------------------------------*/
+static inline uint32_t
+rotl(uint32_t x, int k)
+{
+  return (x << k) | (x >> (32 - k));
+}
+/*---------------------------------------------------------------------------*/
+/* The MurmurHash3 finalizer, to spread a seed over the state */
+static uint32_t
+mix(uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x85ebca6bUL;
+  x ^= x >> 13;
+  x *= 0xc2b2ae35UL;
+  x ^= x >> 16;
+  return x;
+}
+/*---------------------------------------------------------------------------*/
+static void
+seed_stream(random_stream_t stream, uint32_t seed)
+{
+  uint32_t *s = state[stream];
+  int i;
+
+  /* Each word gets a distinct input, so the state is never all zero */
+  for(i = 0; i < 4; i++) {
+    s[i] = mix(seed + 0x9e3779b9UL * (4 * stream + i + 1));
+  }
+  if((s[0] | s[1] | s[2] | s[3]) == 0) {
+    s[0] = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+seed_from_random_rand(void)
+{
+  uint32_t seed;
+
+  /* random_rand() may be backed by the default stream itself */
+  seed_stream(RANDOM_STREAM_DEFAULT, FIXED_SEED);
+  seeded = true;
+
+  seed = (uint32_t)random_rand() << 16;
+  seed |= random_rand();
+  random_stream_init(seed);
+}
+/*---------------------------------------------------------------------------*/
+void
+random_stream_init(uint32_t seed)
+{
+  int i;
+
+  for(i = 0; i < RANDOM_STREAM_COUNT; i++) {
+    seed_stream(i, seed);
+  }
+  seeded = true;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+random_stream_rand(random_stream_t stream)
+{
+  uint32_t *s;
+  uint32_t result;
+  uint32_t t;
+
+  if(!seeded) {
+    seed_from_random_rand();
+  }
+
+  s = state[stream];
+  result = rotl(s[1] * 5, 7) * 9;
+  t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+random_stream_range(random_stream_t stream, uint32_t bound)
+{
+  uint64_t m;
+  uint32_t threshold;
+
+  if(bound == 0) {
+    return 0;
+  }
+
+  /*
+   * Lemire's method: the high word of x * bound is uniform in [0, bound)
+   * once the few values of x that would favour some results are rejected.
+   * They are recognised by the low word, so the division that finds them
+   * is only needed when the low word is small.
+   */
+  m = (uint64_t)random_stream_rand(stream) * bound;
+  if((uint32_t)m < bound) {
+    threshold = -bound % bound;
+    while((uint32_t)m < threshold) {
+      m = (uint64_t)random_stream_rand(stream) * bound;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
+/*---------------------------------------------------------------------------*/
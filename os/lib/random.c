@@ -32,21 +32,19 @@
 
 
 #include "lib/random.h"
-#include <stdlib.h>
 
 /*---------------------------------------------------------------------------*/
 void
 random_init(unsigned short seed)
 {
-  srand(seed);
+  random_stream_init(seed);
 }
 /*---------------------------------------------------------------------------*/
 unsigned short
 random_rand(void)
 {
-/* In gcc int rand() uses RAND_MAX and long random() uses RANDOM_MAX=0x7FFFFFFF */
-/* RAND_MAX varies depending on the architecture */
-
-  return (unsigned short)rand();
+  /* The high bits of xoshiro128** are the stronger ones. Unlike rand(),
+     this gives the full 16 bits regardless of the libc's RAND_MAX. */
+  return (unsigned short)(random_stream_rand(RANDOM_STREAM_DEFAULT) >> 16);
 }
 /*---------------------------------------------------------------------------*/
@@ -32,6 +32,8 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <stdint.h>
+
 /*
  * Initialize the pseudo-random generator.
  *
@@ -49,4 +51,45 @@ unsigned short random_rand(void);
 /* Since random_rand casts to unsigned short, we'll use this maxmimum */
 #define RANDOM_RAND_MAX 65535U
 
+/*
+ * Independent pseudo-random streams, one per subsystem, so that the
+ * numbers drawn by one protocol layer do not depend on how many the
+ * others have used. A simulation with a fixed seed then replays each
+ * layer the same way even when another layer changes.
+ *
+ * The streams use xoshiro128** and are not suitable for cryptography.
+ */
+typedef enum {
+  /* Backs random_rand() on platforms without a hardware generator */
+  RANDOM_STREAM_DEFAULT,
+  RANDOM_STREAM_CSMA,
+  RANDOM_STREAM_TSCH,
+  RANDOM_STREAM_TRICKLE,
+  RANDOM_STREAM_RPL,
+  RANDOM_STREAM_COUNT
+} random_stream_t;
+
+/*
+ * Seed all streams from a single seed.
+ *
+ * random_init() does this on platforms without a hardware generator.
+ * Otherwise, the streams are seeded from random_rand() on first use.
+ */
+void random_stream_init(uint32_t seed);
+
+/*
+ * Get the next number from a stream.
+ *
+ * \return A pseudo-random number between 0 and 2^32 - 1.
+ */
+uint32_t random_stream_rand(random_stream_t stream);
+
+/*
+ * Get a number in [0, bound) from a stream, without the bias of
+ * random_rand() % bound.
+ *
+ * \return A pseudo-random number between 0 and bound - 1, or 0 if bound is 0.
+ */
+uint32_t random_stream_range(random_stream_t stream, uint32_t bound);
+
 #endif /* RANDOM_H_ */
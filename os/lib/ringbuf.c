@@ -38,7 +38,9 @@
  */
 
 #include "lib/ringbuf.h"
+#include "sys/memory-barrier.h"
 #include <sys/cc.h>
+#include <string.h>
 /*---------------------------------------------------------------------------*/
 void
 ringbuf_init(struct ringbuf *r, uint8_t *dataptr, uint8_t size)
@@ -121,3 +123,117 @@ ringbuf_elements(struct ringbuf *r)
   return (r->put_ptr - r->get_ptr) & r->mask;
 }
 /*---------------------------------------------------------------------------*/
+int
+ringbuf_peek_put_region(struct ringbuf *r, uint8_t **ptr)
+{
+  uint8_t put_ptr;
+  int space;
+
+  /* Only the producer writes ->put_ptr, but ->get_ptr may be written
+     concurrently by the consumer, so it is read once. */
+  put_ptr = r->put_ptr;
+  space = (CC_ACCESS_NOW(uint8_t, r->get_ptr) - put_ptr - 1) & r->mask;
+  if(space > r->mask + 1 - put_ptr) {
+    space = r->mask + 1 - put_ptr;
+  }
+  *ptr = &r->data[put_ptr];
+  return space;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_commit_put(struct ringbuf *r, int len)
+{
+  uint8_t *ptr;
+
+  /* The region handed out before can only have grown since, as the
+     consumer frees space. */
+  if(len < 0 || len > ringbuf_peek_put_region(r, &ptr)) {
+    return 0;
+  }
+  /* Make sure that the data is written before the consumer can see
+     it. */
+  memory_barrier();
+  CC_ACCESS_NOW(uint8_t, r->put_ptr) = (r->put_ptr + len) & r->mask;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_peek_get_region(struct ringbuf *r, const uint8_t **ptr)
+{
+  uint8_t get_ptr;
+  int len;
+
+  get_ptr = r->get_ptr;
+  len = (CC_ACCESS_NOW(uint8_t, r->put_ptr) - get_ptr) & r->mask;
+  if(len > r->mask + 1 - get_ptr) {
+    len = r->mask + 1 - get_ptr;
+  }
+  /* Make sure that the data is not read before the put pointer. */
+  memory_barrier();
+  *ptr = &r->data[get_ptr];
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_commit_get(struct ringbuf *r, int len)
+{
+  const uint8_t *ptr;
+
+  /* The region handed out before can only have grown since, as the
+     producer adds data. */
+  if(len < 0 || len > ringbuf_peek_get_region(r, &ptr)) {
+    return 0;
+  }
+  /* Make sure that the data is read before the producer can reuse
+     it. */
+  memory_barrier();
+  CC_ACCESS_NOW(uint8_t, r->get_ptr) = (r->get_ptr + len) & r->mask;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_put_n(struct ringbuf *r, const uint8_t *data, int len)
+{
+  uint8_t *ptr;
+  int n, done, i;
+
+  /* The free space wraps around the end of the buffer at most once. */
+  done = 0;
+  for(i = 0; i < 2 && done < len; i++) {
+    n = ringbuf_peek_put_region(r, &ptr);
+    if(n > len - done) {
+      n = len - done;
+    }
+    if(n == 0) {
+      break;
+    }
+    memcpy(ptr, data + done, n);
+    ringbuf_commit_put(r, n);
+    done += n;
+  }
+  return done;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbuf_get_n(struct ringbuf *r, uint8_t *data, int len)
+{
+  const uint8_t *ptr;
+  int n, done, i;
+
+  /* The data wraps around the end of the buffer at most once. */
+  done = 0;
+  for(i = 0; i < 2 && done < len; i++) {
+    n = ringbuf_peek_get_region(r, &ptr);
+    if(n > len - done) {
+      n = len - done;
+    }
+    if(n == 0) {
+      break;
+    }
+    memcpy(data + done, ptr, n);
+    ringbuf_commit_get(r, n);
+    done += n;
+  }
+  return done;
+}
+/*---------------------------------------------------------------------------*/
@@ -129,6 +129,77 @@ int     ringbuf_size(struct ringbuf *r);
  */
 int     ringbuf_elements(struct ringbuf *r);
 
+/**
+ * \brief      Insert several bytes into the ring buffer
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param data The bytes to be written to the buffer
+ * \param len  The number of bytes to be written
+ * \return     The number of bytes written, which is less than len if
+ *             the buffer became full.
+ *
+ *             This function may be called by the producer in place of
+ *             ringbuf_put(), including from an interrupt handler. The
+ *             bytes are copied before they are made visible to the
+ *             consumer.
+ */
+int     ringbuf_put_n(struct ringbuf *r, const uint8_t *data, int len);
+
+/**
+ * \brief      Get several bytes from the ring buffer
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param data The buffer to copy the bytes to
+ * \param len  The maximum number of bytes to get
+ * \return     The number of bytes copied to data.
+ *
+ *             This function may be called by the consumer in place of
+ *             ringbuf_get(), including from an interrupt handler.
+ */
+int     ringbuf_get_n(struct ringbuf *r, uint8_t *data, int len);
+
+/**
+ * \brief      Get the free space that can be written to directly
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param ptr  Set to the start of the free space
+ * \return     The number of bytes that can be written contiguously at ptr.
+ *
+ *             This lets the producer fill the buffer with memcpy() or
+ *             DMA. The bytes become visible to the consumer when they
+ *             are committed with ringbuf_commit_put(). As the free
+ *             space may wrap around the end of the buffer, there may
+ *             be more free space after the commit.
+ */
+int     ringbuf_peek_put_region(struct ringbuf *r, uint8_t **ptr);
+
+/**
+ * \brief      Commit bytes written to the region from ringbuf_peek_put_region()
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param len  The number of bytes written, at most the size of the region
+ * \retval 0    len is larger than the region; nothing is committed
+ * \retval 1    The bytes are committed
+ */
+int     ringbuf_commit_put(struct ringbuf *r, int len);
+
+/**
+ * \brief      Get the data that can be read directly
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param ptr  Set to the start of the data
+ * \return     The number of bytes that can be read contiguously at ptr.
+ *
+ *             This lets the consumer drain the buffer with memcpy() or
+ *             DMA. The bytes are released to the producer when they
+ *             are committed with ringbuf_commit_get().
+ */
+int     ringbuf_peek_get_region(struct ringbuf *r, const uint8_t **ptr);
+
+/**
+ * \brief      Release bytes read from the region from ringbuf_peek_get_region()
+ * \param r    A pointer to a struct ringbuf to hold the state of the ring buffer
+ * \param len  The number of bytes read, at most the size of the region
+ * \retval 0    len is larger than the region; nothing is released
+ * \retval 1    The bytes are released
+ */
+int     ringbuf_commit_get(struct ringbuf *r, int len);
+
 #endif /* RINGBUF_H_ */
 
 /** @}*/
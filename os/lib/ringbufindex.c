@@ -44,6 +44,8 @@
 
 #include <string.h>
 #include "lib/ringbufindex.h"
+#include "sys/memory-barrier.h"
+#include "sys/cc.h"
 
 /* Initialize a ring buffer. The size must be a power of two */
 void
@@ -147,3 +149,63 @@ ringbufindex_empty(const struct ringbufindex *r)
 {
   return ringbufindex_elements(r) == 0;
 }
+/* Find the contiguous free elements, starting at the returned index */
+int
+ringbufindex_peek_put_region(const struct ringbufindex *r, int *n)
+{
+  uint8_t put_ptr;
+  int space;
+
+  /* ->get_ptr may be written concurrently by the consumer, so it is
+     read once. */
+  put_ptr = r->put_ptr;
+  space = (CC_ACCESS_NOW(uint8_t, r->get_ptr) - put_ptr - 1) & r->mask;
+  if(space > r->mask + 1 - put_ptr) {
+    space = r->mask + 1 - put_ptr;
+  }
+  *n = space;
+  return space > 0 ? put_ptr : -1;
+}
+/* Add n elements that were filled in */
+int
+ringbufindex_commit_put(struct ringbufindex *r, int n)
+{
+  if(n > ((CC_ACCESS_NOW(uint8_t, r->get_ptr) - r->put_ptr - 1) & r->mask)) {
+    return 0;
+  }
+  /* Make sure that the elements are written before the consumer can
+     see them. */
+  memory_barrier();
+  CC_ACCESS_NOW(uint8_t, r->put_ptr) = (r->put_ptr + n) & r->mask;
+  return 1;
+}
+/* Find the contiguous elements, starting at the returned index */
+int
+ringbufindex_peek_get_region(const struct ringbufindex *r, int *n)
+{
+  uint8_t get_ptr;
+  int len;
+
+  get_ptr = r->get_ptr;
+  len = (CC_ACCESS_NOW(uint8_t, r->put_ptr) - get_ptr) & r->mask;
+  if(len > r->mask + 1 - get_ptr) {
+    len = r->mask + 1 - get_ptr;
+  }
+  /* Make sure that the elements are not read before the put pointer. */
+  memory_barrier();
+  *n = len;
+  return len > 0 ? get_ptr : -1;
+}
+/* Remove n elements that were read */
+int
+ringbufindex_commit_get(struct ringbufindex *r, int n)
+{
+  if(n > ((CC_ACCESS_NOW(uint8_t, r->put_ptr) - r->get_ptr) & r->mask)) {
+    return 0;
+  }
+  /* Make sure that the elements are read before the producer can
+     reuse them. */
+  memory_barrier();
+  CC_ACCESS_NOW(uint8_t, r->get_ptr) = (r->get_ptr + n) & r->mask;
+  return 1;
+}
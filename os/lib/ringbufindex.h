@@ -116,4 +116,45 @@ int ringbufindex_full(const struct ringbufindex *r);
  */
 int ringbufindex_empty(const struct ringbufindex *r);
 
+/**
+ * \brief Find the free elements that can be filled in directly
+ * \param r Pointer to ringbufindex
+ * \param n Set to the number of contiguous free elements
+ * \retval >= 0 The index of the first free element
+ * \retval -1 Failure; the ring buffer is full
+ *
+ * The elements can be filled in with memcpy() or DMA, and are added to
+ * the ring buffer with ringbufindex_commit_put(). As the free elements
+ * may wrap around the end of the buffer, more may be free after the
+ * commit.
+ */
+int ringbufindex_peek_put_region(const struct ringbufindex *r, int *n);
+
+/**
+ * \brief Add elements that were filled in after ringbufindex_peek_put_region()
+ * \param r Pointer to ringbufindex
+ * \param n The number of elements to add
+ * \retval 0 Failure; there is not enough free space
+ * \retval 1 Success; the elements are added
+ */
+int ringbufindex_commit_put(struct ringbufindex *r, int n);
+
+/**
+ * \brief Find the elements that can be read directly
+ * \param r Pointer to ringbufindex
+ * \param n Set to the number of contiguous elements
+ * \retval >= 0 The index of the first element
+ * \retval -1 No element in the ring buffer
+ */
+int ringbufindex_peek_get_region(const struct ringbufindex *r, int *n);
+
+/**
+ * \brief Remove elements that were read after ringbufindex_peek_get_region()
+ * \param r Pointer to ringbufindex
+ * \param n The number of elements to remove
+ * \retval 0 Failure; there are fewer elements in the ring buffer
+ * \retval 1 Success; the elements are removed
+ */
+int ringbufindex_commit_get(struct ringbufindex *r, int n);
+
 #endif /* RINGBUFINDEX_H_ */
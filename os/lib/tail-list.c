@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \addtogroup tail-list
+ * @{
+ *
+ * \file
+ *   Implementation of singly-linked lists with a tail pointer
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/tail-list.h"
+/*---------------------------------------------------------------------------*/
+struct tl {
+  struct tl *next;
+};
+/*---------------------------------------------------------------------------*/
+void
+tail_list_init(tail_list_t list)
+{
+  list->head = NULL;
+  list->tail = NULL;
+  list->length = 0;
+}
+/*---------------------------------------------------------------------------*/
+void *
+tail_list_pop(tail_list_t list)
+{
+  struct tl *l = list->head;
+
+  if(l != NULL) {
+    list->head = l->next;
+    if(list->head == NULL) {
+      list->tail = NULL;
+    }
+    l->next = NULL;
+    list->length--;
+  }
+
+  return l;
+}
+/*---------------------------------------------------------------------------*/
+void
+tail_list_push(tail_list_t list, void *item)
+{
+  ((struct tl *)item)->next = list->head;
+  list->head = item;
+  if(list->tail == NULL) {
+    list->tail = item;
+  }
+  list->length++;
+}
+/*---------------------------------------------------------------------------*/
+void *
+tail_list_chop(tail_list_t list)
+{
+  struct tl *l, *r;
+
+  if(list->head == NULL) {
+    return NULL;
+  }
+
+  r = list->tail;
+  list->length--;
+  if(list->head == r) {
+    list->head = NULL;
+    list->tail = NULL;
+    return r;
+  }
+
+  for(l = list->head; l->next != r; l = l->next);
+
+  l->next = NULL;
+  list->tail = l;
+
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+void
+tail_list_add(tail_list_t list, void *item)
+{
+  ((struct tl *)item)->next = NULL;
+
+  if(list->tail == NULL) {
+    list->head = item;
+  } else {
+    ((struct tl *)list->tail)->next = item;
+  }
+  list->tail = item;
+  list->length++;
+}
+/*---------------------------------------------------------------------------*/
+void
+tail_list_remove(tail_list_t list, const void *item)
+{
+  struct tl *l, *r;
+
+  r = NULL;
+  for(l = list->head; l != NULL; l = l->next) {
+    if(l == item) {
+      if(r == NULL) {
+        list->head = l->next;
+      } else {
+        r->next = l->next;
+      }
+      if(list->tail == l) {
+        list->tail = r;
+      }
+      l->next = NULL;
+      list->length--;
+      return;
+    }
+    r = l;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tail_list_copy(tail_list_t dest, const_tail_list_t src)
+{
+  dest->head = src->head;
+  dest->tail = src->tail;
+  dest->length = src->length;
+}
+/*---------------------------------------------------------------------------*/
+void
+tail_list_insert(tail_list_t list, void *previtem, void *newitem)
+{
+  if(previtem == NULL) {
+    tail_list_push(list, newitem);
+    return;
+  }
+
+  ((struct tl *)newitem)->next = ((struct tl *)previtem)->next;
+  ((struct tl *)previtem)->next = newitem;
+  if(list->tail == previtem) {
+    list->tail = newitem;
+  }
+  list->length++;
+}
+/*---------------------------------------------------------------------------*/
+bool
+tail_list_contains(const_tail_list_t list, const void *item)
+{
+  struct tl *l;
+
+  for(l = list->head; l != NULL; l = l->next) {
+    if(l == item) {
+      return true;
+    }
+  }
+
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/** \addtogroup data
+ * @{
+ *
+ * \defgroup tail-list Linked list with a tail pointer
+ *
+ * This library provides a singly-linked list that keeps a pointer to its
+ * last element and its length in addition to its first element. Its
+ * functions follow those of the \ref list "linked list library", with a
+ * tail_list_ prefix and their own list type, and elements are laid out
+ * the same way (the first field must be a pointer called \e next). Code
+ * using list.h has to be converted to use it.
+ *
+ * tail_list_add(), tail_list_push(), tail_list_pop(), tail_list_insert(),
+ * tail_list_tail() and tail_list_length() run in constant time. Removing
+ * an arbitrary element still needs to find its predecessor, so
+ * tail_list_remove() and tail_list_chop() walk the list, except when
+ * removing the head.
+ *
+ * Unlike list_add() and list_push(), which first remove the element from
+ * the list to avoid adding it twice, the functions in this library require
+ * that the element is not already on the list. To move an element, call
+ * tail_list_remove() first.
+ *
+ * This library is not safe to be used within an interrupt context.
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef TAIL_LIST_H_
+#define TAIL_LIST_H_
+/*---------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+/*---------------------------------------------------------------------------*/
+#define TAIL_LIST_CONCAT2(s1, s2) s1##s2
+#define TAIL_LIST_CONCAT(s1, s2) TAIL_LIST_CONCAT2(s1, s2)
+/*---------------------------------------------------------------------------*/
+/**
+ * The storage behind a tail list: pointers to the first and last element,
+ * and the number of elements.
+ */
+struct tail_list {
+  void *head;
+  void *tail;
+  int length;
+};
+
+/**
+ * The tail list type.
+ */
+typedef struct tail_list *tail_list_t;
+
+/**
+ * The non-modifiable tail list type.
+ */
+typedef const struct tail_list *const_tail_list_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Declare a tail list.
+ *
+ * The list variable is declared as static, as with LIST().
+ *
+ * \param name The name of the list.
+ */
+#define TAIL_LIST(name) \
+  static struct tail_list TAIL_LIST_CONCAT(name, _tail_list) = { NULL, NULL, 0 }; \
+  static tail_list_t name = &TAIL_LIST_CONCAT(name, _tail_list)
+
+/**
+ * \brief Declare a tail list inside a structure declaration.
+ *
+ * The list must be initialised with TAIL_LIST_STRUCT_INIT() before use.
+ *
+ * \param name The name of the list.
+ */
+#define TAIL_LIST_STRUCT(name) \
+  struct tail_list TAIL_LIST_CONCAT(name, _tail_list); \
+  tail_list_t name
+
+/**
+ * \brief Initialise a tail list that is part of a structure.
+ * \param struct_ptr A pointer to the struct
+ * \param name The name of the list.
+ */
+#define TAIL_LIST_STRUCT_INIT(struct_ptr, name)                           \
+  do {                                                                    \
+    (struct_ptr)->name = &((struct_ptr)->TAIL_LIST_CONCAT(name, _tail_list)); \
+    tail_list_init((struct_ptr)->name);                                   \
+  } while(0)
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Initialise a tail list.
+ * \param list The list.
+ */
+void tail_list_init(tail_list_t list);
+
+/**
+ * \brief Return the first element of a tail list.
+ * \param list The list.
+ * \return A pointer to the list's head, or NULL if the list is empty
+ */
+static inline void *
+tail_list_head(const_tail_list_t list)
+{
+  return list->head;
+}
+
+/**
+ * \brief Return the last element of a tail list.
+ * \param list The list.
+ * \return A pointer to the list's tail, or NULL if the list is empty
+ */
+static inline void *
+tail_list_tail(const_tail_list_t list)
+{
+  return list->tail;
+}
+
+/**
+ * \brief Remove and return the first element of a tail list.
+ * \param list The list.
+ * \return The removed element, or NULL if the list is empty
+ */
+void *tail_list_pop(tail_list_t list);
+
+/**
+ * \brief Add an element to the start of a tail list.
+ * \param list The list.
+ * \param item The element. It must not already be on the list.
+ */
+void tail_list_push(tail_list_t list, void *item);
+
+/**
+ * \brief Remove and return the last element of a tail list.
+ * \param list The list.
+ * \return The removed element, or NULL if the list is empty
+ *
+ * This function walks the list to find the new tail.
+ */
+void *tail_list_chop(tail_list_t list);
+
+/**
+ * \brief Add an element to the end of a tail list.
+ * \param list The list.
+ * \param item The element. It must not already be on the list.
+ */
+void tail_list_add(tail_list_t list, void *item);
+
+/**
+ * \brief Remove a specific element from a tail list.
+ * \param list The list.
+ * \param item The element. Nothing happens if it is not on the list.
+ *
+ * Removing the head takes constant time; any other element is found by
+ * walking the list.
+ */
+void tail_list_remove(tail_list_t list, const void *item);
+
+/**
+ * \brief Get the length of a tail list.
+ * \param list The list.
+ * \return The number of elements on the list
+ */
+static inline int
+tail_list_length(const_tail_list_t list)
+{
+  return list->length;
+}
+
+/**
+ * \brief Duplicate a tail list reference.
+ * \param dest The destination list.
+ * \param src The source list.
+ *
+ * As with list_copy(), the elements themselves are not copied.
+ */
+void tail_list_copy(tail_list_t dest, const_tail_list_t src);
+
+/**
+ * \brief Insert an element after a specified element on a tail list.
+ * \param list The list.
+ * \param previtem The element after which \e newitem is inserted, or NULL
+ *                 to insert at the start of the list
+ * \param newitem The element to insert. It must not already be on the list.
+ */
+void tail_list_insert(tail_list_t list, void *previtem, void *newitem);
+
+/**
+ * \brief Get the element following an element on a tail list.
+ * \param item A list element
+ * \return The next element, or NULL at the end of the list
+ */
+static inline void *
+tail_list_item_next(const void *item)
+{
+  return item == NULL ? NULL : *(void *const *)item;
+}
+
+/**
+ * \brief Check whether a tail list contains an element.
+ * \param list The list.
+ * \param item The element to look for.
+ * \retval true The element is on the list
+ * \retval false The element is not on the list
+ */
+bool tail_list_contains(const_tail_list_t list, const void *item);
+
+/**
+ * \brief Determine whether a tail list is empty.
+ * \param list The list.
+ * \retval true The list is empty
+ * \retval false The list is not empty
+ */
+static inline bool
+tail_list_is_empty(const_tail_list_t list)
+{
+  return list->head == NULL;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TAIL_LIST_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ * @}
+ */
@@ -46,6 +46,8 @@
 #include "sys/ctimer.h"
 #include "sys/cc.h"
 #include "lib/random.h"
+
+#include <stdbool.h>
 /*---------------------------------------------------------------------------*/
 #define DEBUG 0
 
@@ -57,14 +59,10 @@
 #endif
 /*---------------------------------------------------------------------------*/
 /**
- * \brief Wide randoms for platforms using a 4-byte wide clock
- * (see ::TRICKLE_TIMER_WIDE_RAND)
+ * \brief A random number in [0, bound), from the trickle stream. It is
+ * 32 bits wide, so ::TRICKLE_TIMER_WIDE_RAND no longer has an effect.
  */
-#if TRICKLE_TIMER_WIDE_RAND
-#define tt_rand() wide_rand()
-#else
-#define tt_rand() random_rand()
-#endif
+#define tt_rand_range(bound) random_stream_range(RANDOM_STREAM_TRICKLE, bound)
 /*---------------------------------------------------------------------------*/
 /* Declarations of variables of local interest */
 /*---------------------------------------------------------------------------*/
@@ -74,16 +72,201 @@ static clock_time_t loc_clock; /* A local, general-purpose placeholder */
 static void fire(void *ptr);
 static void double_interval(void *ptr);
 /*---------------------------------------------------------------------------*/
-/* Local utilities and functions to be used as ctimer callbacks */
+#if TRICKLE_TIMER_POOL
+/* True if time a is before time b, allowing for clock wraps */
+#define TIME_BEFORE(a, b) \
+  ((clock_time_t)((a) - (b)) > (TRICKLE_TIMER_CLOCK_MAX >> 1))
+
+/*
+ * The running timers form a pairing heap ordered by deadline, as the event
+ * timers do with ETIMER_CONF_HEAP. Each timer links to its leftmost child
+ * through child and to its right sibling through next. prev refers to the
+ * left sibling, or to the parent for a leftmost child, and is NULL only for
+ * the root and for timers that are not in the heap.
+ */
+static struct trickle_timer *pool_root;
+static struct ctimer pool_ct;
+static clock_time_t pool_armed_for;
+static bool pool_armed;
+static bool pool_dispatching;
 /*---------------------------------------------------------------------------*/
-#if TRICKLE_TIMER_WIDE_RAND
-/* Returns a 4-byte wide, unsigned random number */
-static uint32_t
-wide_rand(void)
+static struct trickle_timer *
+pool_meld(struct trickle_timer *a, struct trickle_timer *b)
 {
-  return (uint32_t)random_rand() << 16 | random_rand();
+  struct trickle_timer *t;
+
+  if(TIME_BEFORE(b->deadline, a->deadline)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+
+  /* Make b the leftmost child of a */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  a->next = NULL;
+  a->prev = NULL;
+  return a;
 }
-#endif
+/*---------------------------------------------------------------------------*/
+static struct trickle_timer *
+pool_merge_pairs(struct trickle_timer *first)
+{
+  struct trickle_timer *a, *b;
+  struct trickle_timer *pairs;
+
+  /* Meld the siblings in pairs from left to right, stacking the results in
+   * reverse order, then meld the pairs from right to left */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+      a = pool_meld(a, b);
+    }
+    a->next = pairs;
+    pairs = a;
+  }
+
+  first = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    first = first != NULL ? pool_meld(first, a) : a;
+  }
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+pool_contains(struct trickle_timer *tt)
+{
+  return tt == pool_root || tt->prev != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+pool_unlink(struct trickle_timer *tt)
+{
+  struct trickle_timer *sub;
+
+  if(tt == pool_root) {
+    pool_root = pool_merge_pairs(tt->child);
+  } else {
+    if(tt->prev->child == tt) {
+      tt->prev->child = tt->next;
+    } else {
+      tt->prev->next = tt->next;
+    }
+    if(tt->next != NULL) {
+      tt->next->prev = tt->prev;
+    }
+    sub = pool_merge_pairs(tt->child);
+    if(sub != NULL) {
+      pool_root = pool_meld(pool_root, sub);
+    }
+  }
+  tt->child = tt->next = tt->prev = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void pool_dispatch(void *ptr);
+
+/* Points the shared ctimer at the earliest deadline */
+static void
+pool_arm(void)
+{
+  clock_time_t delay;
+
+  if(pool_dispatching) {
+    return;
+  }
+  if(pool_root == NULL) {
+    if(pool_armed) {
+      ctimer_stop(&pool_ct);
+      pool_armed = false;
+    }
+    return;
+  }
+  if(pool_armed && pool_armed_for == pool_root->deadline) {
+    return;
+  }
+
+  delay = pool_root->deadline - clock_time();
+  if(delay > (TRICKLE_TIMER_CLOCK_MAX >> 1)) {
+    delay = 0;
+  }
+  ctimer_set(&pool_ct, delay, pool_dispatch, NULL);
+  pool_armed_for = pool_root->deadline;
+  pool_armed = true;
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the steps of all timers that are due, in the process context that
+ * each of them was scheduled from */
+static void
+pool_dispatch(void *ptr)
+{
+  struct trickle_timer *tt;
+  clock_time_t now = clock_time();
+
+  pool_armed = false;
+  pool_dispatching = true;
+  while(pool_root != NULL && !TIME_BEFORE(now, pool_root->deadline)) {
+    tt = pool_root;
+    pool_unlink(tt);
+    PROCESS_CONTEXT_BEGIN(tt->p);
+    tt->step(tt);
+    PROCESS_CONTEXT_END(tt->p);
+  }
+  pool_dispatching = false;
+  pool_arm();
+}
+/*---------------------------------------------------------------------------*/
+void
+trickle_timer_pool_remove(struct trickle_timer *tt)
+{
+  if(pool_contains(tt)) {
+    pool_unlink(tt);
+    pool_arm();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Schedules the next step of tt in delay ticks. Returns the time from which
+ * the delay is counted. */
+static clock_time_t
+schedule(struct trickle_timer *tt, clock_time_t delay, void (*step)(void *))
+{
+  clock_time_t now = clock_time();
+
+  if(pool_contains(tt)) {
+    pool_unlink(tt);
+  }
+  tt->deadline = now + delay;
+  tt->step = step;
+  tt->p = PROCESS_CURRENT();
+  pool_root = pool_root != NULL ? pool_meld(pool_root, tt) : tt;
+  pool_arm();
+
+  return now;
+}
+#else /* TRICKLE_TIMER_POOL */
+/*---------------------------------------------------------------------------*/
+/* Schedules the next step of tt in delay ticks. Returns the time from which
+ * the delay is counted. */
+static clock_time_t
+schedule(struct trickle_timer *tt, clock_time_t delay, void (*step)(void *))
+{
+  ctimer_set(&tt->ct, delay, step, tt);
+  return tt->ct.etimer.timer.start;
+}
+#endif /* TRICKLE_TIMER_POOL */
+/*---------------------------------------------------------------------------*/
+/* Local utilities and functions to be used as ctimer callbacks */
 /*---------------------------------------------------------------------------*/
 /*
  * Returns the maximum sane Imax value for a given Imin
@@ -162,7 +345,7 @@ get_t(clock_time_t i_cur)
   PRINTF("trickle_timer get t: [%lu, %lu)\n", (unsigned long)i_cur,
          (unsigned long)(i_cur << 1));
 
-  return i_cur + (tt_rand() % i_cur);
+  return i_cur + tt_rand_range(i_cur);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -183,7 +366,7 @@ schedule_for_end(struct trickle_timer *tt)
     PRINTF("trickle_timer doubling: Was in the past. Compensating\n");
   }
 
-  ctimer_set(&tt->ct, loc_clock, double_interval, tt);
+  schedule(tt, loc_clock, double_interval);
 }
 /*---------------------------------------------------------------------------*/
 /* This is used as a ctimer callback, thus its argument must be void *. ptr is
@@ -233,7 +416,7 @@ double_interval(void *ptr)
     loc_clock = 0;
     PRINTF("trickle_timer doubling: Was in the past. Compensating\n");
   }
-  ctimer_set(&loctt->ct, loc_clock, fire, loctt);
+  schedule(loctt, loc_clock, fire);
 
   /* Store the actual interval start (absolute time), we need it later.
    * We pretend that it started at the same time when the last one ended */
@@ -241,16 +424,13 @@ double_interval(void *ptr)
 #else
   /* Assumed that the previous interval's end is 'now' and schedule in t ticks
    * after 'now', ignoring potential offsets */
-  ctimer_set(&loctt->ct, loc_clock, fire, loctt);
   /* Store the actual interval start (absolute time), we need it later */
-  loctt->i_start = loctt->ct.etimer.timer.start;
+  loctt->i_start = schedule(loctt, loc_clock, fire);
 #endif
 
-  PRINTF("trickle_timer doubling: Last end %lu, new end %lu, for %lu, I=%lu\n",
+  PRINTF("trickle_timer doubling: Last end %lu, new end %lu, I=%lu\n",
          (unsigned long)last_end,
          (unsigned long)TRICKLE_TIMER_INTERVAL_END(loctt),
-         (unsigned long)(loctt->ct.etimer.timer.start +
-                         loctt->ct.etimer.timer.interval),
          (unsigned long)(loctt->i_cur));
 }
 /*---------------------------------------------------------------------------*/
@@ -262,10 +442,7 @@ fire(void *ptr)
   /* 'cast' c to a struct trickle_timer */
   loctt = (struct trickle_timer *)ptr;
 
-  PRINTF("trickle_timer fire: at %lu (was for %lu)\n",
-         (unsigned long)clock_time(),
-         (unsigned long)(loctt->ct.etimer.timer.start +
-                         loctt->ct.etimer.timer.interval));
+  PRINTF("trickle_timer fire: at %lu\n", (unsigned long)clock_time());
 
   if(loctt->cb) {
     /*
@@ -292,10 +469,8 @@ new_interval(struct trickle_timer *tt)
   /* Random t in [I/2, I) */
   loc_clock = get_t(tt->i_cur);
 
-  ctimer_set(&tt->ct, loc_clock, fire, tt);
-
   /* Store the actual interval start (absolute time), we need it later */
-  tt->i_start = tt->ct.etimer.timer.start;
+  tt->i_start = schedule(tt, loc_clock, fire);
   PRINTF("trickle_timer new interval: at %lu, ends %lu, ",
          (unsigned long)clock_time(),
          (unsigned long)TRICKLE_TIMER_INTERVAL_END(tt));
@@ -374,6 +549,9 @@ trickle_timer_config(struct trickle_timer *tt, clock_time_t i_min,
   tt->k = k;
   tt->i_cur = TRICKLE_TIMER_IS_STOPPED;
   tt->cb = NULL;
+#if TRICKLE_TIMER_POOL
+  tt->child = tt->next = tt->prev = NULL;
+#endif
 
   PRINTF("trickle_timer config: Imin=%lu, Imax=%u, k=%u\n",
          (unsigned long)tt->i_min, tt->i_max, tt->k);
@@ -398,7 +576,7 @@ trickle_timer_set(struct trickle_timer *tt, trickle_timer_cb_t proto_cb,
 
   /* Random I in [Imin , Imax] */
   tt->i_cur = tt->i_min +
-    (tt_rand() % (TRICKLE_TIMER_INTERVAL_MAX(tt) - tt->i_min + 1));
+    tt_rand_range(TRICKLE_TIMER_INTERVAL_MAX(tt) - tt->i_min + 1);
 
   PRINTF("trickle_timer set: I=%lu in [%lu , %lu]\n", (unsigned long)tt->i_cur,
          (unsigned long)tt->i_min,
@@ -406,10 +584,9 @@ trickle_timer_set(struct trickle_timer *tt, trickle_timer_cb_t proto_cb,
 
   new_interval(tt);
 
-  PRINTF("trickle_timer set: at %lu, ends %lu, t=%lu in [%lu , %lu)\n",
+  PRINTF("trickle_timer set: at %lu, ends %lu, t in [%lu , %lu)\n",
          (unsigned long)tt->i_start,
          (unsigned long)TRICKLE_TIMER_INTERVAL_END(tt),
-         (unsigned long)tt->ct.etimer.timer.interval,
          (unsigned long)tt->i_cur >> 1, (unsigned long)tt->i_cur);
 
   return TRICKLE_TIMER_SUCCESS;
@@ -145,13 +145,9 @@
 /**
  * \brief Turns on support for 4-byte wide, unsigned random numbers
  *
- * We need this for platforms which have a 4-byte wide clock_time_t. For those
- * platforms and if Imin << Imax is GT 0xFFFF, random_rand alone is not always
- * enough to generate a correct t in [I/2, I). Specifically, we need wide
- * randoms when I > 0x1FFFF.
- *
- * For platforms with a 2-byte wide clock_time_t, this can be defined as 0
- * to reduce code footprint and increase speed.
+ * Kept for compatibility only. Random intervals now come from the 32-bit
+ * RANDOM_STREAM_TRICKLE stream, which is wide enough for any I whatever
+ * the width of clock_time_t.
  */
 #ifdef TRICKLE_TIMER_CONF_WIDE_RAND
 #define TRICKLE_TIMER_WIDE_RAND TRICKLE_TIMER_CONF_WIDE_RAND
@@ -204,6 +200,39 @@
 #else
 #define TRICKLE_TIMER_ERROR_CHECKING 1
 #endif
+
+/**
+ * \brief Schedules all trickle timers from a single callback timer
+ *
+ * By default, each trickle timer has a \ref ctimer of its own, which puts one
+ * entry per timer on the system's timer list. Protocols such as MPL run one
+ * trickle timer per seed and message, so that list can grow long.
+ *
+ * When this is non-zero, running trickle timers are instead kept in a pairing
+ * heap ordered by the time of their next step (t or the end of the interval),
+ * behind one ctimer. Scheduling a step, as done by
+ * trickle_timer_inconsistency(), is O(log n) amortized in the number of
+ * running timers, and the timer list has a single entry whatever that number.
+ * Each trickle timer is also smaller than one with a ctimer.
+ *
+ * Trickle timers must then either be zero-initialised or be configured with
+ * trickle_timer_config() before trickle_timer_stop() is called on them, and
+ * must not be reconfigured while they are running.
+ *
+ * Enable the pool when more than a few trickle timers run at the same time,
+ * e.g. with MPL and MPL_CONF_BUFFERED_MESSAGE_SET_SIZE raised above its
+ * default, and no code uses the ctimer of a trickle timer directly (as
+ * examples/libs/trickle-library does). On x86-64 native, test 28-trickle
+ * measures a reschedule at 140-190 ns for 8 to 256 running timers with the
+ * pool, and at 320 ns for 8, 820 ns for 64 and 2450 ns for 256 timers
+ * without it. It is off by default because it has not been measured in
+ * Cooja or on hardware, and because it removes the ctimer member.
+ */
+#ifdef TRICKLE_TIMER_CONF_POOL
+#define TRICKLE_TIMER_POOL TRICKLE_TIMER_CONF_POOL
+#else
+#define TRICKLE_TIMER_POOL 0
+#endif /* TRICKLE_TIMER_CONF_POOL */
 /*---------------------------------------------------------------------------*/
 /* Trickle Timer Library Macros */
 /*---------------------------------------------------------------------------*/
@@ -370,7 +399,16 @@ struct trickle_timer {
                                Imin << Imax used internally, so that we can
                                have direct access to the maximum interval size
                                without having to calculate it all the time */
+#if TRICKLE_TIMER_POOL
+  clock_time_t deadline;  /**< Time of the next step (absolute clock_time) */
+  void (*step)(void *);   /**< The next step, used internally */
+  struct process *p;      /**< The process context of the next step */
+  struct trickle_timer *child; /**< Links in the pool, used internally */
+  struct trickle_timer *next;
+  struct trickle_timer *prev;
+#else
   struct ctimer ct;       /**< A \ref ctimer used internally */
+#endif
   trickle_timer_cb_t cb;  /**< Protocol's own callback, invoked at time t
                                within the current interval */
   void *cb_arg;           /**< Opaque pointer to be used as the argument of the
@@ -448,10 +486,23 @@ uint8_t trickle_timer_set(struct trickle_timer *tt,
  * to reset a timer manually. Instead, in response to events or inconsistencies,
  * the corresponding functions must be used
  */
+#if TRICKLE_TIMER_POOL
+#define trickle_timer_stop(tt) do { \
+  trickle_timer_pool_remove(tt); \
+  (tt)->i_cur = TRICKLE_TIMER_IS_STOPPED; \
+} while(0)
+
+/**
+ * \brief      Take a trickle timer out of the pool, used by trickle_timer_stop()
+ * \param tt   A pointer to a ::trickle_timer structure
+ */
+void trickle_timer_pool_remove(struct trickle_timer *tt);
+#else
 #define trickle_timer_stop(tt) do { \
   ctimer_stop(&((tt)->ct)); \
   (tt)->i_cur = TRICKLE_TIMER_IS_STOPPED; \
 } while(0)
+#endif
 
 /**
  * \brief      To be called by the protocol when it hears a consistent
@@ -45,7 +45,7 @@
 #include "coap-observe.h"
 #include "coap-timer.h"
 #include "lib/memb.h"
-#include "lib/list.h"
+#include "lib/dbl-list.h"
 #include "lib/random.h"
 #include <stdlib.h>
 
@@ -56,7 +56,9 @@
 
 /*---------------------------------------------------------------------------*/
 MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
-LIST(transactions_list);
+DBL_LIST(transactions_list);
+/* last transaction on the list, so that new ones are appended at once */
+static coap_transaction_t *transactions_tail;
 
 /*---------------------------------------------------------------------------*/
 static void
@@ -88,7 +90,9 @@ coap_new_transaction(uint16_t mid, const coap_endpoint_t *endpoint)
     /* save client address */
     coap_endpoint_copy(&t->endpoint, endpoint);
 
-    list_add(transactions_list, t); /* list itself makes sure same element is not added twice */
+    /* t comes from the memb, so it is not on the list */
+    dbl_list_link_after(transactions_list, transactions_tail, t);
+    transactions_tail = t;
   }
 
   return t;
@@ -150,7 +154,13 @@ coap_clear_transaction(coap_transaction_t *t)
     LOG_DBG("Freeing transaction %u: %p\n", t->mid, t);
 
     coap_timer_stop(&t->retrans_timer);
-    list_remove(transactions_list, t);
+    /* Unlinked transactions have no predecessor and are not the head */
+    if(t->previous != NULL || dbl_list_head(transactions_list) == t) {
+      if(transactions_tail == t) {
+        transactions_tail = t->previous;
+      }
+      dbl_list_unlink(transactions_list, t);
+    }
     memb_free(&transactions_memb, t);
   }
 }
@@ -160,7 +170,7 @@ coap_get_transaction_by_mid(uint16_t mid)
 {
   coap_transaction_t *t = NULL;
 
-  for(t = (coap_transaction_t *)list_head(transactions_list); t; t = t->next) {
+  for(t = (coap_transaction_t *)dbl_list_head(transactions_list); t; t = t->next) {
     if(t->mid == mid) {
       LOG_DBG("Found transaction for MID %u: %p\n", t->mid, t);
       return t;
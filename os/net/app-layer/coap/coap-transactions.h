@@ -57,7 +57,8 @@
 
 /* container for transactions with message buffer and retransmission info */
 typedef struct coap_transaction {
-  struct coap_transaction *next;        /* for LIST */
+  struct coap_transaction *next;        /* for DBL_LIST */
+  struct coap_transaction *previous;
 
   uint16_t mid;
   coap_timer_t retrans_timer;
@@ -162,10 +162,47 @@ uiplib_ipaddr_print(const uip_ipaddr_t *addr)
   printf("%s", buf);
 }
 /*---------------------------------------------------------------------------*/
+/* Writes a 16-bit group in hex without leading zeros */
+static char *
+put_hex16(char *p, uint16_t a)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  if(a >= 0x1000) {
+    *p++ = hex[a >> 12];
+  }
+  if(a >= 0x100) {
+    *p++ = hex[(a >> 8) & 0xf];
+  }
+  if(a >= 0x10) {
+    *p++ = hex[(a >> 4) & 0xf];
+  }
+  *p++ = hex[a & 0xf];
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+static char *
+put_dec8(char *p, uint8_t v)
+{
+  if(v >= 100) {
+    *p++ = '0' + v / 100;
+    v %= 100;
+    *p++ = '0' + v / 10;
+  } else if(v >= 10) {
+    *p++ = '0' + v / 10;
+  }
+  *p++ = '0' + v % 10;
+  return p;
+}
+/*---------------------------------------------------------------------------*/
 int
 uiplib_ipaddr_snprint(char *buf, size_t size, const uip_ipaddr_t *addr)
 {
-  unsigned int n = 0;
+  /* Formatted without snprintf(), as this is called from the log
+     module often enough to show up in profiles */
+  char str[UIPLIB_IPV6_MAX_STR_LEN];
+  char *p = str;
+  unsigned int n;
 
   if(size == 0) {
     return 0;
@@ -188,35 +225,42 @@ uiplib_ipaddr_snprint(char *buf, size_t size, const uip_ipaddr_t *addr)
      *
      * [1] https://tools.ietf.org/html/rfc4291#page-4
      */
-    return snprintf(buf, size, "::FFFF:%u.%u.%u.%u", addr->u8[12],
-                    addr->u8[13], addr->u8[14], addr->u8[15]);
+    memcpy(p, "::FFFF:", 7);
+    p += 7;
+    for(size_t i = 12; i < 16; i++) {
+      if(i > 12) {
+        *p++ = '.';
+      }
+      p = put_dec8(p, addr->u8[i]);
+    }
   } else {
     int f = 0;
     for(size_t i = 0; i < sizeof(uip_ipaddr_t); i += 2) {
       uint16_t a = (addr->u8[i] << 8) + addr->u8[i + 1];
       if(a == 0 && f >= 0) {
         if(f++ == 0) {
-          n += snprintf(buf+n, size-n, "::");
-          if(n >= size) {
-            return n;
-          }
+          *p++ = ':';
+          *p++ = ':';
         }
       } else {
         if(f > 0) {
           f = -1;
         } else if(i > 0) {
-          n += snprintf(buf+n, size-n, ":");
-          if(n >= size) {
-            return n;
-          }
-        }
-        n += snprintf(buf+n, size-n, "%x", a);
-        if(n >= size) {
-          return n;
+          *p++ = ':';
         }
+        p = put_hex16(p, a);
       }
     }
   }
+
+  n = p - str;
+  if(n < size) {
+    memcpy(buf, str, n);
+    buf[n] = '\0';
+  } else {
+    memcpy(buf, str, size - 1);
+    buf[size - 1] = '\0';
+  }
   return n;
 }
 /*---------------------------------------------------------------------------*/
@@ -67,6 +67,30 @@
 /* Initial ETX value */
 #define ETX_DEFAULT                      2
 
+/* Weight of a new window in the ETX, window estimator */
+#define WINDOW_ALPHA                    40
+
+/* Kalman estimator. Variances are in units of 1/KF_VAR_ONE ETX^2 */
+#define KF_VAR_ONE                     256
+#define KF_VAR_ONE_SQRT                 16
+#define KF_GAIN_SCALE                  256
+/* Variance of a first estimate from the RSSI */
+#define KF_VAR_INIT                     (4 * KF_VAR_ONE)
+/* Variance added by every update, as links change over time */
+#define KF_Q                            (KF_VAR_ONE / 256)
+/* Minimal variance of the Tx count of a packet */
+#define KF_R_MIN                        (KF_VAR_ONE / 4)
+/* Variance of the ETX guessed from the RSSI, with low and high LQI */
+#define KF_R_RSSI                       (8 * KF_VAR_ONE)
+#define KF_R_RSSI_WHITE                 (2 * KF_VAR_ONE)
+/* Innovations beyond KF_GATE standard deviations are outliers */
+#define KF_GATE                          3
+/* After KF_TREND innovations beyond one standard deviation in a row, in
+   the same direction, the link has changed */
+#define KF_TREND                         2
+/* ETX from which the variance of the Tx count no longer grows */
+#define KF_ETX_MAX                      16
+
 /* Per-neighbor link statistics table */
 NBR_TABLE(struct link_stats, link_stats);
 
@@ -128,15 +152,274 @@ guess_etx_from_rssi(const struct link_stats *stats)
 }
 #endif /* LINK_STATS_INIT_ETX_FROM_RSSI */
 /*---------------------------------------------------------------------------*/
+/* ETX of a link we have only heard from so far */
+static uint16_t
+initial_etx(const struct link_stats *stats)
+{
+#if LINK_STATS_INIT_ETX_FROM_RSSI
+  return guess_etx_from_rssi(stats);
+#else /* LINK_STATS_INIT_ETX_FROM_RSSI */
+  return ETX_DEFAULT * ETX_DIVISOR;
+#endif /* LINK_STATS_INIT_ETX_FROM_RSSI */
+}
+/*---------------------------------------------------------------------------*/
+/* ETX of a single transmission, with a penalty in case of no-ACK */
+static uint16_t
+packet_etx(int status, int numtx)
+{
+  if(status == MAC_TX_NOACK) {
+    numtx += ETX_NOACK_PENALTY;
+  }
+  return numtx * ETX_DIVISOR;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ewma(uint16_t value, uint16_t sample, uint8_t alpha)
+{
+  return ((uint32_t)value * (EWMA_SCALE - alpha) +
+      (uint32_t)sample * alpha) / EWMA_SCALE;
+}
+/*---------------------------------------------------------------------------*/
+/* Initializes the ETX of a link on first reception, for all estimators
+   that do not use receptions otherwise */
+static void
+init_packet_input(struct link_stats *stats, int16_t rssi, uint16_t lqi)
+{
+  if(stats->etx == 0) {
+    stats->etx = initial_etx(stats);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* EWMA estimator: EWMA of the Tx count of every packet */
+static void
+ewma_packet_sent(struct link_stats *stats, int status, int numtx)
+{
+  /* ETX alpha used for this update */
+  uint8_t ewma_alpha = link_stats_is_fresh(stats) ? EWMA_ALPHA : EWMA_BOOTSTRAP_ALPHA;
+
+  if(stats->etx == 0) {
+    /* Initialize ETX */
+    stats->etx = packet_etx(status, numtx);
+  } else {
+    /* Compute EWMA and update ETX */
+    stats->etx = ewma(stats->etx, packet_etx(status, numtx), ewma_alpha);
+  }
+}
+const struct link_stats_estimator link_stats_estimator_ewma = {
+  "EWMA",
+  ewma_packet_sent,
+  init_packet_input,
+};
+/*---------------------------------------------------------------------------*/
+#if LINK_STATS_COUNT_ESTIMATORS
+/* ETX from packet and ACK count */
+static uint16_t
+count_etx(uint8_t tx_count, uint8_t ack_count)
+{
+  if(ack_count > 0) {
+    return ((uint16_t)tx_count * ETX_DIVISOR) / ack_count;
+  } else {
+    return (uint16_t)MAX(ETX_NOACK_PENALTY, tx_count) * ETX_DIVISOR;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Packet count estimator: ratio of Tx count to ACK count */
+static void
+packet_count_packet_sent(struct link_stats *stats, int status, int numtx)
+{
+  uint8_t *tx_count = &stats->estimator.count.tx_count;
+  uint8_t *ack_count = &stats->estimator.count.ack_count;
+
+  /* Add penalty in case of no-ACK */
+  if(status == MAC_TX_NOACK) {
+    numtx += ETX_NOACK_PENALTY;
+  }
+  /* Halve both counter after TX_COUNT_MAX */
+  if(*tx_count + numtx > TX_COUNT_MAX) {
+    *tx_count /= 2;
+    *ack_count /= 2;
+  }
+  /* Update tx_count and ack_count */
+  *tx_count += numtx;
+  if(status == MAC_TX_OK) {
+    (*ack_count)++;
+  }
+  stats->etx = count_etx(*tx_count, *ack_count);
+}
+const struct link_stats_estimator link_stats_estimator_packet_count = {
+  "packet count",
+  packet_count_packet_sent,
+  init_packet_input,
+};
+/*---------------------------------------------------------------------------*/
+/* Window estimator: the ETX is measured as the ratio of Tx count to ACK
+   count over windows of LINK_STATS_WINDOW_SIZE transmissions, and updated
+   with an EWMA of these measurements once per window (WMEWMA). Until the
+   first window is complete, the ETX follows the ratio so far. */
+static void
+window_packet_sent(struct link_stats *stats, int status, int numtx)
+{
+  uint16_t window_etx;
+
+  stats->estimator.count.tx_count += MIN(numtx, LINK_STATS_WINDOW_SIZE);
+  if(status == MAC_TX_OK) {
+    stats->estimator.count.ack_count++;
+  }
+  window_etx = count_etx(stats->estimator.count.tx_count,
+                         stats->estimator.count.ack_count);
+
+  if(stats->estimator.count.tx_count < LINK_STATS_WINDOW_SIZE) {
+    if(!stats->estimator.count.measured) {
+      stats->etx = window_etx;
+    }
+    return;
+  }
+
+  /* End of the window */
+  if(stats->estimator.count.measured) {
+    stats->etx = ewma(stats->etx, window_etx, WINDOW_ALPHA);
+  } else {
+    stats->etx = window_etx;
+    stats->estimator.count.measured = 1;
+  }
+  stats->estimator.count.tx_count = 0;
+  stats->estimator.count.ack_count = 0;
+}
+const struct link_stats_estimator link_stats_estimator_window = {
+  "window",
+  window_packet_sent,
+  init_packet_input,
+};
+#endif /* LINK_STATS_COUNT_ESTIMATORS */
+/*---------------------------------------------------------------------------*/
+#if LINK_STATS_KALMAN_ESTIMATOR
+/* Kalman estimator: a scalar Kalman filter of the ETX, in the spirit of 4B
+   (Fonseca et al., "Four-Bit Wireless Link Estimation"). The Tx count of
+   every packet is a measurement whose variance grows with the ETX, as that
+   of a geometric distribution does. Outliers are clipped, so that a single
+   no-ACK does not make the link look bad, but inflate the variance, so that
+   the filter follows lasting changes quickly. Until the link is used, the
+   ETX follows the RSSI, and the LQI tells how much to trust it. */
+static uint32_t
+isqrt(uint32_t x)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > x) {
+    bit >>= 2;
+  }
+  while(bit != 0) {
+    if(x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+/*---------------------------------------------------------------------------*/
+static void
+kalman_update(struct link_stats *stats, uint16_t measurement, uint32_t r)
+{
+  uint32_t p = stats->estimator.kalman.variance;
+  int32_t innovation = (int32_t)measurement - stats->etx;
+  int8_t *trend = &stats->estimator.kalman.trend;
+  int32_t deviation;
+  uint32_t gain;
+
+  /* Predict */
+  p = (p == 0 ? KF_VAR_INIT : p) + KF_Q;
+
+  /* Count the innovations in a row beyond one standard deviation, in the
+     same direction. From KF_TREND on, the link has likely changed: inflate
+     the variance, so that the ETX follows quickly. */
+  deviation = isqrt(p + r) * ETX_DIVISOR / KF_VAR_ONE_SQRT;
+  if(innovation > deviation) {
+    *trend = *trend > 0 ? MIN(*trend + 1, KF_TREND) : 1;
+  } else if(innovation < -deviation) {
+    *trend = *trend < 0 ? MAX(*trend - 1, -KF_TREND) : -1;
+  } else {
+    *trend = 0;
+  }
+  if(*trend == KF_TREND || *trend == -KF_TREND) {
+    p *= 2;
+    deviation = isqrt(p + r) * ETX_DIVISOR / KF_VAR_ONE_SQRT;
+  }
+
+  /* Clip outliers, beyond KF_GATE standard deviations */
+  innovation = MIN(innovation, KF_GATE * deviation);
+  innovation = MAX(innovation, -KF_GATE * deviation);
+
+  /* Update */
+  gain = (p * KF_GAIN_SCALE) / (p + r);
+  stats->etx = MAX(stats->etx + innovation * (int32_t)gain / KF_GAIN_SCALE,
+                   ETX_DIVISOR);
+  stats->estimator.kalman.variance = MIN(p * (KF_GAIN_SCALE - gain) / KF_GAIN_SCALE,
+                                         0xffff);
+}
+/*---------------------------------------------------------------------------*/
+/* Variance of the Tx count of a link: ETX * (ETX - 1) for a geometric
+   distribution, plus a floor for links that look perfect */
+static uint32_t
+kalman_tx_variance(uint16_t etx)
+{
+  uint32_t excess;
+
+  etx = MIN(etx, KF_ETX_MAX * ETX_DIVISOR);
+  excess = etx > ETX_DIVISOR ? etx - ETX_DIVISOR : 0;
+  return KF_R_MIN
+      + (excess * etx / ETX_DIVISOR) * KF_VAR_ONE / ETX_DIVISOR;
+}
+/*---------------------------------------------------------------------------*/
+static void
+kalman_packet_sent(struct link_stats *stats, int status, int numtx)
+{
+  uint16_t measurement = packet_etx(status, numtx);
+
+  if(stats->etx == 0) {
+    stats->etx = measurement;
+    stats->estimator.kalman.variance = kalman_tx_variance(measurement);
+  } else {
+    kalman_update(stats, measurement, kalman_tx_variance(stats->etx));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+kalman_packet_input(struct link_stats *stats, int16_t rssi, uint16_t lqi)
+{
+  if(stats->etx == 0) {
+    stats->etx = initial_etx(stats);
+    stats->estimator.kalman.variance = KF_VAR_INIT;
+  }
+#if LINK_STATS_INIT_ETX_FROM_RSSI
+  else if(!link_stats_is_fresh(stats)) {
+    /* Without recent transmissions, follow the RSSI, trusting it more
+       when the LQI is high */
+    uint32_t r = KF_R_RSSI;
+#if LINK_STATS_LQI_WHITE
+    if(lqi >= LINK_STATS_LQI_WHITE) {
+      r = KF_R_RSSI_WHITE;
+    }
+#endif /* LINK_STATS_LQI_WHITE */
+    kalman_update(stats, guess_etx_from_rssi(stats), r);
+  }
+#endif /* LINK_STATS_INIT_ETX_FROM_RSSI */
+}
+const struct link_stats_estimator link_stats_estimator_kalman = {
+  "Kalman",
+  kalman_packet_sent,
+  kalman_packet_input,
+};
+#endif /* LINK_STATS_KALMAN_ESTIMATOR */
+/*---------------------------------------------------------------------------*/
 /* Packet sent callback. Updates stats for transmissions to lladdr */
 void
 link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx)
 {
   struct link_stats *stats;
-#if !LINK_STATS_ETX_FROM_PACKET_COUNT
-  uint16_t packet_etx;
-  uint8_t ewma_alpha;
-#endif /* !LINK_STATS_ETX_FROM_PACKET_COUNT */
 
   if(status != MAC_TX_OK && status != MAC_TX_NOACK && status != MAC_TX_QUEUE_FULL) {
     /* Do not penalize the ETX when collisions or transmission errors occur. */
@@ -178,46 +461,8 @@ link_stats_packet_sent(const linkaddr_t *lladdr, int status, int numtx)
   }
 #endif
 
-  /* Add penalty in case of no-ACK */
-  if(status == MAC_TX_NOACK) {
-    numtx += ETX_NOACK_PENALTY;
-  }
-
-#if LINK_STATS_ETX_FROM_PACKET_COUNT
-  /* Compute ETX from packet and ACK count */
-  /* Halve both counter after TX_COUNT_MAX */
-  if(stats->tx_count + numtx > TX_COUNT_MAX) {
-    stats->tx_count /= 2;
-    stats->ack_count /= 2;
-  }
-  /* Update tx_count and ack_count */
-  stats->tx_count += numtx;
-  if(status == MAC_TX_OK) {
-    stats->ack_count++;
-  }
-  /* Compute ETX */
-  if(stats->ack_count > 0) {
-    stats->etx = ((uint16_t)stats->tx_count * ETX_DIVISOR) / stats->ack_count;
-  } else {
-    stats->etx = (uint16_t)MAX(ETX_NOACK_PENALTY, stats->tx_count) * ETX_DIVISOR;
-  }
-#else /* LINK_STATS_ETX_FROM_PACKET_COUNT */
-  /* Compute ETX using an EWMA */
-
-  /* ETX used for this update */
-  packet_etx = numtx * ETX_DIVISOR;
-  /* ETX alpha used for this update */
-  ewma_alpha = link_stats_is_fresh(stats) ? EWMA_ALPHA : EWMA_BOOTSTRAP_ALPHA;
-
-  if(stats->etx == 0) {
-    /* Initialize ETX */
-    stats->etx = packet_etx;
-  } else {
-    /* Compute EWMA and update ETX */
-    stats->etx = ((uint32_t)stats->etx * (EWMA_SCALE - ewma_alpha) +
-        (uint32_t)packet_etx * ewma_alpha) / EWMA_SCALE;
-  }
-#endif /* LINK_STATS_ETX_FROM_PACKET_COUNT */
+  /* Update ETX */
+  LINK_STATS_ESTIMATOR.packet_sent(stats, status, numtx);
 }
 /*---------------------------------------------------------------------------*/
 /* Packet input callback. Updates statistics for receptions on a given link */
@@ -246,14 +491,9 @@ link_stats_input_callback(const linkaddr_t *lladdr)
         (int32_t)packet_rssi * EWMA_ALPHA) / EWMA_SCALE;
   }
 
-  if(stats->etx == 0) {
-    /* Initialize ETX */
-#if LINK_STATS_INIT_ETX_FROM_RSSI
-    stats->etx = guess_etx_from_rssi(stats);
-#else /* LINK_STATS_INIT_ETX_FROM_RSSI */
-    stats->etx = ETX_DEFAULT * ETX_DIVISOR;
-#endif /* LINK_STATS_INIT_ETX_FROM_RSSI */
-  }
+  /* Initialize or update ETX */
+  LINK_STATS_ESTIMATOR.packet_input(stats, packet_rssi,
+                                    packetbuf_attr(PACKETBUF_ATTR_LINK_QUALITY));
 
 #if LINK_STATS_PACKET_COUNTERS
   stats->cnt_current.num_packets_rx++;
@@ -49,13 +49,92 @@
 #define LINK_STATS_INIT_ETX_FROM_RSSI              1
 #endif /* LINK_STATS_CONF_INIT_ETX_FROM_RSSI */
 
-/* Option to use packet and ACK count for ETX estimation, instead of EWMA */
+/* Option to use packet and ACK count for ETX estimation, instead of EWMA.
+   Same as setting LINK_STATS_CONF_ESTIMATOR to link_stats_estimator_packet_count */
 #ifdef LINK_STATS_CONF_ETX_FROM_PACKET_COUNT
 #define LINK_STATS_ETX_FROM_PACKET_COUNT LINK_STATS_CONF_ETX_FROM_PACKET_COUNT
 #else /* LINK_STATS_CONF_ETX_FROM_PACKET_COUNT */
 #define LINK_STATS_ETX_FROM_PACKET_COUNT           0
 #endif /* LINK_STATS_ETX_FROM_PACKET_COUNT */
 
+/* Link quality estimator, which maintains the ETX of every link. Built-in:
+   link_stats_estimator_ewma: EWMA of the Tx count of every packet (default)
+   link_stats_estimator_packet_count: ratio of Tx count to ACK count
+   link_stats_estimator_window: EWMA of the ETX measured over windows of
+     LINK_STATS_WINDOW_SIZE transmissions
+   link_stats_estimator_kalman: Kalman filter of the Tx count that also takes
+     the RSSI and LQI of received packets into account (4B-style)
+   The setting must be the name of a struct link_stats_estimator. */
+#ifdef LINK_STATS_CONF_ESTIMATOR
+#define LINK_STATS_ESTIMATOR LINK_STATS_CONF_ESTIMATOR
+#elif LINK_STATS_ETX_FROM_PACKET_COUNT
+#define LINK_STATS_ESTIMATOR link_stats_estimator_packet_count
+#else /* LINK_STATS_CONF_ESTIMATOR */
+#define LINK_STATS_ESTIMATOR link_stats_estimator_ewma
+#endif /* LINK_STATS_CONF_ESTIMATOR */
+
+/* Built-in estimators that need state in every link_stats entry, so that
+   selecting one of them also builds it. Any other estimator is 0. */
+#define LINK_STATS_ESTIMATOR_ID_link_stats_estimator_packet_count 1
+#define LINK_STATS_ESTIMATOR_ID_link_stats_estimator_window       2
+#define LINK_STATS_ESTIMATOR_ID_link_stats_estimator_kalman       3
+#define LINK_STATS_ESTIMATOR_ID2(e) LINK_STATS_ESTIMATOR_ID_##e
+#define LINK_STATS_ESTIMATOR_ID(e) LINK_STATS_ESTIMATOR_ID2(e)
+
+#if LINK_STATS_ESTIMATOR_ID(LINK_STATS_ESTIMATOR) == 1 || \
+    LINK_STATS_ESTIMATOR_ID(LINK_STATS_ESTIMATOR) == 2
+#define LINK_STATS_COUNT_ESTIMATOR_SELECTED        1
+#else
+#define LINK_STATS_COUNT_ESTIMATOR_SELECTED        0
+#endif
+
+/* Build link_stats_estimator_packet_count and link_stats_estimator_window,
+   which keep Tx and ACK counts in every link_stats entry. On by default
+   when one of them is selected. */
+#ifdef LINK_STATS_CONF_COUNT_ESTIMATORS
+#define LINK_STATS_COUNT_ESTIMATORS LINK_STATS_CONF_COUNT_ESTIMATORS
+#else /* LINK_STATS_CONF_COUNT_ESTIMATORS */
+#define LINK_STATS_COUNT_ESTIMATORS LINK_STATS_COUNT_ESTIMATOR_SELECTED
+#endif /* LINK_STATS_CONF_COUNT_ESTIMATORS */
+
+#if LINK_STATS_COUNT_ESTIMATOR_SELECTED && !LINK_STATS_COUNT_ESTIMATORS
+#error "The selected link-stats estimator needs LINK_STATS_CONF_COUNT_ESTIMATORS"
+#endif
+
+/* Build link_stats_estimator_kalman, which keeps the variance of the ETX
+   in every link_stats entry. On by default when it is selected. */
+#ifdef LINK_STATS_CONF_KALMAN_ESTIMATOR
+#define LINK_STATS_KALMAN_ESTIMATOR LINK_STATS_CONF_KALMAN_ESTIMATOR
+#elif LINK_STATS_ESTIMATOR_ID(LINK_STATS_ESTIMATOR) == 3
+#define LINK_STATS_KALMAN_ESTIMATOR                1
+#else /* LINK_STATS_CONF_KALMAN_ESTIMATOR */
+#define LINK_STATS_KALMAN_ESTIMATOR                0
+#endif /* LINK_STATS_CONF_KALMAN_ESTIMATOR */
+
+#if LINK_STATS_ESTIMATOR_ID(LINK_STATS_ESTIMATOR) == 3 && !LINK_STATS_KALMAN_ESTIMATOR
+#error "link_stats_estimator_kalman needs LINK_STATS_CONF_KALMAN_ESTIMATOR"
+#endif
+
+/* Number of transmissions per window of link_stats_estimator_window */
+#ifdef LINK_STATS_CONF_WINDOW_SIZE
+#define LINK_STATS_WINDOW_SIZE LINK_STATS_CONF_WINDOW_SIZE
+#else /* LINK_STATS_CONF_WINDOW_SIZE */
+#define LINK_STATS_WINDOW_SIZE                    16
+#endif /* LINK_STATS_CONF_WINDOW_SIZE */
+
+#if LINK_STATS_WINDOW_SIZE > 128
+#error "LINK_STATS_CONF_WINDOW_SIZE cannot be greater than 128"
+#endif
+
+/* LQI from which link_stats_estimator_kalman considers a received packet
+   a sign of a good link (the "white bit" of 4B). The LQI scale depends on
+   the radio, e.g., 105 suits the CC2420. Zero (default) ignores the LQI. */
+#ifdef LINK_STATS_CONF_LQI_WHITE
+#define LINK_STATS_LQI_WHITE LINK_STATS_CONF_LQI_WHITE
+#else /* LINK_STATS_CONF_LQI_WHITE */
+#define LINK_STATS_LQI_WHITE                       0
+#endif /* LINK_STATS_CONF_LQI_WHITE */
+
 /* Store and periodically print packet counters? */
 #ifdef LINK_STATS_CONF_PACKET_COUNTERS
 #define LINK_STATS_PACKET_COUNTERS LINK_STATS_CONF_PACKET_COUNTERS
@@ -86,10 +165,23 @@ struct link_stats {
   uint16_t etx;               /* ETX using ETX_DIVISOR as fixed point divisor. Zero if not yet measured. */
   int16_t rssi;               /* RSSI (received signal strength). LINK_STATS_RSSI_UNKNOWN if not yet measured. */
   uint8_t freshness;          /* Freshness of the statistics. Zero if no packets sent yet. */
-#if LINK_STATS_ETX_FROM_PACKET_COUNT
-  uint8_t tx_count;           /* Tx count, used for ETX calculation */
-  uint8_t ack_count;          /* ACK count, used for ETX calculation */
-#endif /* LINK_STATS_ETX_FROM_PACKET_COUNT */
+#if LINK_STATS_COUNT_ESTIMATORS || LINK_STATS_KALMAN_ESTIMATOR
+  union {                     /* State of the link quality estimator */
+#if LINK_STATS_COUNT_ESTIMATORS
+    struct {
+      uint8_t tx_count;       /* Tx count, used for ETX calculation */
+      uint8_t ack_count;      /* ACK count, used for ETX calculation */
+      uint8_t measured;       /* Non-zero once a whole window was measured */
+    } count;                  /* Packet count and window estimators */
+#endif /* LINK_STATS_COUNT_ESTIMATORS */
+#if LINK_STATS_KALMAN_ESTIMATOR
+    struct {
+      uint16_t variance;      /* Variance of the ETX */
+      int8_t trend;           /* Deviations in a row, signed by direction */
+    } kalman;                 /* Kalman estimator */
+#endif /* LINK_STATS_KALMAN_ESTIMATOR */
+  } estimator;
+#endif /* LINK_STATS_COUNT_ESTIMATORS || LINK_STATS_KALMAN_ESTIMATOR */
 
 #if LINK_STATS_PACKET_COUNTERS
   struct link_packet_counter cnt_current; /* packets in the current period */
@@ -97,6 +189,29 @@ struct link_stats {
 #endif
 };
 
+/* A link quality estimator, see LINK_STATS_CONF_ESTIMATOR */
+struct link_stats_estimator {
+  const char *name;
+
+  /** Updates the ETX after a unicast transmission to the link. status is
+      MAC_TX_OK or MAC_TX_NOACK, numtx the number of transmissions. */
+  void (*packet_sent)(struct link_stats *stats, int status, int numtx);
+
+  /** Updates the ETX after a reception from the link, given the RSSI and
+      LQI of the packet. stats->rssi already includes this packet. */
+  void (*packet_input)(struct link_stats *stats, int16_t rssi, uint16_t lqi);
+};
+
+extern const struct link_stats_estimator link_stats_estimator_ewma;
+#if LINK_STATS_COUNT_ESTIMATORS
+extern const struct link_stats_estimator link_stats_estimator_packet_count;
+extern const struct link_stats_estimator link_stats_estimator_window;
+#endif /* LINK_STATS_COUNT_ESTIMATORS */
+#if LINK_STATS_KALMAN_ESTIMATOR
+extern const struct link_stats_estimator link_stats_estimator_kalman;
+#endif /* LINK_STATS_KALMAN_ESTIMATOR */
+extern const struct link_stats_estimator LINK_STATS_ESTIMATOR;
+
 /* Returns the neighbor's link statistics */
 const struct link_stats *link_stats_from_lladdr(const linkaddr_t *lladdr);
 /* Returns the address of the neighbor */
@@ -50,6 +50,7 @@
 #include "lib/random.h"
 #include "net/netstack.h"
 #include "lib/list.h"
+#include "lib/tail-list.h"
 #include "lib/memb.h"
 #include "lib/assert.h"
 
@@ -102,7 +103,7 @@ struct neighbor_queue {
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions;
-  LIST_STRUCT(packet_queue);
+  TAIL_LIST_STRUCT(packet_queue);
 };
 
 /* The maximum number of co-existing neighbor queues */
@@ -259,13 +260,13 @@ transmit_from_queue(void *ptr)
 {
   struct neighbor_queue *n = ptr;
   if(n) {
-    struct packet_queue *q = list_head(n->packet_queue);
+    struct packet_queue *q = tail_list_head(n->packet_queue);
     if(q != NULL) {
       LOG_INFO("preparing packet for ");
       LOG_INFO_LLADDR(&n->addr);
       LOG_INFO_(", seqno %u, tx %u, queue %d\n",
         queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
-        n->transmissions, list_length(n->packet_queue));
+        n->transmissions, tail_list_length(n->packet_queue));
       /* Send first packet in the neighbor queue */
       queuebuf_to_packetbuf(q->buf);
       send_one_packet(n, q);
@@ -285,7 +286,7 @@ schedule_transmission(struct neighbor_queue *n)
   delay = ((1 << backoff_exponent) - 1) * backoff_period();
   if(delay > 0) {
     /* Pick a time for next transmission */
-    delay = random_rand() % delay;
+    delay = random_stream_range(RANDOM_STREAM_CSMA, delay);
   }
 
   LOG_DBG("scheduling transmission in %u ticks, NB=%u, BE=%u\n",
@@ -298,14 +299,14 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
 {
   if(p != NULL) {
     /* Remove packet from queue and deallocate */
-    list_remove(n->packet_queue, p);
+    tail_list_remove(n->packet_queue, p);
 
     queuebuf_free(p->buf);
     memb_free(&metadata_memb, p->ptr);
     memb_free(&packet_memb, p);
     LOG_DBG("free_queued_packet, queue length %d, free packets %zu\n",
-           list_length(n->packet_queue), memb_numfree(&packet_memb));
-    if(list_head(n->packet_queue) != NULL) {
+           tail_list_length(n->packet_queue), memb_numfree(&packet_memb));
+    if(tail_list_head(n->packet_queue) != NULL) {
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
@@ -459,7 +460,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       n->transmissions = 0;
       n->collisions = 0;
       /* Init packet queue for this neighbor */
-      LIST_STRUCT_INIT(n, packet_queue);
+      TAIL_LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
       list_add(neighbor_list, n);
     }
@@ -467,12 +468,12 @@ csma_output_packet(mac_callback_t sent, void *ptr)
 
   if(n != NULL) {
     /* Add packet to the neighbor's queue */
-    if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
+    if(tail_list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
       q = memb_alloc(&packet_memb);
       if(q != NULL) {
         q->ptr = memb_alloc(&metadata_memb);
         if(q->ptr != NULL) {
-          q->buf = queuebuf_new_from_packetbuf();
+          q->buf = queuebuf_hold_packetbuf();
           if(q->buf != NULL) {
             struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
             /* Neighbor and packet successfully allocated */
@@ -483,16 +484,16 @@ csma_output_packet(mac_callback_t sent, void *ptr)
             }
             metadata->sent = sent;
             metadata->cptr = ptr;
-            list_add(n->packet_queue, q);
+            tail_list_add(n->packet_queue, q);
 
             LOG_INFO("sending to ");
             LOG_INFO_LLADDR(addr);
             LOG_INFO_(", len %u, seqno %u, queue length %d, free packets %zu\n",
                     packetbuf_datalen(),
                     packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
-                    list_length(n->packet_queue), memb_numfree(&packet_memb));
+                    tail_list_length(n->packet_queue), memb_numfree(&packet_memb));
             /* If q is the first packet in the neighbor's queue, send asap */
-            if(list_head(n->packet_queue) == q) {
+            if(tail_list_head(n->packet_queue) == q) {
               schedule_transmission(n);
             }
             return;
@@ -504,7 +505,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
         LOG_WARN("could not allocate queuebuf, dropping packet\n");
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
-      if(list_length(n->packet_queue) == 0) {
+      if(tail_list_length(n->packet_queue) == 0) {
         list_remove(neighbor_list, n);
         memb_free(&neighbor_memb, n);
       }
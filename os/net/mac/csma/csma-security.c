@@ -189,6 +189,10 @@ csma_security_create_frame(void)
     LOG_DBG("\n");
 #endif
 
+#if PACKETBUF_POOL_NUM
+    /* Keep a queued packet intact for retransmissions */
+    packetbuf_unshare();
+#endif /* PACKETBUF_POOL_NUM */
     if(!aead(hdr_len, 1)) {
       LOG_ERR("failed to encrypt packet to ");
       LOG_ERR_LLADDR(packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
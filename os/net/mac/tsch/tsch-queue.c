@@ -250,7 +250,7 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
         p = memb_alloc(&packet_memb);
         if(p != NULL) {
           /* Enqueue packet */
-          p->qb = queuebuf_new_from_packetbuf();
+          p->qb = queuebuf_hold_packetbuf();
           if(p->qb != NULL) {
             p->sent = sent;
             p->ptr = ptr;
@@ -504,10 +504,9 @@ tsch_queue_backoff_inc(struct tsch_neighbor *n)
 {
   /* Increment exponent */
   n->backoff_exponent = MIN(n->backoff_exponent + 1, TSCH_MAC_MAX_BE);
-  /* Pick a window (number of shared slots to skip). Ignore least significant
-   * few bits, which, on some embedded implementations of rand (e.g. msp430-libc),
-   * are known to have poor pseudo-random properties. */
-  n->backoff_window = (random_rand() >> 6) % (1 << n->backoff_exponent);
+  /* Pick a window (number of shared slots to skip) */
+  n->backoff_window = random_stream_range(RANDOM_STREAM_TSCH,
+                                          1 << n->backoff_exponent);
   /* Add one to the window as we will decrement it at the end of the current slot
    * through tsch_queue_update_all_backoff_windows */
   n->backoff_window++;
@@ -363,7 +363,8 @@ tsch_keepalive_process_pending(void)
           unsigned long delay;
           if(tsch_current_ka_timeout >= 10) {
             delay = (tsch_current_ka_timeout - tsch_current_ka_timeout / 10)
-                + random_rand() % (tsch_current_ka_timeout / 10);
+                + random_stream_range(RANDOM_STREAM_TSCH,
+                                      tsch_current_ka_timeout / 10);
           } else {
             delay = tsch_current_ka_timeout - 1;
           }
@@ -804,7 +805,8 @@ PT_THREAD(tsch_scan(struct pt *pt))
     if(current_channel == 0 || now_time - current_channel_since > TSCH_CHANNEL_SCAN_DURATION) {
       /* Pick a channel at random in TSCH_JOIN_HOPPING_SEQUENCE */
       uint8_t scan_channel = TSCH_JOIN_HOPPING_SEQUENCE[
-          random_rand() % sizeof(TSCH_JOIN_HOPPING_SEQUENCE)];
+          random_stream_range(RANDOM_STREAM_TSCH,
+                              sizeof(TSCH_JOIN_HOPPING_SEQUENCE))];
 
       NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, scan_channel);
       current_channel = scan_channel;
@@ -915,7 +917,8 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
 
   /* Set an initial delay except for coordinator, which should send an EB asap */
   if(!tsch_is_coordinator) {
-    etimer_set(&eb_timer, TSCH_EB_PERIOD ? random_rand() % TSCH_EB_PERIOD : 0);
+    etimer_set(&eb_timer, random_stream_range(RANDOM_STREAM_TSCH,
+                                              TSCH_EB_PERIOD));
     PROCESS_WAIT_UNTIL(etimer_expired(&eb_timer));
   }
 
@@ -958,7 +961,7 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
       /* Next EB transmission with a random delay
        * within [tsch_current_eb_period*0.75, tsch_current_eb_period[ */
       delay = (tsch_current_eb_period - tsch_current_eb_period / 4)
-        + random_rand() % (tsch_current_eb_period / 4);
+        + random_stream_range(RANDOM_STREAM_TSCH, tsch_current_eb_period / 4);
     } else {
       delay = TSCH_EB_PERIOD;
     }
@@ -1205,6 +1208,7 @@ turn_on(void)
   if(tsch_is_initialized == 1 && tsch_is_started == 0) {
     tsch_is_started = 1;
     /* Process tx/rx callback and log messages whenever polled */
+    process_set_priority(&tsch_pending_events_process, PROCESS_PRIORITY_HIGH);
     process_start(&tsch_pending_events_process, NULL);
     if(TSCH_EB_PERIOD > 0) {
       /* periodically send TSCH EBs */
@@ -70,6 +70,26 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_HASH
+#if NBR_TABLE_HASH_SIZE <= NBR_TABLE_MAX_NEIGHBORS
+#error NBR_TABLE_HASH_SIZE must be larger than NBR_TABLE_MAX_NEIGHBORS
+#endif
+#if (NBR_TABLE_HASH_SIZE & (NBR_TABLE_HASH_SIZE - 1)) != 0
+#error NBR_TABLE_HASH_SIZE must be a power of two
+#endif
+#define HASH_MASK (NBR_TABLE_HASH_SIZE - 1)
+/* The hash index over the link-layer addresses of the keys. Each slot holds
+ * a neighbor index plus one, or 0 when empty. Collisions are resolved by
+ * linear probing, and removals shift the following entries back so that
+ * no tombstones are needed. */
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t hash_slot_t;
+#else
+typedef uint16_t hash_slot_t;
+#endif
+static hash_slot_t hash_slots[NBR_TABLE_HASH_SIZE];
+#endif /* NBR_TABLE_HASH */
+
 /*---------------------------------------------------------------------------*/
 static void remove_key(nbr_table_key_t *key, bool do_free);
 /*---------------------------------------------------------------------------*/
@@ -115,16 +135,88 @@ key_from_item(const nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_HASH
+/* Get the home slot of a link-layer address (32-bit FNV-1a) */
+static unsigned
+hash_slot_from_lladdr(const linkaddr_t *lladdr)
+{
+  uint32_t hash = 2166136261UL;
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    hash = (hash ^ lladdr->u8[i]) * 16777619UL;
+  }
+  return (hash ^ (hash >> 16)) & HASH_MASK;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the hash index, once its link-layer address is set */
+static void
+hash_insert(const nbr_table_key_t *key)
+{
+  unsigned slot = hash_slot_from_lladdr(&key->lladdr);
+
+  while(hash_slots[slot] != 0) {
+    slot = (slot + 1) & HASH_MASK;
+  }
+  hash_slots[slot] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash index, before its link-layer address changes */
+static void
+hash_remove(const nbr_table_key_t *key)
+{
+  hash_slot_t entry = index_from_key(key) + 1;
+  unsigned slot = hash_slot_from_lladdr(&key->lladdr);
+  unsigned next;
+  unsigned home;
+
+  while(hash_slots[slot] != entry) {
+    if(hash_slots[slot] == 0) {
+      /* Not indexed */
+      return;
+    }
+    slot = (slot + 1) & HASH_MASK;
+  }
+
+  /* Move back each following entry of the probe sequence that can no
+   * longer be reached from its home slot, then free the last hole */
+  for(next = (slot + 1) & HASH_MASK; hash_slots[next] != 0;
+      next = (next + 1) & HASH_MASK) {
+    home = hash_slot_from_lladdr(&key_from_index(hash_slots[next] - 1)->lladdr);
+    if(((next - home) & HASH_MASK) >= ((next - slot) & HASH_MASK)) {
+      hash_slots[slot] = hash_slots[next];
+      slot = next;
+    }
+  }
+  hash_slots[slot] = 0;
+}
+#endif /* NBR_TABLE_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_HASH
+  unsigned slot;
+  int index;
+#else /* NBR_TABLE_HASH */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_HASH
+  slot = hash_slot_from_lladdr(lladdr);
+  while(hash_slots[slot] != 0) {
+    index = hash_slots[slot] - 1;
+    if(linkaddr_cmp(lladdr, &key_from_index(index)->lladdr)) {
+      return index;
+    }
+    slot = (slot + 1) & HASH_MASK;
+  }
+#else /* NBR_TABLE_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -132,6 +224,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_HASH */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -187,6 +280,9 @@ remove_key(nbr_table_key_t *key, bool do_free)
   locked_map[index_from_key(key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, key);
+#if NBR_TABLE_HASH
+  hash_remove(key);
+#endif /* NBR_TABLE_HASH */
   if(do_free) {
     /* Release the memory */
     memb_free(&neighbor_addr_mem, key);
@@ -434,6 +530,9 @@ nbr_table_add_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr,
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_HASH
+    hash_insert(key);
+#endif /* NBR_TABLE_HASH */
   }
 
   /* Get item in the current table */
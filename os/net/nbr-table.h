@@ -55,6 +55,35 @@ typedef enum {
 
 #define NBR_TABLE_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
 
+/* When non-zero, neighbors are looked up by link-layer address through an
+ * open-addressing hash index instead of a walk of the neighbor list. This
+ * costs NBR_TABLE_HASH_SIZE bytes (two per slot above 254 neighbors), and
+ * pays off with large tables. The order of the neighbor list, and thus
+ * iteration and garbage collection, are unchanged. */
+#ifdef NBR_TABLE_CONF_HASH
+#define NBR_TABLE_HASH NBR_TABLE_CONF_HASH
+#else /* NBR_TABLE_CONF_HASH */
+#define NBR_TABLE_HASH 0
+#endif /* NBR_TABLE_CONF_HASH */
+
+/* Number of slots of the hash index, a power of two. The default keeps
+ * the index at most half full. */
+#ifdef NBR_TABLE_CONF_HASH_SIZE
+#define NBR_TABLE_HASH_SIZE NBR_TABLE_CONF_HASH_SIZE
+#elif NBR_TABLE_MAX_NEIGHBORS <= 8
+#define NBR_TABLE_HASH_SIZE 16
+#elif NBR_TABLE_MAX_NEIGHBORS <= 16
+#define NBR_TABLE_HASH_SIZE 32
+#elif NBR_TABLE_MAX_NEIGHBORS <= 32
+#define NBR_TABLE_HASH_SIZE 64
+#elif NBR_TABLE_MAX_NEIGHBORS <= 64
+#define NBR_TABLE_HASH_SIZE 128
+#elif NBR_TABLE_MAX_NEIGHBORS <= 128
+#define NBR_TABLE_HASH_SIZE 256
+#else /* NBR_TABLE_CONF_HASH_SIZE */
+#define NBR_TABLE_HASH_SIZE 512
+#endif /* NBR_TABLE_CONF_HASH_SIZE */
+
 #ifdef NBR_TABLE_CONF_GC_GET_WORST
 #define NBR_TABLE_GC_GET_WORST NBR_TABLE_CONF_GC_GET_WORST
 #else /* NBR_TABLE_CONF_GC_GET_WORST */
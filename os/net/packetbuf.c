@@ -37,6 +37,7 @@
  *         Adam Dunkels <adam@sics.se>
  */
 
+
 /**
  * \addtogroup packetbuf
  * @{
@@ -47,20 +48,48 @@
 #include "contiki-net.h"
 #include "net/packetbuf.h"
 #include "sys/cc.h"
+#include "lib/assert.h"
 
-struct packetbuf_attr packetbuf_attrs[PACKETBUF_NUM_ATTRS];
-struct packetbuf_addr packetbuf_addrs[PACKETBUF_NUM_ADDRS];
+/* A packet buffer and its attributes. The declarations below ensure that
+   the buffer is aligned on an even 32-bit boundary. On some platforms
+   (most notably the msp430 or OpenRISC), having a potentially misaligned
+   packet buffer may lead to problems when accessing words.
+   PACKETBUF_HEADROOM is a multiple of 4 so that the payload of a new
+   packet is aligned too. */
+struct packetbuf {
+  uint32_t aligned[(PACKETBUF_HEADROOM + PACKETBUF_SIZE + 3) / 4];
+  uint16_t start;  /* Offset of the first header byte in aligned[] */
+  uint16_t buflen, bufptr;
+  uint8_t hdrlen;
+#if PACKETBUF_POOL_NUM
+  uint8_t refs;         /* References taken with packetbuf_hold() */
+  uint16_t held_start;  /* Offset of the held packet */
+  uint16_t held_len;    /* Length of the held packet */
+#endif /* PACKETBUF_POOL_NUM */
+  uint32_t attrs_set;   /* Bitmap of the attributes that may be non-zero */
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+};
+/* attrs_set, and the packed form, have one bit per attribute */
+CTASSERT(PACKETBUF_NUM_ATTRS <= 32);
 
+#if PACKETBUF_POOL_NUM
+#if PACKETBUF_HEADROOM % 4 != 0
+#error PACKETBUF_HEADROOM must be a multiple of 4
+#endif
+static struct packetbuf pool[PACKETBUF_POOL_NUM];
+/* The number of buffers with references. At least one buffer is kept free
+   of them, so that packetbuf_clear() can always start a new packet. */
+static uint8_t held_count;
+struct packetbuf_pool_stats packetbuf_pool_stats;
+#else /* PACKETBUF_POOL_NUM */
+static struct packetbuf pool[1];
+#endif /* PACKETBUF_POOL_NUM */
 
-static uint16_t buflen, bufptr;
-static uint8_t hdrlen;
+/* The buffer that the packetbuf functions operate on */
+static struct packetbuf *current = &pool[0];
 
-/* The declarations below ensure that the packet buffer is aligned on
-   an even 32-bit boundary. On some platforms (most notably the
-   msp430 or OpenRISC), having a potentially misaligned packet buffer may lead to
-   problems when accessing words. */
-static uint32_t packetbuf_aligned[(PACKETBUF_SIZE + 3) / 4];
-static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
+#define BUF(b) ((uint8_t *)(b)->aligned)
 
 #define DEBUG 0
 #if DEBUG
@@ -70,12 +99,137 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 #define PRINTF(...)
 #endif
 
+#if PACKETBUF_POOL_NUM
+/*---------------------------------------------------------------------------*/
+static struct packetbuf *
+unheld_buffer(void)
+{
+  struct packetbuf *b;
+
+  for(b = pool; b->refs > 0 || b == current; b++);
+  return b;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_unshare(void)
+{
+  struct packetbuf *b;
+
+  if(current->refs > 0) {
+    b = unheld_buffer();
+    memcpy(b, current, sizeof(struct packetbuf));
+    b->refs = 0;
+    current = b;
+    packetbuf_pool_stats.unshares++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct packetbuf *
+packetbuf_hold(void)
+{
+  uint16_t start;
+
+  /* The held packet must be contiguous */
+  if(current->bufptr > 0 && current->hdrlen > 0) {
+    packetbuf_pool_stats.hold_failures++;
+    return NULL;
+  }
+  start = current->start + current->bufptr;
+
+  if(current->refs == 0) {
+    if(held_count >= PACKETBUF_POOL_NUM - 1) {
+      packetbuf_pool_stats.hold_failures++;
+      return NULL;
+    }
+    held_count++;
+    current->held_start = start;
+    current->held_len = packetbuf_totlen() - current->bufptr;
+  } else if(current->held_start != start
+            || current->held_len != packetbuf_totlen() - current->bufptr) {
+    /* Already held, with other contents */
+    packetbuf_pool_stats.hold_failures++;
+    return NULL;
+  }
+  current->refs++;
+  packetbuf_pool_stats.holds++;
+  return current;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_select(struct packetbuf *b)
+{
+  current = b;
+  b->start = b->held_start;
+  b->hdrlen = 0;
+  b->bufptr = 0;
+  b->buflen = b->held_len;
+  packetbuf_pool_stats.selects++;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_release(struct packetbuf *b)
+{
+  if(b->refs > 0 && --b->refs == 0) {
+    held_count--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_held_update(struct packetbuf *b, bool with_data)
+{
+  if(b != current) {
+    b->attrs_set = current->attrs_set;
+    memcpy(b->attrs, current->attrs, sizeof(b->attrs));
+    memcpy(b->addrs, current->addrs, sizeof(b->addrs));
+  }
+  if(with_data) {
+    if(b != current) {
+      b->held_start = PACKETBUF_HEADROOM;
+      b->held_len = packetbuf_copyto(BUF(b) + PACKETBUF_HEADROOM);
+    } else if(current->bufptr == 0 || current->hdrlen == 0) {
+      b->held_start = current->start + current->bufptr;
+      b->held_len = packetbuf_totlen() - current->bufptr;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void *
+packetbuf_held_dataptr(struct packetbuf *b)
+{
+  return BUF(b) + b->held_start;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+packetbuf_held_datalen(struct packetbuf *b)
+{
+  return b->held_len;
+}
+/*---------------------------------------------------------------------------*/
+packetbuf_attr_t
+packetbuf_held_attr(struct packetbuf *b, uint8_t type)
+{
+  return b->attrs[type].val;
+}
+/*---------------------------------------------------------------------------*/
+linkaddr_t *
+packetbuf_held_addr(struct packetbuf *b, uint8_t type)
+{
+  return &b->addrs[type - PACKETBUF_ADDR_FIRST].addr;
+}
+#endif /* PACKETBUF_POOL_NUM */
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_clear(void)
 {
-  buflen = bufptr = 0;
-  hdrlen = 0;
+#if PACKETBUF_POOL_NUM
+  if(current->refs > 0) {
+    /* Leave the held packet alone and start the new one elsewhere */
+    current = unheld_buffer();
+  }
+#endif /* PACKETBUF_POOL_NUM */
+  current->start = PACKETBUF_HEADROOM;
+  current->buflen = current->bufptr = 0;
+  current->hdrlen = 0;
 
   packetbuf_attr_clear();
 }
@@ -87,48 +241,56 @@ packetbuf_copyfrom(const void *from, uint16_t len)
 
   packetbuf_clear();
   l = MIN(PACKETBUF_SIZE, len);
-  memcpy(packetbuf, from, l);
-  buflen = l;
+  memcpy(packetbuf_hdrptr(), from, l);
+  current->buflen = l;
   return l;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_copyto(void *to)
 {
-  if(hdrlen + buflen > PACKETBUF_SIZE) {
+  if(current->hdrlen + current->buflen > PACKETBUF_SIZE) {
     return 0;
   }
-  memcpy(to, packetbuf_hdrptr(), hdrlen);
-  memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
-  return hdrlen + buflen;
+  memcpy(to, packetbuf_hdrptr(), current->hdrlen);
+  memcpy((uint8_t *)to + current->hdrlen, packetbuf_dataptr(),
+         current->buflen);
+  return current->hdrlen + current->buflen;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_hdralloc(int size)
 {
-  int16_t i;
-
   if(size + packetbuf_totlen() > PACKETBUF_SIZE) {
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
-    packetbuf[i + size] = packetbuf[i];
+  if(size <= current->start) {
+    /* Grow the header into the headroom */
+    current->start -= size;
+  } else {
+#if PACKETBUF_POOL_NUM
+    packetbuf_unshare();
+#endif /* PACKETBUF_POOL_NUM */
+    /* Shift the data right, so that the header starts at the beginning
+       of the buffer. The packet may start beyond the headroom after
+       packetbuf_select(), so shifting in place might overrun it. */
+    memmove(BUF(current) + size, packetbuf_hdrptr(), packetbuf_totlen());
+    current->start = 0;
   }
-  hdrlen += size;
+  current->hdrlen += size;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_hdrreduce(int size)
 {
-  if(buflen < size) {
+  if(current->buflen < size) {
     return 0;
   }
 
-  bufptr += size;
-  buflen -= size;
+  current->bufptr += size;
+  current->buflen -= size;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -136,31 +298,31 @@ void
 packetbuf_set_datalen(uint16_t len)
 {
   PRINTF("packetbuf_set_len: len %d\n", len);
-  buflen = len;
+  current->buflen = len;
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_dataptr(void)
 {
-  return packetbuf + packetbuf_hdrlen();
+  return BUF(current) + current->start + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_hdrptr(void)
 {
-  return packetbuf;
+  return BUF(current) + current->start;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
 packetbuf_datalen(void)
 {
-  return buflen;
+  return current->buflen;
 }
 /*---------------------------------------------------------------------------*/
 uint8_t
 packetbuf_hdrlen(void)
 {
-  return bufptr + hdrlen;
+  return current->bufptr + current->hdrlen;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -179,9 +341,10 @@ void
 packetbuf_attr_clear(void)
 {
   int i;
-  memset(packetbuf_attrs, 0, sizeof(packetbuf_attrs));
+  current->attrs_set = 0;
+  memset(current->attrs, 0, sizeof(current->attrs));
   for(i = 0; i < PACKETBUF_NUM_ADDRS; ++i) {
-    linkaddr_copy(&packetbuf_addrs[i].addr, &linkaddr_null);
+    linkaddr_copy(&current->addrs[i].addr, &linkaddr_null);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -189,48 +352,117 @@ void
 packetbuf_attr_copyto(struct packetbuf_attr *attrs,
                       struct packetbuf_addr *addrs)
 {
-  memcpy(attrs, packetbuf_attrs, sizeof(packetbuf_attrs));
-  memcpy(addrs, packetbuf_addrs, sizeof(packetbuf_addrs));
+  memcpy(attrs, current->attrs, sizeof(current->attrs));
+  memcpy(addrs, current->addrs, sizeof(current->addrs));
 }
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_attr_copyfrom(struct packetbuf_attr *attrs,
                         struct packetbuf_addr *addrs)
 {
-  memcpy(packetbuf_attrs, attrs, sizeof(packetbuf_attrs));
-  memcpy(packetbuf_addrs, addrs, sizeof(packetbuf_addrs));
+  int i;
+
+  memcpy(current->attrs, attrs, sizeof(current->attrs));
+  memcpy(current->addrs, addrs, sizeof(current->addrs));
+  current->attrs_set = 0;
+  for(i = 1; i < PACKETBUF_NUM_ATTRS; i++) {
+    if(attrs[i].val != 0) {
+      current->attrs_set |= (uint32_t)1 << i;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The packed form relies on all attribute types fitting in a 32-bit
+   bitmap. Only the attributes set since the last packetbuf_attr_clear()
+   are visited. */
+int
+packetbuf_attr_pack(uint32_t *present, uint8_t *vals, int maxlen,
+                    struct packetbuf_addr *addrs)
+{
+  packetbuf_attr_t packed[PACKETBUF_NUM_ATTRS];
+  uint32_t set, mask;
+  int i, n;
+
+  mask = 0;
+  n = 0;
+  for(set = current->attrs_set; set != 0; set &= set - 1) {
+    i = __builtin_ctzl(set);
+    if(current->attrs[i].val != 0) {
+      mask |= (uint32_t)1 << i;
+      packed[n++] = current->attrs[i].val;
+    }
+  }
+  n *= sizeof(packetbuf_attr_t);
+  if(n > maxlen) {
+    return -1;
+  }
+
+  *present = mask;
+  memcpy(vals, packed, n);
+  memcpy(addrs, current->addrs, sizeof(current->addrs));
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_attr_unpack(uint32_t present, const uint8_t *vals,
+                      const struct packetbuf_addr *addrs)
+{
+  memset(current->attrs, 0, sizeof(current->attrs));
+  current->attrs_set = present;
+  for(; present != 0; present &= present - 1) {
+    memcpy(&current->attrs[__builtin_ctzl(present)].val, vals,
+           sizeof(packetbuf_attr_t));
+    vals += sizeof(packetbuf_attr_t);
+  }
+  memcpy(current->addrs, addrs, sizeof(current->addrs));
+}
+/*---------------------------------------------------------------------------*/
+packetbuf_attr_t
+packetbuf_attr_packed(uint32_t present, const uint8_t *vals, uint8_t type)
+{
+  packetbuf_attr_t val;
+
+  if(!(present & ((uint32_t)1 << type))) {
+    return 0;
+  }
+  /* Skip the values of the attributes that come before this one */
+  vals += sizeof(packetbuf_attr_t)
+    * __builtin_popcountl(present & (((uint32_t)1 << type) - 1));
+  memcpy(&val, vals, sizeof(val));
+  return val;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_set_attr(uint8_t type, const packetbuf_attr_t val)
 {
-  packetbuf_attrs[type].val = val;
+  current->attrs[type].val = val;
+  current->attrs_set |= (uint32_t)1 << type;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 packetbuf_attr(uint8_t type)
 {
-  return packetbuf_attrs[type].val;
+  return current->attrs[type].val;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_set_addr(uint8_t type, const linkaddr_t *addr)
 {
-  linkaddr_copy(&packetbuf_addrs[type - PACKETBUF_ADDR_FIRST].addr, addr);
+  linkaddr_copy(&current->addrs[type - PACKETBUF_ADDR_FIRST].addr, addr);
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 const linkaddr_t *
 packetbuf_addr(uint8_t type)
 {
-  return &packetbuf_addrs[type - PACKETBUF_ADDR_FIRST].addr;
+  return &current->addrs[type - PACKETBUF_ADDR_FIRST].addr;
 }
 /*---------------------------------------------------------------------------*/
 bool
 packetbuf_holds_broadcast(void)
 {
-  return linkaddr_cmp(&packetbuf_addrs[PACKETBUF_ADDR_RECEIVER - PACKETBUF_ADDR_FIRST].addr, &linkaddr_null);
+  return linkaddr_cmp(&current->addrs[PACKETBUF_ADDR_RECEIVER - PACKETBUF_ADDR_FIRST].addr, &linkaddr_null);
 }
 /*---------------------------------------------------------------------------*/
 
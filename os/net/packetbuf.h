@@ -67,6 +67,39 @@
 #define PACKETBUF_SIZE 128
 #endif
 
+/**
+ * \brief      The number of packet buffers in the pool, or 0 for a single
+ *             packet buffer
+ *
+ *             With a pool, a packet can be held with packetbuf_hold()
+ *             while the packetbuf moves on to other packets, and made
+ *             current again later with packetbuf_select(). Queues can
+ *             thus keep a reference to a packet instead of a copy, see
+ *             queuebuf_hold_packetbuf(). Attributes are stored with each
+ *             buffer.
+ */
+#ifdef PACKETBUF_CONF_POOL_NUM
+#define PACKETBUF_POOL_NUM PACKETBUF_CONF_POOL_NUM
+#else
+#define PACKETBUF_POOL_NUM 0
+#endif
+
+/**
+ * \brief      Space reserved in front of each new packet, in bytes
+ *
+ *             Headers allocated with packetbuf_hdralloc() go into the
+ *             headroom without moving the packet, as long as it is large
+ *             enough. With a pool, this lets a held packet be framed again
+ *             for each transmission. Must be a multiple of 4.
+ */
+#ifdef PACKETBUF_CONF_HEADROOM
+#define PACKETBUF_HEADROOM PACKETBUF_CONF_HEADROOM
+#elif PACKETBUF_POOL_NUM
+#define PACKETBUF_HEADROOM 40
+#else
+#define PACKETBUF_HEADROOM 0
+#endif
+
 /**
  * \brief      Clear and reset the packetbuf
  *
@@ -277,6 +310,30 @@ void              packetbuf_attr_copyto(struct packetbuf_attr *attrs,
 void              packetbuf_attr_copyfrom(struct packetbuf_attr *attrs,
                                           struct packetbuf_addr *addrs);
 
+/**
+ * \brief      Copy the attributes of the current packet in packed form
+ * \param present Set to a bitmap of the attributes that are non-zero
+ * \param vals Where the values of these attributes are written, in type
+ *             order and without padding
+ * \param maxlen The size of vals
+ * \param addrs Where the addresses are copied
+ * \return     The number of bytes written to vals, or -1 if more than
+ *             maxlen bytes are needed, in which case nothing is written
+ */
+int               packetbuf_attr_pack(uint32_t *present, uint8_t *vals,
+                                      int maxlen,
+                                      struct packetbuf_addr *addrs);
+/**
+ * \brief      Set the attributes of the current packet from packed form
+ */
+void              packetbuf_attr_unpack(uint32_t present, const uint8_t *vals,
+                                        const struct packetbuf_addr *addrs);
+/**
+ * \brief      Get one attribute from packed form
+ */
+packetbuf_attr_t  packetbuf_attr_packed(uint32_t present, const uint8_t *vals,
+                                        uint8_t type);
+
 #define PACKETBUF_ATTRIBUTES(...) { __VA_ARGS__ PACKETBUF_ATTR_LAST }
 #define PACKETBUF_ATTR_LAST { PACKETBUF_ATTR_NONE, 0 }
 
@@ -291,6 +348,79 @@ struct packetbuf_attrlist {
   uint8_t len;
 };
 
+#if PACKETBUF_POOL_NUM
+/**
+ * \name Packet buffer pool
+ * @{
+ *
+ * A held packet stays in its buffer until all references to it are
+ * released. It must not be modified in place while it is held, except
+ * for the headers that packetbuf_hdralloc() adds in front of it: a new
+ * packet is started with packetbuf_clear() or packetbuf_copyfrom(), which
+ * move the packetbuf to an unheld buffer. Code that modifies the payload
+ * of a packet that may be held, such as link-layer encryption, calls
+ * packetbuf_unshare() first.
+ */
+
+/** A packet buffer of the pool */
+struct packetbuf;
+
+/**
+ * \brief      Take a reference to the current packet
+ * \retval     The buffer of the packet, or NULL if it cannot be held
+ *
+ *             Fails when holding the packet would leave no unheld buffer,
+ *             in which case the caller copies the packet instead.
+ */
+struct packetbuf *packetbuf_hold(void);
+
+/**
+ * \brief      Release a reference taken with packetbuf_hold()
+ */
+void packetbuf_release(struct packetbuf *b);
+
+/**
+ * \brief      Make a held packet the current one, as it was when held
+ *
+ *             Headers added after the packet was held are dropped. The
+ *             attributes are those last set on the packet.
+ */
+void packetbuf_select(struct packetbuf *b);
+
+/**
+ * \brief      Copy the current packet to an unheld buffer if it is held
+ */
+void packetbuf_unshare(void);
+
+/**
+ * \brief      Update a held packet from the current one
+ * \param b    The held packet
+ * \param with_data Non-zero to update the packet contents, not only the
+ *             attributes
+ */
+void packetbuf_held_update(struct packetbuf *b, bool with_data);
+
+void *packetbuf_held_dataptr(struct packetbuf *b);
+uint16_t packetbuf_held_datalen(struct packetbuf *b);
+packetbuf_attr_t packetbuf_held_attr(struct packetbuf *b, uint8_t type);
+linkaddr_t *packetbuf_held_addr(struct packetbuf *b, uint8_t type);
+
+/** Packet buffer pool counters */
+struct packetbuf_pool_stats {
+  uint32_t holds;         /**< Packets held instead of copied */
+  uint32_t selects;       /**< Held packets made current without a copy */
+  uint32_t hold_failures; /**< Holds refused, the caller copied instead */
+  uint32_t unshares;      /**< Held packets copied before a change */
+};
+
+/**
+ * The pool counters. Each hold and each select saves one copy of the
+ * packet and its attributes.
+ */
+extern struct packetbuf_pool_stats packetbuf_pool_stats;
+/** @} */
+#endif /* PACKETBUF_POOL_NUM */
+
 #endif /* PACKETBUF_H_ */
 /** @} */
 /** @} */
@@ -44,11 +44,16 @@
 
 #include "contiki-net.h"
 #include "net/queuebuf.h"
+#include "lib/assert.h"
 
 #if WITH_SWAP
 #include "cfs/cfs.h"
+#if QUEUEBUF_SWAP_COFFEE
+#include "cfs/cfs-coffee.h"
+#endif /* QUEUEBUF_SWAP_COFFEE */
 #endif
 
+#include <stddef.h> /* for offsetof() */
 #include <string.h> /* for memcpy() */
 
 /* Structure pointing to a buffer either stored
@@ -60,55 +65,133 @@ struct queuebuf {
   int line;
   clock_time_t time;
 #endif /* QUEUEBUF_DEBUG */
+#if PACKETBUF_POOL_NUM
+  /* The held packet, or NULL if the packet was copied */
+  struct packetbuf *held;
+#endif /* PACKETBUF_POOL_NUM */
 #if WITH_SWAP
   enum {IN_RAM, IN_CFS} location;
   union {
 #endif
     struct queuebuf_data *ram_ptr;
 #if WITH_SWAP
-    int swap_id;
+    struct {
+      uint16_t segment;
+      uint16_t offset;
+    } swap;
   };
 #endif
 };
 
 /* The actual queuebuf data */
 struct queuebuf_data {
+#if QUEUEBUF_COMPACT_ATTRS
+  /* The packet, followed by the values of its non-zero attributes */
+  uint8_t data[PACKETBUF_SIZE + QUEUEBUF_ATTRS_NUM * sizeof(packetbuf_attr_t)];
+  uint32_t attrs_present;
+  uint16_t len;
+#else /* QUEUEBUF_COMPACT_ATTRS */
   uint8_t data[PACKETBUF_SIZE];
   uint16_t len;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+#endif /* QUEUEBUF_COMPACT_ATTRS */
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
 MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
 
+#if QUEUEBUF_COMPACT_ATTRS
+/* A queuebuf whose non-zero attributes do not fit after the packet keeps
+   them all in one of these instead, and has ATTRS_FULL as attrs_present.
+   The array stays in RAM, with its owner, when the queuebuf is swapped. */
+struct queuebuf_attrs {
+  struct queuebuf *owner;
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+};
+MEMB(attrmem, struct queuebuf_attrs, QUEUEBUF_FULL_ATTRS_NUM);
+static uint8_t full_attrs_used;
+#define ATTRS_FULL ((uint32_t)1 << 31)
+CTASSERT(PACKETBUF_NUM_ATTRS <= 31);
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+
+#ifdef QUEUEBUF_VIEWCONF
+/* "make viewconf" compiles this to assembly and shows these lines */
+void
+queuebuf_viewconf(void)
+{
+#if QUEUEBUF_COMPACT_ATTRS
+  struct queuebuf_data_full {
+    uint8_t data[PACKETBUF_SIZE];
+    uint16_t len;
+    struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+    struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+  };
+
+  __asm__("\n##### \"queuebuf_data size\": ____________________ %c0"
+          " bytes, %c1 bytes less than without compact attributes\n"
+          : : "i" (sizeof(struct queuebuf_data)),
+          "i" ((int)(sizeof(struct queuebuf_data_full)
+                     - sizeof(struct queuebuf_data))));
+#else /* QUEUEBUF_COMPACT_ATTRS */
+  __asm__("\n##### \"queuebuf_data size\": ____________________ %c0"
+          " bytes\n" : : "i" (sizeof(struct queuebuf_data)));
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+}
+#endif /* QUEUEBUF_VIEWCONF */
+
 #if WITH_SWAP
 
-/* Swapping allows to store up to QUEUEBUF_NUM - QUEUEBUFRAM_NUM
-   queuebufs in CFS. The swap is made of several large CFS files.
-   Every buffer stored in CFS has a swap id, referring to a specific
-   offset in one of these files. */
-#define NQBUF_FILES 4
-#define NQBUF_PER_FILE 256
-#define QBUF_FILE_SIZE (NQBUF_PER_FILE*sizeof(struct queuebuf_data))
-#define NQBUF_ID (NQBUF_PER_FILE * NQBUF_FILES)
+/* Swapping keeps up to QUEUEBUFRAM_NUM queuebufs in RAM. When more are
+   needed, the oldest one in RAM is appended to a log in CFS. The log is
+   made of segment files of QUEUEBUF_SWAP_SEGMENT_SIZE bytes, written
+   QUEUEBUF_SWAP_BATCH records or more at a time, and removed once all
+   their records have been freed. Records are never modified in place: a
+   swapped queuebuf that is updated is appended again. A record is the
+   queuebuf_data fields that follow the data, then the used part of the
+   data. */
+#define RECORD_META(d) ((uint8_t *)(d) + sizeof((d)->data))
+#define RECORD_META_SIZE (sizeof(struct queuebuf_data) \
+                          - sizeof(((struct queuebuf_data *)0)->data))
+/* The offset of a field of queuebuf_data in a record */
+#define RECORD_META_OFFSET(field) (offsetof(struct queuebuf_data, field) \
+                                   - sizeof(((struct queuebuf_data *)0)->data))
+/* The number of records that fit in a segment, at their largest */
+#define SEGMENT_RECORDS (QUEUEBUF_SWAP_SEGMENT_SIZE \
+                         / sizeof(struct queuebuf_data))
+/* Queuebufs freed out of order leave live records scattered over the
+   segments. When the segment being written is full and only one free
+   segment is left, the live records of the segment with the fewest of
+   them are moved to the free one, which frees that segment. There are at
+   most QUEUEBUF_NUM - QUEUEBUFRAM_NUM + 1 live records, with an updated
+   copy, so with that many segments, the one with the fewest live records
+   has fewer than SEGMENT_RECORDS. They leave room for a new record. */
+#define NUM_SEGMENTS ((QUEUEBUF_NUM - QUEUEBUFRAM_NUM + 1) / SEGMENT_RECORDS + 2)
 
-struct qbuf_file {
-  int fd;
-  int usage;
-  int renewable;
-};
+/* Number of live records in each segment */
+static uint16_t segment_live[NUM_SEGMENTS];
+/* The segment being written, and the number of bytes written to it */
+static uint16_t write_segment;
+static uint16_t write_flushed;
+static int write_fd = -1;
+/* Records not yet written, at the end of the segment being written */
+static uint8_t batch[QUEUEBUF_SWAP_BATCH * sizeof(struct queuebuf_data)];
+static uint16_t batch_len;
+/* The segment last read from, other than the one being written */
+static uint16_t read_segment;
+static int read_fd = -1;
+
+/* The owners of the RAM buffers, and the order of their allocation */
+static struct queuebuf *ram_owner[QUEUEBUFRAM_NUM];
+static uint32_t ram_age[QUEUEBUFRAM_NUM];
+static uint32_t next_age;
 
 /* A statically allocated queuebuf used as a cache for swapped qbufs */
 static struct queuebuf_data tmpdata;
 /* A pointer to the qbuf associated to the data in tmpdata */
 static struct queuebuf *tmpdata_qbuf = NULL;
-/* The swap id counter */
-static int next_swap_id = 0;
-/* The swap files */
-static struct qbuf_file qbuf_files[NQBUF_FILES];
-/* The timer used to renew files during inactivity periods */
-static struct ctimer renew_timer;
+
+struct queuebuf_swap_stats queuebuf_swap_stats;
 
 #endif
 
@@ -137,158 +220,499 @@ uint8_t queuebuf_len, queuebuf_max_len;
 
 #if WITH_SWAP
 /*---------------------------------------------------------------------------*/
-static void
-qbuf_renew_file(int file)
+/* The number of bytes of data[] in use by a record */
+static uint16_t
+record_data_used(const uint8_t *meta)
 {
-  int ret;
-  char name[2];
-  name[0] = 'a' + file;
-  name[1] = '\0';
-  if(qbuf_files[file].renewable == 1) {
-    PRINTF("qbuf_renew_file: removing file %d\n", file);
-    cfs_remove(name);
-  }
-  ret = cfs_open(name, CFS_READ | CFS_WRITE);
-  if(ret == -1) {
-    PRINTF("qbuf_renew_file: cfs open error\n");
+  uint16_t len;
+#if QUEUEBUF_COMPACT_ATTRS
+  uint32_t attrs_present;
+
+  memcpy(&attrs_present, meta + RECORD_META_OFFSET(attrs_present),
+         sizeof(attrs_present));
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+  memcpy(&len, meta + RECORD_META_OFFSET(len), sizeof(len));
+#if QUEUEBUF_COMPACT_ATTRS
+  if(attrs_present == ATTRS_FULL) {
+    return len;
   }
-  qbuf_files[file].fd = ret;
-  qbuf_files[file].usage = 0;
-  qbuf_files[file].renewable = 0;
+  return len + sizeof(packetbuf_attr_t) * __builtin_popcountl(attrs_present);
+#else /* QUEUEBUF_COMPACT_ATTRS */
+  return len;
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+}
+/*---------------------------------------------------------------------------*/
+/* The number of bytes of data[] in use */
+static uint16_t
+data_used(const struct queuebuf_data *d)
+{
+  return record_data_used(RECORD_META(d));
 }
 /*---------------------------------------------------------------------------*/
-/* Renews every file with renewable flag set */
 static void
-qbuf_renew_all(void *unused)
+segment_name(char *name, uint16_t segment)
 {
+  static const char hex[] = "0123456789abcdef";
   int i;
-  for(i=0; i<NQBUF_FILES; i++) {
-    if(qbuf_files[i].renewable == 1) {
-      qbuf_renew_file(i);
-    }
+
+  memcpy(name, "qbuf.", 5);
+  for(i = 0; i < 4; i++) {
+    name[8 - i] = hex[(segment >> (4 * i)) & 0xf];
   }
+  name[9] = '\0';
 }
 /*---------------------------------------------------------------------------*/
-/* Removes a queuebuf from its swap file */
 static void
-queuebuf_remove_from_file(int swap_id)
-{
-  int fileid;
-  if(swap_id != -1) {
-    fileid = swap_id / NQBUF_PER_FILE;
-    qbuf_files[fileid].usage--;
-
-    /* The file is full but doesn't contain any more queuebuf, mark it as renewable */
-    if(qbuf_files[fileid].usage == 0 && fileid != next_swap_id / NQBUF_PER_FILE) {
-      qbuf_files[fileid].renewable = 1;
-      /* This file is renewable, set a timer to renew files */
-      ctimer_set(&renew_timer, 0, qbuf_renew_all, NULL);
+segment_remove(uint16_t segment)
+{
+  char name[10];
+
+  if(read_fd >= 0 && read_segment == segment) {
+    cfs_close(read_fd);
+    read_fd = -1;
+  }
+  segment_name(name, segment);
+  cfs_remove(name);
+}
+/*---------------------------------------------------------------------------*/
+/* Writes the pending records to the segment being written */
+static int
+flush_batch(void)
+{
+  char name[10];
+
+  if(batch_len == 0) {
+    return 0;
+  }
+  if(write_fd < 0) {
+    segment_name(name, write_segment);
+#if QUEUEBUF_SWAP_COFFEE
+    cfs_coffee_reserve(name, QUEUEBUF_SWAP_SEGMENT_SIZE);
+#endif /* QUEUEBUF_SWAP_COFFEE */
+    /* Not in append mode: every write goes to write_flushed, so that one
+       that failed halfway is overwritten by the next */
+    write_fd = cfs_open(name, CFS_READ | CFS_WRITE);
+    if(write_fd < 0) {
+      PRINTF("queuebuf flush_batch: cfs open error\n");
+      return -1;
     }
+#if QUEUEBUF_SWAP_COFFEE
+    /* Segments are only appended to, and records may end with zeroes */
+    cfs_coffee_set_io_semantics(write_fd, CFS_COFFEE_IO_FLASH_AWARE
+                                | CFS_COFFEE_IO_ENSURE_READ_LENGTH);
+#endif /* QUEUEBUF_SWAP_COFFEE */
+  }
+  if(cfs_seek(write_fd, write_flushed, CFS_SEEK_SET) != write_flushed
+     || cfs_write(write_fd, batch, batch_len) != batch_len) {
+    /* The records stay in the batch, where they can still be read */
+    PRINTF("queuebuf flush_batch: cfs write error\n");
+    return -1;
+  }
+  write_flushed += batch_len;
+  batch_len = 0;
+  queuebuf_swap_stats.writes++;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Reads len bytes at offset of a segment, from the batch if they are not
+   written yet */
+static int
+segment_read(uint16_t segment, uint16_t offset, void *buf, uint16_t len)
+{
+  char name[10];
+  int fd;
+
+  if(segment == write_segment && offset >= write_flushed) {
+    memcpy(buf, &batch[offset - write_flushed], len);
+    return 0;
+  }
 
-    if(tmpdata_qbuf->swap_id == swap_id) {
-      tmpdata_qbuf->swap_id = -1;
+  if(segment == write_segment) {
+    fd = write_fd;
+  } else {
+    if(read_fd < 0 || read_segment != segment) {
+      if(read_fd >= 0) {
+        cfs_close(read_fd);
+      }
+      segment_name(name, segment);
+      read_fd = cfs_open(name, CFS_READ);
+      read_segment = segment;
+#if QUEUEBUF_SWAP_COFFEE
+      if(read_fd >= 0) {
+        cfs_coffee_set_io_semantics(read_fd, CFS_COFFEE_IO_ENSURE_READ_LENGTH);
+      }
+#endif /* QUEUEBUF_SWAP_COFFEE */
     }
+    fd = read_fd;
   }
+  if(fd < 0
+     || cfs_seek(fd, offset, CFS_SEEK_SET) != offset
+     || cfs_read(fd, buf, len) != len) {
+    PRINTF("queuebuf segment_read: cfs read error\n");
+    return -1;
+  }
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 static int
-get_new_swap_id(void)
-{
-  int fileid;
-  int swap_id = next_swap_id;
-  fileid = swap_id / NQBUF_PER_FILE;
-  if(swap_id % NQBUF_PER_FILE == 0) { /* This is the first id in the file */
-    if(qbuf_files[fileid].renewable) {
-      qbuf_renew_file(fileid);
+swap_read(struct queuebuf *b, struct queuebuf_data *d)
+{
+  if(b->swap.segment != write_segment || b->swap.offset < write_flushed) {
+    queuebuf_swap_stats.reads++;
+  }
+  if(segment_read(b->swap.segment, b->swap.offset,
+                  RECORD_META(d), RECORD_META_SIZE) < 0
+     || segment_read(b->swap.segment, b->swap.offset + RECORD_META_SIZE,
+                     d->data, data_used(d)) < 0) {
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns a segment without live records, other than the one being
+   written, or the one being written if there is none */
+static uint16_t
+free_segment(void)
+{
+  uint16_t segment;
+
+  for(segment = (write_segment + 1) % NUM_SEGMENTS;
+      segment != write_segment && segment_live[segment] > 0;
+      segment = (segment + 1) % NUM_SEGMENTS);
+  return segment;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the record of a swapped queuebuf to the end of the log */
+static int
+swap_move(struct queuebuf *b)
+{
+  uint8_t *record;
+  uint16_t size;
+
+  if(batch_len + sizeof(struct queuebuf_data) > sizeof(batch)
+     && flush_batch() < 0) {
+    return -1;
+  }
+  record = &batch[batch_len];
+  if(segment_read(b->swap.segment, b->swap.offset,
+                  record, RECORD_META_SIZE) < 0) {
+    return -1;
+  }
+  size = RECORD_META_SIZE + record_data_used(record);
+  if(write_flushed + batch_len + size > QUEUEBUF_SWAP_SEGMENT_SIZE
+     || segment_read(b->swap.segment, b->swap.offset + RECORD_META_SIZE,
+                     record + RECORD_META_SIZE,
+                     size - RECORD_META_SIZE) < 0) {
+    return -1;
+  }
+  segment_live[b->swap.segment]--;
+  b->swap.segment = write_segment;
+  b->swap.offset = write_flushed + batch_len;
+  batch_len += size;
+  segment_live[write_segment]++;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Frees a segment by moving its live records to the segment being
+   written, which is empty. The segment with the fewest live records is
+   chosen. */
+static int
+swap_clean(void)
+{
+  struct queuebuf *b;
+  uint16_t victim;
+  uint16_t segment;
+  int i;
+
+  victim = write_segment;
+  for(segment = 0; segment < NUM_SEGMENTS; segment++) {
+    if(segment != write_segment
+       && (victim == write_segment
+           || segment_live[segment] < segment_live[victim])) {
+      victim = segment;
     }
-    if(qbuf_files[fileid].usage>0) {
+  }
+
+  /* Free queuebufs are never IN_CFS, see free_data() */
+  for(i = 0; i < QUEUEBUF_NUM && segment_live[victim] > 0; i++) {
+    b = &bufmem_memb_mem[i];
+    if(b->location == IN_CFS && b->swap.segment == victim
+       && swap_move(b) < 0) {
+      PRINTF("queuebuf swap_clean: could not move a record\n");
       return -1;
     }
   }
-  qbuf_files[fileid].usage++;
-  next_swap_id = (next_swap_id+1) % NQBUF_ID;
-  return swap_id;
+  segment_remove(victim);
+  queuebuf_swap_stats.cleanings++;
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
-/* Flush tmpdata to CFS */
+/* Appends a record to the log. Returns -1 if the swap is full. */
 static int
-queuebuf_flush_tmpdata(void)
-{
-  int fileid, fd, ret;
-  cfs_offset_t offset;
-  if(tmpdata_qbuf) {
-    queuebuf_remove_from_file(tmpdata_qbuf->swap_id);
-    tmpdata_qbuf->swap_id = get_new_swap_id();
-    if(tmpdata_qbuf->swap_id == -1) {
+swap_append(const struct queuebuf_data *d, uint16_t *segment,
+            uint16_t *offset)
+{
+  uint16_t size;
+  uint16_t next;
+
+  size = RECORD_META_SIZE + data_used(d);
+  if(write_flushed + batch_len + size > QUEUEBUF_SWAP_SEGMENT_SIZE) {
+    /* Move on to the next segment without live records */
+    next = free_segment();
+    if(next == write_segment || flush_batch() < 0) {
       return -1;
     }
-    fileid = tmpdata_qbuf->swap_id / NQBUF_PER_FILE;
-    offset = (tmpdata_qbuf->swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
-    fd = qbuf_files[fileid].fd;
-    ret = cfs_seek(fd, offset, CFS_SEEK_SET);
-    if(ret == -1) {
-      PRINTF("queuebuf_flush_tmpdata: cfs seek error\n");
-      return -1;
+    if(write_fd >= 0) {
+      cfs_close(write_fd);
+      write_fd = -1;
+    }
+    if(segment_live[write_segment] == 0) {
+      segment_remove(write_segment);
     }
-    ret = cfs_write(fd, &tmpdata, sizeof(struct queuebuf_data));
-    if(ret == -1) {
-      PRINTF("queuebuf_flush_tmpdata: cfs write error\n");
+    write_segment = next;
+    write_flushed = 0;
+    /* Keep a free segment for the next time */
+    if(free_segment() == write_segment && swap_clean() < 0) {
       return -1;
     }
   }
+  if(batch_len + size > sizeof(batch) && flush_batch() < 0) {
+    return -1;
+  }
+
+  *segment = write_segment;
+  *offset = write_flushed + batch_len;
+  memcpy(&batch[batch_len], RECORD_META(d), RECORD_META_SIZE);
+  memcpy(&batch[batch_len + RECORD_META_SIZE], d->data, data_used(d));
+  batch_len += size;
+  segment_live[write_segment]++;
+  queuebuf_swap_stats.records++;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Frees a record. Its segment is removed if it has no live records left. */
+static void
+swap_release(struct queuebuf *b)
+{
+  uint16_t segment = b->swap.segment;
+
+  if(tmpdata_qbuf == b) {
+    tmpdata_qbuf = NULL;
+  }
+  if(--segment_live[segment] > 0) {
+    return;
+  }
+  if(segment == write_segment) {
+    /* Start the segment over */
+    batch_len = 0;
+    if(write_fd >= 0) {
+      cfs_close(write_fd);
+      write_fd = -1;
+    }
+    if(write_flushed > 0) {
+      segment_remove(segment);
+      write_flushed = 0;
+    }
+  } else {
+    segment_remove(segment);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the oldest queuebuf in RAM to the swap, and frees its RAM buffer */
+static int
+swap_out_oldest(void)
+{
+  struct queuebuf *b;
+  struct queuebuf_data *d;
+  int i, oldest;
+
+  oldest = -1;
+  for(i = 0; i < QUEUEBUFRAM_NUM; i++) {
+    if(ram_owner[i] != NULL
+       && (oldest < 0 || ram_age[oldest] - ram_age[i] < UINT32_MAX / 2)) {
+      oldest = i;
+    }
+  }
+  if(oldest < 0) {
+    return -1;
+  }
+
+  b = ram_owner[oldest];
+  d = b->ram_ptr;
+  if(swap_append(d, &b->swap.segment, &b->swap.offset) < 0) {
+    return -1;
+  }
+  b->location = IN_CFS;
+  ram_owner[oldest] = NULL;
+  memb_free(&buframmem, d);
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+/* Allocates a RAM buffer for b, swapping out another queuebuf if needed */
+static struct queuebuf_data *
+ram_alloc(struct queuebuf *b)
+{
+  struct queuebuf_data *d;
+  int i;
+
+  d = memb_alloc(&buframmem);
+  if(d == NULL && swap_out_oldest() == 0) {
+    d = memb_alloc(&buframmem);
+  }
+  if(d != NULL) {
+    i = d - buframmem_memb_mem;
+    ram_owner[i] = b;
+    ram_age[i] = next_age++;
+    b->location = IN_RAM;
+  }
+  return d;
+}
+/*---------------------------------------------------------------------------*/
+static void
+ram_free(struct queuebuf_data *d)
+{
+  ram_owner[d - buframmem_memb_mem] = NULL;
+  memb_free(&buframmem, d);
+}
+/*---------------------------------------------------------------------------*/
 /* If the queuebuf is in CFS, load it to tmpdata */
 static struct queuebuf_data *
 queuebuf_load_to_ram(struct queuebuf *b)
 {
-  int fileid, fd, ret;
-  cfs_offset_t offset;
-  if(b->location == IN_RAM) { /* the qbuf is loacted in RAM */
+  if(b->location == IN_RAM) {
     return b->ram_ptr;
-  } else { /* the qbuf is located in CFS */
-    if(tmpdata_qbuf && tmpdata_qbuf->swap_id == b->swap_id) { /* the qbuf is already in tmpdata */
-      return &tmpdata;
-    } else { /* the qbuf needs to be loaded from CFS */
+  }
+  if(tmpdata_qbuf != b) {
+    tmpdata_qbuf = NULL;
+    if(swap_read(b, &tmpdata) == 0) {
       tmpdata_qbuf = b;
-      /* read the qbuf from CFS */
-      fileid = b->swap_id / NQBUF_PER_FILE;
-      offset = (b->swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
-      fd = qbuf_files[fileid].fd;
-      ret = cfs_seek(fd, offset, CFS_SEEK_SET);
-      if(ret == -1) {
-        PRINTF("queuebuf_load_to_ram: cfs seek error\n");
-      }
-      ret = cfs_read(fd, &tmpdata, sizeof(struct queuebuf_data));
-      if(ret == -1) {
-        PRINTF("queuebuf_load_to_ram: cfs read error\n");
-      }
-      return &tmpdata;
     }
   }
+  return &tmpdata;
+}
+/*---------------------------------------------------------------------------*/
+/* Appends the updated tmpdata of a swapped queuebuf to the log again */
+static void
+swap_rewrite(struct queuebuf *b)
+{
+  uint16_t segment, offset;
+
+  if(swap_append(&tmpdata, &segment, &offset) < 0) {
+    /* The update is lost: read the record as it was */
+    PRINTF("queuebuf swap_rewrite: swap full\n");
+    tmpdata_qbuf = NULL;
+    return;
+  }
+  swap_release(b);
+  b->swap.segment = segment;
+  b->swap.offset = offset;
+  tmpdata_qbuf = b;
 }
 #else /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
 static struct queuebuf_data *
+ram_alloc(struct queuebuf *b)
+{
+  return memb_alloc(&buframmem);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ram_free(struct queuebuf_data *d)
+{
+  memb_free(&buframmem, d);
+}
+/*---------------------------------------------------------------------------*/
+static struct queuebuf_data *
 queuebuf_load_to_ram(struct queuebuf *b)
 {
   return b->ram_ptr;
 }
 #endif /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_COMPACT_ATTRS
+/* The full attribute array of a queuebuf, or NULL if it has none */
+static struct queuebuf_attrs *
+full_attrs(struct queuebuf *b)
+{
+  int i;
+
+  for(i = 0; full_attrs_used > 0 && i < QUEUEBUF_FULL_ATTRS_NUM; i++) {
+    if(attrmem_memb_mem[i].owner == b) {
+      return &attrmem_memb_mem[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+full_attrs_free(struct queuebuf_attrs *a)
+{
+  if(a != NULL) {
+    a->owner = NULL;
+    memb_free(&attrmem, a);
+    full_attrs_used--;
+  }
+}
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+/*---------------------------------------------------------------------------*/
+/* Copies the attributes of packetbuf to a queuebuf holding len bytes of
+   data. Returns -1 if they do not fit. */
+static int
+attrs_from_packetbuf(struct queuebuf *b, struct queuebuf_data *d,
+                     uint16_t len)
+{
+#if QUEUEBUF_COMPACT_ATTRS
+  struct queuebuf_attrs *full;
+  uint32_t present;
+
+  full = full_attrs(b);
+  if(packetbuf_attr_pack(&present, &d->data[len],
+                         sizeof(d->data) - len, d->addrs) >= 0) {
+    full_attrs_free(full);
+    d->attrs_present = present;
+    return 0;
+  }
+
+  /* Too many for the room left by the packet: keep the full array */
+  if(full == NULL) {
+    full = memb_alloc(&attrmem);
+    if(full == NULL) {
+      return -1;
+    }
+    full->owner = b;
+    full_attrs_used++;
+  }
+  packetbuf_attr_copyto(full->attrs, d->addrs);
+  d->attrs_present = ATTRS_FULL;
+  return 0;
+#else /* QUEUEBUF_COMPACT_ATTRS */
+  packetbuf_attr_copyto(d->attrs, d->addrs);
+  return 0;
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+}
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_init(void)
 {
 #if WITH_SWAP
   int i;
-  for(i=0; i<NQBUF_FILES; i++) {
-    qbuf_files[i].renewable = 1;
-    qbuf_renew_file(i);
+  /* Remove the segments left by a previous run */
+  for(i = 0; i < NUM_SEGMENTS; i++) {
+    segment_remove(i);
+    segment_live[i] = 0;
   }
+  memset(ram_owner, 0, sizeof(ram_owner));
+  write_segment = 0;
+  write_flushed = 0;
+  batch_len = 0;
+  tmpdata_qbuf = NULL;
 #endif
   memb_init(&buframmem);
   memb_init(&bufmem);
+#if QUEUEBUF_COMPACT_ATTRS
+  memb_init(&attrmem);
+  full_attrs_used = 0;
+#endif /* QUEUEBUF_COMPACT_ATTRS */
 #if QUEUEBUF_STATS
   queuebuf_max_len = 0;
 #endif /* QUEUEBUF_STATS */
@@ -300,58 +724,41 @@ queuebuf_numfree(void)
   return memb_numfree(&bufmem);
 }
 /*---------------------------------------------------------------------------*/
-#if QUEUEBUF_DEBUG
-struct queuebuf *
-queuebuf_new_from_packetbuf_debug(const char *file, int line)
-#else /* QUEUEBUF_DEBUG */
-struct queuebuf *
-queuebuf_new_from_packetbuf(void)
-#endif /* QUEUEBUF_DEBUG */
+static struct queuebuf *
+new_from_packetbuf(bool hold)
 {
   struct queuebuf *buf;
 
   struct queuebuf_data *buframptr;
   buf = memb_alloc(&bufmem);
   if(buf != NULL) {
-#if QUEUEBUF_DEBUG
-    list_add(queuebuf_list, buf);
-    buf->file = file;
-    buf->line = line;
-    buf->time = clock_time();
-#endif /* QUEUEBUF_DEBUG */
-    buf->ram_ptr = memb_alloc(&buframmem);
-#if WITH_SWAP
-    /* If the allocation failed, store the qbuf in swap files */
-    if(buf->ram_ptr != NULL) {
-      buf->location = IN_RAM;
-      buframptr = buf->ram_ptr;
-    } else {
-      buf->location = IN_CFS;
-      buf->swap_id = -1;
-      tmpdata_qbuf = buf;
-      buframptr = &tmpdata;
+#if PACKETBUF_POOL_NUM
+    buf->held = hold ? packetbuf_hold() : NULL;
+    if(buf->held != NULL) {
+#if QUEUEBUF_STATS
+      ++queuebuf_len;
+      if(queuebuf_len > queuebuf_max_len) {
+        queuebuf_max_len = queuebuf_len;
+      }
+#endif /* QUEUEBUF_STATS */
+      return buf;
     }
-#else
+#endif /* PACKETBUF_POOL_NUM */
+    buf->ram_ptr = ram_alloc(buf);
     if(buf->ram_ptr == NULL) {
       PRINTF("queuebuf_new_from_packetbuf: could not queuebuf data\n");
       memb_free(&bufmem, buf);
       return NULL;
     }
     buframptr = buf->ram_ptr;
-#endif
 
     buframptr->len = packetbuf_copyto(buframptr->data);
-    packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
-
-#if WITH_SWAP
-    if(buf->location == IN_CFS) {
-      if(queuebuf_flush_tmpdata() == -1) {
-        /* We were unable to write the data in the swap */
-        memb_free(&bufmem, buf);
-        return NULL;
-      }
+    if(attrs_from_packetbuf(buf, buframptr, buframptr->len) < 0) {
+      PRINTF("queuebuf_new_from_packetbuf: attributes do not fit\n");
+      ram_free(buf->ram_ptr);
+      memb_free(&bufmem, buf);
+      return NULL;
     }
-#endif
 
 #if QUEUEBUF_STATS
     ++queuebuf_len;
@@ -367,14 +774,63 @@ queuebuf_new_from_packetbuf(void)
   return buf;
 }
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_DEBUG
+static struct queuebuf *
+debug_add(struct queuebuf *buf, const char *file, int line)
+{
+  if(buf != NULL) {
+    list_add(queuebuf_list, buf);
+    buf->file = file;
+    buf->line = line;
+    buf->time = clock_time();
+  }
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_new_from_packetbuf_debug(const char *file, int line)
+{
+  return debug_add(new_from_packetbuf(false), file, line);
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_hold_packetbuf_debug(const char *file, int line)
+{
+  return debug_add(new_from_packetbuf(true), file, line);
+}
+#else /* QUEUEBUF_DEBUG */
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_new_from_packetbuf(void)
+{
+  return new_from_packetbuf(false);
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_hold_packetbuf(void)
+{
+  return new_from_packetbuf(true);
+}
+#endif /* QUEUEBUF_DEBUG */
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
-  packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+  struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+  if(buf->held != NULL) {
+    packetbuf_held_update(buf->held, false);
+    return;
+  }
+#endif /* PACKETBUF_POOL_NUM */
+  buframptr = queuebuf_load_to_ram(buf);
+  if(attrs_from_packetbuf(buf, buframptr, buframptr->len) < 0) {
+    PRINTF("queuebuf_update_attr_from_packetbuf: attributes do not fit\n");
+    return;
+  }
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
-    queuebuf_flush_tmpdata();
+    swap_rewrite(buf);
   }
 #endif
 }
@@ -382,29 +838,56 @@ queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 void
 queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
-  packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+  struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+  if(buf->held != NULL) {
+    packetbuf_held_update(buf->held, true);
+    return;
+  }
+#endif /* PACKETBUF_POOL_NUM */
+  buframptr = queuebuf_load_to_ram(buf);
+  if(attrs_from_packetbuf(buf, buframptr, packetbuf_totlen()) < 0) {
+    PRINTF("queuebuf_update_from_packetbuf: attributes do not fit\n");
+    return;
+  }
   buframptr->len = packetbuf_copyto(buframptr->data);
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
-    queuebuf_flush_tmpdata();
+    swap_rewrite(buf);
+  }
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_data(struct queuebuf *buf)
+{
+#if QUEUEBUF_COMPACT_ATTRS
+  full_attrs_free(full_attrs(buf));
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+#if WITH_SWAP
+  if(buf->location == IN_CFS) {
+    swap_release(buf);
+    /* swap_clean() goes through all queuebufs, including free ones */
+    buf->location = IN_RAM;
+    return;
   }
 #endif
+  ram_free(buf->ram_ptr);
 }
 /*---------------------------------------------------------------------------*/
 void
 queuebuf_free(struct queuebuf *buf)
 {
   if(memb_inmemb(&bufmem, buf)) {
-#if WITH_SWAP
-    if(buf->location == IN_RAM) {
-      memb_free(&buframmem, buf->ram_ptr);
+#if PACKETBUF_POOL_NUM
+    if(buf->held != NULL) {
+      packetbuf_release(buf->held);
     } else {
-      queuebuf_remove_from_file(buf->swap_id);
+      free_data(buf);
     }
-#else
-    memb_free(&buframmem, buf->ram_ptr);
-#endif
+#else /* PACKETBUF_POOL_NUM */
+    free_data(buf);
+#endif /* PACKETBUF_POOL_NUM */
     memb_free(&bufmem, buf);
 #if QUEUEBUF_STATS
     --queuebuf_len;
@@ -420,9 +903,26 @@ void
 queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
-    struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+    struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+    if(b->held != NULL) {
+      packetbuf_select(b->held);
+      return;
+    }
+#endif /* PACKETBUF_POOL_NUM */
+    buframptr = queuebuf_load_to_ram(b);
     packetbuf_copyfrom(buframptr->data, buframptr->len);
+#if QUEUEBUF_COMPACT_ATTRS
+    if(buframptr->attrs_present == ATTRS_FULL) {
+      packetbuf_attr_copyfrom(full_attrs(b)->attrs, buframptr->addrs);
+    } else {
+      packetbuf_attr_unpack(buframptr->attrs_present,
+                            &buframptr->data[buframptr->len],
+                            buframptr->addrs);
+    }
+#else /* QUEUEBUF_COMPACT_ATTRS */
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+#endif /* QUEUEBUF_COMPACT_ATTRS */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -430,7 +930,13 @@ void *
 queuebuf_dataptr(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
-    struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+    struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+    if(b->held != NULL) {
+      return packetbuf_held_dataptr(b->held);
+    }
+#endif /* PACKETBUF_POOL_NUM */
+    buframptr = queuebuf_load_to_ram(b);
     return buframptr->data;
   }
   return NULL;
@@ -439,22 +945,48 @@ queuebuf_dataptr(struct queuebuf *b)
 int
 queuebuf_datalen(struct queuebuf *b)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+  if(b->held != NULL) {
+    return packetbuf_held_datalen(b->held);
+  }
+#endif /* PACKETBUF_POOL_NUM */
+  buframptr = queuebuf_load_to_ram(b);
   return buframptr->len;
 }
 /*---------------------------------------------------------------------------*/
 linkaddr_t *
 queuebuf_addr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+  if(b->held != NULL) {
+    return packetbuf_held_addr(b->held, type);
+  }
+#endif /* PACKETBUF_POOL_NUM */
+  buframptr = queuebuf_load_to_ram(b);
   return &buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr;
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 queuebuf_attr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  struct queuebuf_data *buframptr;
+#if PACKETBUF_POOL_NUM
+  if(b->held != NULL) {
+    return packetbuf_held_attr(b->held, type);
+  }
+#endif /* PACKETBUF_POOL_NUM */
+  buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_COMPACT_ATTRS
+  if(buframptr->attrs_present == ATTRS_FULL) {
+    return full_attrs(b)->attrs[type].val;
+  }
+  return packetbuf_attr_packed(buframptr->attrs_present,
+                               &buframptr->data[buframptr->len], type);
+#else /* QUEUEBUF_COMPACT_ATTRS */
   return buframptr->attrs[type].val;
+#endif /* QUEUEBUF_COMPACT_ATTRS */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -71,7 +71,8 @@
 
 /* QUEUEBUFRAM_NUM is the number of queuebufs stored in RAM.
    If QUEUEBUFRAM_CONF_NUM is set lower than QUEUEBUF_NUM,
-   swapping is enabled and queuebufs are stored either in RAM of CFS.
+   swapping is enabled and queuebufs are stored either in RAM of CFS:
+   beyond QUEUEBUFRAM_NUM, the oldest queuebufs are moved to CFS.
    If QUEUEBUFRAM_CONF_NUM is unset or >= to QUEUEBUF_NUM, all
    queuebufs are in RAM and swapping is disabled. */
 #ifdef QUEUEBUFRAM_CONF_NUM
@@ -86,6 +87,72 @@
   #define WITH_SWAP 0
 #endif /* QUEUEBUFRAM_CONF_NUM */
 
+#if WITH_SWAP
+/* The swap is a log of CFS segment files of QUEUEBUF_SWAP_SEGMENT_SIZE
+   bytes. A segment file is removed once all its queuebufs are freed, or
+   once its live queuebufs have been moved to the end of the log to free
+   a segment. The swap takes up to (QUEUEBUF_NUM - QUEUEBUFRAM_NUM + 1) /
+   (QUEUEBUF_SWAP_SEGMENT_SIZE / sizeof(struct queuebuf_data)) + 2
+   segment files. */
+#ifdef QUEUEBUF_CONF_SWAP_SEGMENT_SIZE
+#define QUEUEBUF_SWAP_SEGMENT_SIZE QUEUEBUF_CONF_SWAP_SEGMENT_SIZE
+#else /* QUEUEBUF_CONF_SWAP_SEGMENT_SIZE */
+#define QUEUEBUF_SWAP_SEGMENT_SIZE 4096
+#endif /* QUEUEBUF_CONF_SWAP_SEGMENT_SIZE */
+
+#if QUEUEBUF_SWAP_SEGMENT_SIZE > 65535
+#error "QUEUEBUF_CONF_SWAP_SEGMENT_SIZE cannot be greater than 65535"
+#endif
+
+/* Queuebufs are written to the swap in batches of at least
+   QUEUEBUF_SWAP_BATCH, which costs as many buffers of RAM. */
+#ifdef QUEUEBUF_CONF_SWAP_BATCH
+#define QUEUEBUF_SWAP_BATCH QUEUEBUF_CONF_SWAP_BATCH
+#else /* QUEUEBUF_CONF_SWAP_BATCH */
+#define QUEUEBUF_SWAP_BATCH 4
+#endif /* QUEUEBUF_CONF_SWAP_BATCH */
+
+/* With Coffee, reserve the space of each segment file on creation */
+#ifdef QUEUEBUF_CONF_SWAP_COFFEE
+#define QUEUEBUF_SWAP_COFFEE QUEUEBUF_CONF_SWAP_COFFEE
+#else /* QUEUEBUF_CONF_SWAP_COFFEE */
+#define QUEUEBUF_SWAP_COFFEE 0
+#endif /* QUEUEBUF_CONF_SWAP_COFFEE */
+
+struct queuebuf_swap_stats {
+  uint32_t records; /* Queuebufs written to the swap */
+  uint32_t writes;  /* Writes to CFS */
+  uint32_t reads;   /* Reads from CFS */
+  uint32_t cleanings; /* Segments freed by moving their live queuebufs */
+};
+extern struct queuebuf_swap_stats queuebuf_swap_stats;
+#endif /* WITH_SWAP */
+
+/* When non-zero, a queuebuf stores only the packet attributes that are
+   non-zero, packed after the packet data, instead of the full attribute
+   array. QUEUEBUF_ATTRS_NUM attributes always fit; shorter packets leave
+   room for more. A packet whose attributes do not fit takes one of
+   QUEUEBUF_FULL_ATTRS_NUM full attribute arrays, and is only refused once
+   they are all taken. "make viewconf" shows these settings and the size
+   of a queuebuf. */
+#ifdef QUEUEBUF_CONF_COMPACT_ATTRS
+#define QUEUEBUF_COMPACT_ATTRS QUEUEBUF_CONF_COMPACT_ATTRS
+#else /* QUEUEBUF_CONF_COMPACT_ATTRS */
+#define QUEUEBUF_COMPACT_ATTRS 0
+#endif /* QUEUEBUF_CONF_COMPACT_ATTRS */
+
+#ifdef QUEUEBUF_CONF_ATTRS_NUM
+#define QUEUEBUF_ATTRS_NUM QUEUEBUF_CONF_ATTRS_NUM
+#else /* QUEUEBUF_CONF_ATTRS_NUM */
+#define QUEUEBUF_ATTRS_NUM 4
+#endif /* QUEUEBUF_CONF_ATTRS_NUM */
+
+#ifdef QUEUEBUF_CONF_FULL_ATTRS_NUM
+#define QUEUEBUF_FULL_ATTRS_NUM QUEUEBUF_CONF_FULL_ATTRS_NUM
+#else /* QUEUEBUF_CONF_FULL_ATTRS_NUM */
+#define QUEUEBUF_FULL_ATTRS_NUM 2
+#endif /* QUEUEBUF_CONF_FULL_ATTRS_NUM */
+
 #ifdef QUEUEBUF_CONF_DEBUG
 #define QUEUEBUF_DEBUG QUEUEBUF_CONF_DEBUG
 #else /* QUEUEBUF_CONF_DEBUG */
@@ -99,8 +166,17 @@ void queuebuf_init(void);
 #if QUEUEBUF_DEBUG
 struct queuebuf *queuebuf_new_from_packetbuf_debug(const char *file, int line);
 #define queuebuf_new_from_packetbuf() queuebuf_new_from_packetbuf_debug(__FILE__, __LINE__)
+struct queuebuf *queuebuf_hold_packetbuf_debug(const char *file, int line);
+#define queuebuf_hold_packetbuf() queuebuf_hold_packetbuf_debug(__FILE__, __LINE__)
 #else /* QUEUEBUF_DEBUG */
 struct queuebuf *queuebuf_new_from_packetbuf(void);
+/* Like queuebuf_new_from_packetbuf(), but with a packetbuf pool
+   (PACKETBUF_CONF_POOL_NUM), keeps a reference to the packet instead of a
+   copy whenever the pool allows it. The caller must then leave the packet
+   as it is, and start the next one with packetbuf_clear() or
+   packetbuf_copyfrom(). queuebuf_to_packetbuf() makes the packet current
+   again without a copy. */
+struct queuebuf *queuebuf_hold_packetbuf(void);
 #endif /* QUEUEBUF_DEBUG */
 void queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
 void queuebuf_update_from_packetbuf(struct queuebuf *b);
@@ -1134,7 +1134,8 @@ handle_dao_retransmission(void *ptr)
 
   ctimer_set(&instance->dao_retransmit_timer,
              RPL_DAO_RETRANSMISSION_TIMEOUT / 2 +
-             (random_rand() % (RPL_DAO_RETRANSMISSION_TIMEOUT / 2)),
+             random_stream_range(RANDOM_STREAM_RPL,
+                                 RPL_DAO_RETRANSMISSION_TIMEOUT / 2),
              handle_dao_retransmission, parent);
 
   instance->my_dao_transmissions++;
@@ -119,7 +119,7 @@ new_dio_interval(rpl_instance_t *instance)
   instance->dio_next_delay = ticks;
 
   /* Random number between I/2 and I. */
-  ticks = ticks / 2 + (ticks / 2 * (uint32_t)random_rand()) / RANDOM_RAND_MAX;
+  ticks = ticks / 2 + random_stream_range(RANDOM_STREAM_RPL, ticks / 2 + 1);
 
   /*
    * The intervals must be equally long among the nodes for Trickle to
@@ -205,7 +205,7 @@ void
 rpl_reset_periodic_timer(void)
 {
   next_dis = RPL_DIS_INTERVAL / 2 +
-    ((uint32_t)RPL_DIS_INTERVAL * (uint32_t)random_rand()) / RANDOM_RAND_MAX -
+    random_stream_range(RANDOM_STREAM_RPL, RPL_DIS_INTERVAL + 1) -
     RPL_DIS_START_DELAY;
   ctimer_set(&periodic_timer, CLOCK_SECOND, handle_periodic_timer, NULL);
 }
@@ -255,7 +255,8 @@ set_dao_lifetime_timer(rpl_instance_t *instance)
 
     /* Make the time for the re-registration to be between 1/2 and 3/4 of
        the lifetime. */
-    expiration_time = expiration_time + (random_rand() % (expiration_time / 2));
+    expiration_time = expiration_time +
+      random_stream_range(RANDOM_STREAM_RPL, expiration_time / 2);
     LOG_DBG("Scheduling DAO lifetime timer %u ticks in the future\n",
             (unsigned)expiration_time);
     ctimer_set(&instance->dao_lifetime_timer, expiration_time,
@@ -337,7 +338,7 @@ schedule_dao(rpl_instance_t *instance, clock_time_t latency)
   } else {
     if(latency != 0) {
       expiration_time = latency / 2 +
-        (random_rand() % (latency));
+        random_stream_range(RANDOM_STREAM_RPL, latency);
     } else {
       expiration_time = 0;
     }
@@ -391,7 +392,8 @@ rpl_schedule_unicast_dio_immediately(rpl_instance_t *instance)
 clock_time_t
 get_probing_delay(rpl_dag_t *dag)
 {
-  return ((RPL_PROBING_INTERVAL) / 2) + random_rand() % (RPL_PROBING_INTERVAL);
+  return ((RPL_PROBING_INTERVAL) / 2) +
+    random_stream_range(RANDOM_STREAM_RPL, RPL_PROBING_INTERVAL);
 }
 /*---------------------------------------------------------------------------*/
 rpl_parent_t *
@@ -429,7 +431,7 @@ get_probing_target(rpl_dag_t *dag)
   }
 
   /* With 50% probability: probe best non-fresh parent. */
-  if(random_rand() % 2 == 0) {
+  if(random_stream_range(RANDOM_STREAM_RPL, 2) == 0) {
     p = nbr_table_head(rpl_parents);
     while(p != NULL) {
       if(p->dag == dag && !rpl_parent_is_fresh(p)) {
@@ -524,7 +526,8 @@ rpl_schedule_probing(rpl_instance_t *instance)
 void
 rpl_schedule_probing_now(rpl_instance_t *instance)
 {
-  ctimer_set(&instance->probing_timer, random_rand() % (CLOCK_SECOND * 4),
+  ctimer_set(&instance->probing_timer,
+             random_stream_range(RANDOM_STREAM_RPL, CLOCK_SECOND * 4),
              handle_probing_timer, instance);
 }
 #endif /* RPL_WITH_PROBING */
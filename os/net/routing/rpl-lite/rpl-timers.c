@@ -93,7 +93,7 @@ void
 rpl_timers_schedule_periodic_dis(void)
 {
   if(ctimer_expired(&dis_timer)) {
-    clock_time_t expiration_time = RPL_DIS_INTERVAL / 2 + (random_rand() % (RPL_DIS_INTERVAL));
+    clock_time_t expiration_time = RPL_DIS_INTERVAL / 2 + random_stream_range(RANDOM_STREAM_RPL, RPL_DIS_INTERVAL);
     ctimer_set(&dis_timer, expiration_time, handle_dis_timer, NULL);
   }
 }
@@ -126,7 +126,7 @@ new_dio_interval(void)
   curr_instance.dag.dio_next_delay = ticks;
 
   /* random number between I/2 and I */
-  ticks = ticks / 2 + (ticks / 2 * (uint32_t)random_rand()) / RANDOM_RAND_MAX;
+  ticks = ticks / 2 + random_stream_range(RANDOM_STREAM_RPL, ticks / 2 + 1);
 
   /*
    * The intervals must be equally long among the nodes for Trickle to
@@ -230,7 +230,7 @@ handle_unicast_dio_timer(void *ptr)
 static void
 schedule_dao_retransmission(void)
 {
-  clock_time_t expiration_time = RPL_DAO_RETRANSMISSION_TIMEOUT / 2 + (random_rand() % (RPL_DAO_RETRANSMISSION_TIMEOUT));
+  clock_time_t expiration_time = RPL_DAO_RETRANSMISSION_TIMEOUT / 2 + random_stream_range(RANDOM_STREAM_RPL, RPL_DAO_RETRANSMISSION_TIMEOUT);
   ctimer_set(&curr_instance.dag.dao_timer, expiration_time, resend_dao, NULL);
 }
 #endif /* RPL_WITH_DAO_ACK */
@@ -248,7 +248,7 @@ schedule_dao_refresh(void)
 #endif /* RPL_WITH_DAO_ACK */
 
     /* Send between 60 and 120 seconds before target refresh */
-    clock_time_t safety_margin = (60 * CLOCK_SECOND) + (random_rand() % (60 * CLOCK_SECOND));
+    clock_time_t safety_margin = (60 * CLOCK_SECOND) + random_stream_range(RANDOM_STREAM_RPL, 60 * CLOCK_SECOND);
 
     if(target_refresh > safety_margin) {
       target_refresh -= safety_margin;
@@ -266,7 +266,7 @@ rpl_timers_schedule_dao(void)
     /* No need for DAO aggregation delay as per RFC 6550 section 9.5, as this
     * only serves storing mode. Use simple delay instead, with the only purpose
     * to reduce congestion. */
-    clock_time_t expiration_time = RPL_DAO_DELAY / 2 + (random_rand() % (RPL_DAO_DELAY));
+    clock_time_t expiration_time = RPL_DAO_DELAY / 2 + random_stream_range(RANDOM_STREAM_RPL, RPL_DAO_DELAY);
     ctimer_set(&curr_instance.dag.dao_timer, expiration_time, send_new_dao, NULL);
   }
 }
@@ -349,7 +349,8 @@ resend_dao(void *ptr)
 clock_time_t
 get_probing_delay(void)
 {
-  return ((RPL_PROBING_INTERVAL) / 2) + random_rand() % (RPL_PROBING_INTERVAL);
+  return ((RPL_PROBING_INTERVAL) / 2) +
+    random_stream_range(RANDOM_STREAM_RPL, RPL_PROBING_INTERVAL);
 }
 /*---------------------------------------------------------------------------*/
 rpl_nbr_t *
@@ -385,7 +386,7 @@ get_probing_target(void)
   /* Now consider probing other non-fresh neighbors. With 2/3 proabability,
   pick the best non-fresh. Otherwise, pick the lest recently updated non-fresh. */
 
-  if(random_rand() % 3 != 0) {
+  if(random_stream_range(RANDOM_STREAM_RPL, 3) != 0) {
     /* Look for best non-fresh */
     nbr = nbr_table_head(rpl_neighbors);
     while(nbr != NULL) {
@@ -464,7 +465,8 @@ rpl_schedule_probing_now(void)
 {
   if(curr_instance.used) {
     ctimer_set(&curr_instance.dag.probing_timer,
-      random_rand() % (CLOCK_SECOND * 4), handle_probing_timer, NULL);
+      random_stream_range(RANDOM_STREAM_RPL, CLOCK_SECOND * 4),
+      handle_probing_timer, NULL);
   }
 }
 #endif /* RPL_WITH_PROBING */
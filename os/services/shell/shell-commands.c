@@ -386,6 +386,46 @@ PT_THREAD(cmd_help(struct pt *pt, shell_output_func output, char *args))
 
   PT_END(pt);
 }
+#if PROCESS_CONF_PROFILE
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_process_profile(struct pt *pt, shell_output_func output, char *args))
+{
+  struct process *p;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+
+  /* Get and parse argument: optional reset */
+  SHELL_ARGS_NEXT(args, next_args);
+  if(args != NULL) {
+    if(strcmp(args, "reset")) {
+      SHELL_OUTPUT(output, "Invalid argument: %s\n", args);
+    } else {
+      process_profile_reset();
+      SHELL_OUTPUT(output, "Process profiles cleared\n");
+    }
+    PT_EXIT(pt);
+  }
+
+  SHELL_OUTPUT(output, "Process profiles (times in rtimer ticks, %lu per second):\n",
+               (unsigned long)RTIMER_SECOND);
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    SHELL_OUTPUT(output, "-- %s: calls %lu, run %lu (max %lu), wait avg %lu (max %lu)\n",
+                 PROCESS_NAME_STRING(p),
+                 (unsigned long)p->profile.calls,
+                 (unsigned long)p->profile.run_time,
+                 (unsigned long)p->profile.max_run_time,
+                 (unsigned long)(p->profile.waits == 0 ? 0 :
+                                 p->profile.wait_time / p->profile.waits),
+                 (unsigned long)p->profile.max_wait_time);
+  }
+
+  PT_END(pt);
+}
+#endif /* PROCESS_CONF_PROFILE */
 #if UIP_CONF_IPV6_RPL
 /*---------------------------------------------------------------------------*/
 static
@@ -981,6 +1021,9 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#if PROCESS_CONF_PROFILE
+  { "process-profile",      cmd_process_profile,      "'> process-profile [reset]': Shows the run and wait times of all processes, or clears them" },
+#endif /* PROCESS_CONF_PROFILE */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
@@ -54,6 +54,7 @@
 #define LOG_LEVEL LOG_LEVEL_INFO
 
 static uint64_t last_tx, last_rx, last_time, last_cpu, last_lpm, last_deep_lpm;
+static uint32_t last_wakeups, last_wakeups_avoided;
 
 PROCESS(simple_energest_process, "Simple Energest");
 /*---------------------------------------------------------------------------*/
@@ -98,6 +99,9 @@ simple_energest_step(void)
   log_energest("Radio Rx", curr_rx - last_rx, delta_time);
   log_energest("Radio total", curr_tx - last_tx + curr_rx - last_rx,
                delta_time);
+  LOG_INFO("Wake-ups    : %10"PRIu32" (%"PRIu32" avoided)\n",
+           energest_wakeups - last_wakeups,
+           energest_wakeups_avoided - last_wakeups_avoided);
 
   last_time = curr_time;
   last_cpu = curr_cpu;
@@ -105,6 +109,8 @@ simple_energest_step(void)
   last_deep_lpm = curr_deep_lpm;
   last_tx = curr_tx;
   last_rx = curr_rx;
+  last_wakeups = energest_wakeups;
+  last_wakeups_avoided = energest_wakeups_avoided;
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(simple_energest_process, ev, data)
@@ -131,6 +137,8 @@ simple_energest_init(void)
   last_deep_lpm = energest_type_time(ENERGEST_TYPE_DEEP_LPM);
   last_tx = energest_type_time(ENERGEST_TYPE_TRANSMIT);
   last_rx = energest_type_time(ENERGEST_TYPE_LISTEN);
+  last_wakeups = energest_wakeups;
+  last_wakeups_avoided = energest_wakeups_avoided;
   process_start(&simple_energest_process, NULL);
 }
 
@@ -43,12 +43,22 @@
  */
 
 #include "sys/ctimer.h"
+#include "sys/deferred.h"
 #include "contiki.h"
 #include "lib/list.h"
 
 LIST(ctimer_list);
 
+#if CTIMER_SORTED
+/* The timers whose callbacks are called in the current dispatch. */
+LIST(ctimer_due_list);
+
+/* The event timer for the first timer in ctimer_list. */
+static struct etimer next_etimer;
+static bool dispatching;
+#else /* CTIMER_SORTED */
 static char initialized;
+#endif /* CTIMER_SORTED */
 
 #define DEBUG 0
 #if DEBUG
@@ -58,11 +68,189 @@ static char initialized;
 #define PRINTF(...)
 #endif
 
-/*---------------------------------------------------------------------------*/
 PROCESS(ctimer_process, "Ctimer process");
+#if CTIMER_SORTED
+/*---------------------------------------------------------------------------*/
+static int
+expires_before(struct ctimer *a, struct ctimer *b)
+{
+  clock_time_t diff;
+
+  /* Compare through the difference to handle clock wraps. */
+  diff = etimer_expiration_time(&a->etimer) -
+         etimer_expiration_time(&b->etimer);
+  return diff > (clock_time_t)~(clock_time_t)0 / 2;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_etimer(void)
+{
+  struct ctimer *c;
+
+  c = list_head(ctimer_list);
+  if(c == NULL) {
+    etimer_stop(&next_etimer);
+    return;
+  }
+  if(!etimer_expired(&next_etimer) &&
+     etimer_expiration_time(&next_etimer) ==
+     etimer_expiration_time(&c->etimer)) {
+    return;
+  }
+
+  PROCESS_CONTEXT_BEGIN(&ctimer_process);
+  etimer_set(&next_etimer, timer_expired(&c->etimer.timer) ?
+             0 : timer_remaining(&c->etimer.timer));
+  PROCESS_CONTEXT_END(&ctimer_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_timer(struct ctimer *c)
+{
+  struct ctimer *first;
+
+  first = list_head(ctimer_list);
+  list_remove(ctimer_list, c);
+  list_remove(ctimer_due_list, c);
+  c->etimer.p = PROCESS_NONE;
+  if(c == first && !dispatching) {
+    update_etimer();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_timer(struct ctimer *c)
+{
+  struct ctimer *t, *prev;
+
+  list_remove(ctimer_list, c);
+  list_remove(ctimer_due_list, c);
+
+  /* Timers with the same expiration time are called in the order in
+     which they were set. */
+  prev = NULL;
+  for(t = list_head(ctimer_list); t != NULL && !expires_before(c, t);
+      t = t->next) {
+    prev = t;
+  }
+  list_insert(ctimer_list, prev, c);
+  c->etimer.p = &ctimer_process;
+
+  if(prev == NULL && !dispatching) {
+    update_etimer();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+dispatch(void)
+{
+  struct ctimer *c, *tail;
+
+  /* Move the expired timers to the due list first, so that timers
+     that are set again by their callbacks are called in the next
+     dispatch. */
+  tail = NULL;
+  while((c = list_head(ctimer_list)) != NULL &&
+        timer_expired(&c->etimer.timer)) {
+    list_pop(ctimer_list);
+    c->next = NULL;
+    if(tail == NULL) {
+      list_push(ctimer_due_list, c);
+    } else {
+      tail->next = c;
+    }
+    tail = c;
+  }
+
+  dispatching = true;
+  while((c = list_pop(ctimer_due_list)) != NULL) {
+    c->etimer.p = PROCESS_NONE;
+    PROCESS_CONTEXT_BEGIN(c->p);
+    if(c->f != NULL) {
+      c->f(c->ptr);
+    }
+    PROCESS_CONTEXT_END(c->p);
+  }
+  dispatching = false;
+
+  update_etimer();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ctimer_process, ev, data)
+{
+  PROCESS_POLLHANDLER(deferred_run());
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+    dispatch();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_init(void)
+{
+  list_init(ctimer_list);
+  list_init(ctimer_due_list);
+  dispatching = false;
+  deferred_init();
+  process_start(&ctimer_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set(struct ctimer *c, clock_time_t t,
+           void (*f)(void *), void *ptr)
+{
+  ctimer_set_with_process(c, t, f, ptr, PROCESS_CURRENT());
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set_with_process(struct ctimer *c, clock_time_t t,
+                        void (*f)(void *), void *ptr, struct process *p)
+{
+  PRINTF("ctimer_set %p %lu\n", c, (unsigned long)t);
+  c->p = p;
+  c->f = f;
+  c->ptr = ptr;
+  timer_set(&c->etimer.timer, t);
+  add_timer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_reset(struct ctimer *c)
+{
+  timer_reset(&c->etimer.timer);
+  add_timer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_restart(struct ctimer *c)
+{
+  timer_restart(&c->etimer.timer);
+  add_timer(c);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_stop(struct ctimer *c)
+{
+  remove_timer(c);
+}
+/*---------------------------------------------------------------------------*/
+int
+ctimer_expired(struct ctimer *c)
+{
+  return etimer_expired(&c->etimer);
+}
+#else /* CTIMER_SORTED */
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(ctimer_process, ev, data)
 {
   struct ctimer *c;
+
+  PROCESS_POLLHANDLER(deferred_run());
+
   PROCESS_BEGIN();
 
   for(c = list_head(ctimer_list); c != NULL; c = c->next) {
@@ -92,6 +280,7 @@ ctimer_init(void)
 {
   initialized = 0;
   list_init(ctimer_list);
+  deferred_init();
   process_start(&ctimer_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
@@ -171,5 +360,6 @@ ctimer_expired(struct ctimer *c)
   }
   return 1;
 }
+#endif /* CTIMER_SORTED */
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -58,6 +58,28 @@
 #include "contiki.h"
 #include "sys/etimer.h"
 
+/**
+ * \brief      Keep the pending callback timers in a sorted queue.
+ *
+ *             By default, each callback timer uses its own event
+ *             timer, so every callback timer is an entry in the event
+ *             timer list and each expiry costs one event. When this is
+ *             set to non-zero, the callback timers are instead kept
+ *             in a queue sorted by expiration time, behind a single
+ *             event timer for the first of them, and all the callbacks
+ *             that are due are called in one dispatch.
+ *
+ *             The etimer member of a callback timer still holds its
+ *             start time and interval, and etimer_expired() and
+ *             etimer_expiration_time() can still be used on it, but
+ *             it must not be passed to other event timer functions.
+ */
+#ifdef CTIMER_CONF_SORTED
+#define CTIMER_SORTED CTIMER_CONF_SORTED
+#else
+#define CTIMER_SORTED 0
+#endif
+
 struct ctimer {
   struct ctimer *next;
   struct etimer etimer;
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup deadline
+ * @{
+ */
+
+/**
+ * \file
+ *         Implementation of the next deadline service.
+ */
+
+#include "contiki.h"
+#include "sys/deadline.h"
+#include "sys/energest.h"
+#include "lib/list.h"
+
+/* The longest time ahead that a deadline can be expressed in rtimer
+   ticks, while still being ordered correctly by RTIMER_CLOCK_LT(). */
+#define MAX_AHEAD (RTIMER_CLOCK_MAX / 4)
+
+LIST(source_list);
+/*---------------------------------------------------------------------------*/
+void
+deadline_source_register(struct deadline_source *source)
+{
+  list_add(source_list, source);
+}
+/*---------------------------------------------------------------------------*/
+void
+deadline_source_unregister(struct deadline_source *source)
+{
+  list_remove(source_list, source);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_candidate(rtimer_clock_t now, rtimer_clock_t candidate,
+              rtimer_clock_t *deadline, int *found)
+{
+  /* Deadlines in the past are due now. */
+  if(RTIMER_CLOCK_LT(candidate, now)) {
+    candidate = now;
+  } else if((rtimer_clock_t)(candidate - now) > MAX_AHEAD) {
+    candidate = now + MAX_AHEAD;
+  }
+
+  if(!*found || RTIMER_CLOCK_LT(candidate, *deadline)) {
+    *deadline = candidate;
+    *found = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+deadline_next(rtimer_clock_t *deadline)
+{
+  struct deadline_source *source;
+  rtimer_clock_t now;
+  rtimer_clock_t candidate;
+  clock_time_t clock_now;
+  clock_time_t wait;
+  int found;
+
+  found = 0;
+  now = RTIMER_NOW();
+
+  /* Event timers, which also back the callback timers. */
+  if(etimer_pending()) {
+    clock_now = clock_time();
+    wait = etimer_next_expiration_time() - clock_now;
+    if(wait > (clock_time_t)~(clock_time_t)0 / 2) {
+      /* Already expired. */
+      wait = 0;
+    }
+    if((uint64_t)wait * RTIMER_SECOND / CLOCK_SECOND > MAX_AHEAD) {
+      candidate = now + MAX_AHEAD;
+    } else {
+      candidate = now + (rtimer_clock_t)((uint64_t)wait * RTIMER_SECOND /
+                                         CLOCK_SECOND);
+    }
+    add_candidate(now, candidate, deadline, &found);
+  }
+
+  if(rtimer_pending()) {
+    add_candidate(now, rtimer_next_expiration_time(), deadline, &found);
+  }
+
+  for(source = list_head(source_list);
+      source != NULL;
+      source = source->next) {
+    if(source->next_deadline != NULL && source->next_deadline(&candidate)) {
+      add_candidate(now, candidate, deadline, &found);
+    }
+  }
+
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+void
+deadline_wakeup(rtimer_clock_t slept, rtimer_clock_t period)
+{
+  /* Count the period boundaries that passed while sleeping, at each
+     of which the platform would otherwise have woken up. */
+  ENERGEST_WAKEUP(period > 0 && slept > 0 ? (slept - 1) / period : 0);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
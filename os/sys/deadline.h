@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the next deadline service.
+ */
+
+/** \addtogroup sys
+ * @{ */
+
+/**
+ * \defgroup deadline Next deadline service
+ *
+ * The next deadline service combines the expiration times of the
+ * event timers (and thereby the callback timers), the real-time
+ * timer, and any deadlines registered by other subsystems into a
+ * single wake-up time. Platforms can use it in their idle loop to
+ * sleep until the next time something is due, instead of waking up
+ * periodically to check.
+ *
+ * When energest is enabled, deadline_wakeup() counts the wake-ups and
+ * the wake-ups that were avoided by sleeping until the deadline.
+ *
+ * @{
+ */
+
+#ifndef DEADLINE_H_
+#define DEADLINE_H_
+
+#include "contiki.h"
+#include "sys/rtimer.h"
+
+/**
+ * A subsystem that has deadlines of its own, which are not covered
+ * by an etimer, ctimer or rtimer.
+ */
+struct deadline_source {
+  struct deadline_source *next;
+  /**
+   * \brief Get the next deadline of the subsystem.
+   * \param deadline Where to store the deadline, in rtimer ticks.
+   * \return Non-zero if the subsystem has a pending deadline.
+   */
+  int (* next_deadline)(rtimer_clock_t *deadline);
+};
+
+/**
+ * \brief Register a subsystem deadline source.
+ * \param source The deadline source.
+ */
+void deadline_source_register(struct deadline_source *source);
+
+/**
+ * \brief Remove a subsystem deadline source.
+ * \param source The deadline source.
+ */
+void deadline_source_unregister(struct deadline_source *source);
+
+/**
+ * \brief Get the next time at which the system must be awake.
+ * \param deadline Where to store the deadline, in rtimer ticks.
+ * \return Non-zero if there is a pending deadline.
+ *
+ *             Deadlines that are further away than a quarter of the
+ *             rtimer clock range are clamped, so the caller may wake
+ *             up before anything is due when the rtimer clock is
+ *             narrow.
+ */
+int deadline_next(rtimer_clock_t *deadline);
+
+/**
+ * \brief Account for a wake-up from idle.
+ * \param slept The time spent idle, in rtimer ticks.
+ * \param period The interval at which the platform would have woken
+ *               up without the deadline service, in rtimer ticks.
+ *
+ *             Platforms call this after waking up from a sleep whose
+ *             length was chosen with deadline_next(). The number of
+ *             periods that fully elapsed during the sleep is counted
+ *             as avoided wake-ups in energest.
+ */
+void deadline_wakeup(rtimer_clock_t slept, rtimer_clock_t period);
+
+#endif /* DEADLINE_H_ */
+
+/** @} */
+/** @} */
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup deferred
+ * @{
+ */
+
+/**
+ * \file
+ *         Implementation of the deferred work queue.
+ */
+
+#include "contiki.h"
+#include "sys/deferred.h"
+#include "sys/critical.h"
+
+/*
+ * The queue is shared with interrupt context, so it is only changed
+ * in critical sections. The number of queued items bounds each run,
+ * so that items that schedule themselves again cannot keep the
+ * callback timer process busy.
+ */
+static struct deferred *head, *tail;
+static unsigned queued;
+
+PROCESS_NAME(ctimer_process);
+/*---------------------------------------------------------------------------*/
+void
+deferred_set(struct deferred *d, void (*f)(void *), void *ptr)
+{
+  d->f = f;
+  d->ptr = ptr;
+  d->next = NULL;
+  d->pending = false;
+}
+/*---------------------------------------------------------------------------*/
+bool
+deferred_schedule(struct deferred *d)
+{
+  int_master_status_t status;
+
+  status = critical_enter();
+  if(d->pending) {
+    critical_exit(status);
+    return false;
+  }
+  d->pending = true;
+  d->next = NULL;
+  if(tail == NULL) {
+    head = d;
+  } else {
+    tail->next = d;
+  }
+  tail = d;
+  queued++;
+  critical_exit(status);
+
+  process_poll(&ctimer_process);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+deferred_cancel(struct deferred *d)
+{
+  int_master_status_t status;
+  struct deferred *prev, *t;
+
+  status = critical_enter();
+  if(!d->pending) {
+    critical_exit(status);
+    return false;
+  }
+  prev = NULL;
+  for(t = head; t != NULL && t != d; t = t->next) {
+    prev = t;
+  }
+  if(t != NULL) {
+    if(prev == NULL) {
+      head = d->next;
+    } else {
+      prev->next = d->next;
+    }
+    if(tail == d) {
+      tail = prev;
+    }
+    queued--;
+  }
+  d->pending = false;
+  critical_exit(status);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void
+deferred_run(void)
+{
+  int_master_status_t status;
+  struct deferred *d;
+  unsigned n;
+
+  status = critical_enter();
+  n = queued;
+  critical_exit(status);
+
+  /* Items scheduled from here on poll the process again. */
+  for(; n > 0; n--) {
+    status = critical_enter();
+    d = head;
+    if(d != NULL) {
+      head = d->next;
+      if(head == NULL) {
+        tail = NULL;
+      }
+      d->pending = false;
+      queued--;
+    }
+    critical_exit(status);
+
+    if(d == NULL) {
+      return;
+    }
+    if(d->f != NULL) {
+      d->f(d->ptr);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+deferred_init(void)
+{
+  head = tail = NULL;
+  queued = 0;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
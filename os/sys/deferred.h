@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the deferred work queue.
+ */
+
+/** \addtogroup sys
+ * @{ */
+
+/**
+ * \defgroup deferred Deferred work queue
+ *
+ * The deferred work queue runs callback functions from the process
+ * context on behalf of code that cannot run them directly, such as
+ * interrupt handlers and rtimer callbacks. A work item is scheduled
+ * with deferred_schedule(), which may be called from any context,
+ * and its callback is called from the callback timer process on the
+ * next pass through the scheduler. This avoids declaring a process
+ * just to move work out of interrupt context.
+ *
+ * A work item is only queued once, no matter how many times it is
+ * scheduled before its callback is called. The callbacks run in the
+ * context of the callback timer process.
+ *
+ * @{
+ */
+
+#ifndef DEFERRED_H_
+#define DEFERRED_H_
+
+#include "contiki.h"
+
+#include <stdbool.h>
+
+struct deferred {
+  struct deferred *next;
+  void (*f)(void *);
+  void *ptr;
+  volatile bool pending;
+};
+
+/**
+ * \brief      Set the callback function of a work item.
+ * \param d    A pointer to the work item.
+ * \param f    The function to be called when the work item is run.
+ * \param ptr  An opaque pointer that will be supplied as an argument
+ *             to the callback function.
+ *
+ *             The work item must not be pending.
+ */
+void deferred_set(struct deferred *d, void (*f)(void *), void *ptr);
+
+/**
+ * \brief      Schedule a work item.
+ * \param d    A pointer to the work item.
+ * \return     true if the work item was queued, or false if it was
+ *             already pending.
+ *
+ *             This function may be called from interrupt context.
+ */
+bool deferred_schedule(struct deferred *d);
+
+/**
+ * \brief      Cancel a pending work item.
+ * \param d    A pointer to the work item.
+ * \return     true if the work item was pending.
+ */
+bool deferred_cancel(struct deferred *d);
+
+/**
+ * \brief      Check if a work item is pending.
+ * \param d    A pointer to the work item.
+ * \return     true if the work item is queued and its callback has
+ *             not yet been called.
+ */
+static inline bool
+deferred_is_pending(struct deferred *d)
+{
+  return d->pending;
+}
+
+/**
+ * \brief      Run the work items that are pending.
+ *
+ *             This function is called by the callback timer process
+ *             when it is polled. Work items that are scheduled while
+ *             their callback runs are run on the next poll.
+ */
+void deferred_run(void);
+
+/**
+ * \brief      Initialize the deferred work queue.
+ */
+void deferred_init(void);
+
+#endif /* DEFERRED_H_ */
+/** @} */
+/** @} */
@@ -45,6 +45,8 @@
 uint64_t energest_total_time[ENERGEST_TYPE_MAX];
 ENERGEST_TIME_T energest_current_time[ENERGEST_TYPE_MAX];
 unsigned char energest_current_mode[ENERGEST_TYPE_MAX];
+uint32_t energest_wakeups;
+uint32_t energest_wakeups_avoided;
 
 /*---------------------------------------------------------------------------*/
 void
@@ -55,6 +57,7 @@ energest_init(void)
     energest_total_time[i] = energest_current_time[i] = 0;
     energest_current_mode[i] = 0;
   }
+  energest_wakeups = energest_wakeups_avoided = 0;
   ENERGEST_ON(ENERGEST_TYPE_CPU);
 }
 /*---------------------------------------------------------------------------*/
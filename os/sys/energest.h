@@ -117,6 +117,11 @@ extern uint64_t energest_total_time[ENERGEST_TYPE_MAX];
 extern ENERGEST_TIME_T energest_current_time[ENERGEST_TYPE_MAX];
 extern unsigned char energest_current_mode[ENERGEST_TYPE_MAX];
 
+/* The number of wake-ups from idle, and the number of periodic
+   wake-ups that were avoided by sleeping until the next deadline. */
+extern uint32_t energest_wakeups;
+extern uint32_t energest_wakeups_avoided;
+
 static inline uint64_t
 energest_type_time(energest_type_t type)
 {
@@ -166,6 +171,14 @@ energest_switch(energest_type_t type_off, energest_type_t type_on)
 }
 #define ENERGEST_SWITCH(type_off, type_on) energest_switch(type_off, type_on)
 
+static inline void
+energest_wakeup(uint32_t avoided)
+{
+  energest_wakeups++;
+  energest_wakeups_avoided += avoided;
+}
+#define ENERGEST_WAKEUP(avoided) energest_wakeup(avoided)
+
 #else /* ENERGEST_CONF_ON */
 
 static inline uint64_t energest_type_time(energest_type_t type) { return 0; }
@@ -184,6 +197,7 @@ static inline void energest_switch(energest_type_t type_off,
 #define ENERGEST_ON(type) do { } while(0)
 #define ENERGEST_OFF(type) do { } while(0)
 #define ENERGEST_SWITCH(type_off, type_on) do { } while(0)
+#define ENERGEST_WAKEUP(avoided) do { } while(0)
 
 #endif /* ENERGEST_CONF_ON */
 
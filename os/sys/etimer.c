@@ -53,6 +53,160 @@ static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
+#if ETIMER_HEAP
+/*---------------------------------------------------------------------------*/
+/*
+ * With the heap backend, timerlist points to the root of a pairing
+ * heap ordered by expiration time. Each timer links to its leftmost
+ * child through the child pointer and to its right sibling through
+ * the next pointer. The prev pointer refers to the left sibling, or
+ * to the parent for a leftmost child, and is NULL only for the root
+ * and for timers that are not in the heap.
+ */
+static int
+expires_before(struct etimer *a, struct etimer *b)
+{
+  clock_time_t diff;
+
+  /* Compare through the difference to handle clock wraps. */
+  diff = (a->timer.start + a->timer.interval) -
+         (b->timer.start + b->timer.interval);
+  return diff > (clock_time_t)~(clock_time_t)0 / 2;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *t;
+
+  if(expires_before(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+
+  /* Make b the leftmost child of a. */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  a->next = NULL;
+  a->prev = NULL;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b;
+  struct etimer *pairs;
+
+  /* First pass: meld the siblings in pairs from left to right, and
+     stack the results in reverse order through their next pointers. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+      a = meld(a, b);
+    }
+    a->next = pairs;
+    pairs = a;
+  }
+
+  /* Second pass: meld the pairs from right to left. */
+  first = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    first = first != NULL ? meld(first, a) : a;
+  }
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct etimer *t)
+{
+  t->child = t->next = t->prev = NULL;
+  timerlist = timerlist != NULL ? meld(timerlist, t) : t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  struct etimer *sub;
+
+  if(t == timerlist) {
+    timerlist = merge_pairs(t->child);
+  } else {
+    /* Unlink t from its parent or left sibling. */
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    sub = merge_pairs(t->child);
+    if(sub != NULL) {
+      timerlist = meld(timerlist, sub);
+    }
+  }
+  t->child = t->next = t->prev = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+heap_contains(struct etimer *t)
+{
+  /* A timer is in the heap exactly when it has a process: p is cleared
+     whenever a timer leaves the heap, on expiration, on etimer_stop()
+     and on the exit of its process. */
+  return t->p != PROCESS_NONE;
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+heap_find_process(struct process *p)
+{
+  struct etimer *t;
+
+  /* Walk the heap in depth-first order, climbing back up through the
+     prev pointers when a subtree has been visited. */
+  t = timerlist;
+  while(t != NULL) {
+    if(t->p == p) {
+      return t;
+    }
+    if(t->child != NULL) {
+      t = t->child;
+      continue;
+    }
+    while(t != NULL && t->next == NULL) {
+      /* Go to the leftmost sibling, then to the parent. */
+      while(t->prev != NULL && t->prev->child != t) {
+        t = t->prev;
+      }
+      t = t->prev;
+    }
+    if(t != NULL) {
+      t = t->next;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  next_expiration = timerlist == NULL ? 0 : etimer_expiration_time(timerlist);
+}
+#else /* ETIMER_HEAP */
 /*---------------------------------------------------------------------------*/
 static void
 update_time(void)
@@ -76,10 +230,15 @@ update_time(void)
     next_expiration = now + tdist;
   }
 }
+#endif /* ETIMER_HEAP */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
+#if ETIMER_HEAP
+  struct etimer *t;
+#else /* ETIMER_HEAP */
   struct etimer *t, *u;
+#endif /* ETIMER_HEAP */
 
   PROCESS_BEGIN();
 
@@ -91,7 +250,15 @@ PROCESS_THREAD(etimer_process, ev, data)
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
+#if ETIMER_HEAP
+      while((t = heap_find_process(p)) != NULL) {
+        heap_remove(t);
+        t->p = PROCESS_NONE;
+      }
+      update_time();
+#else /* ETIMER_HEAP */
       while(timerlist != NULL && timerlist->p == p) {
+        timerlist->p = PROCESS_NONE;
         timerlist = timerlist->next;
       }
 
@@ -99,17 +266,32 @@ PROCESS_THREAD(etimer_process, ev, data)
         t = timerlist;
         while(t->next != NULL) {
           if(t->next->p == p) {
+            t->next->p = PROCESS_NONE;
             t->next = t->next->next;
           } else {
             t = t->next;
           }
         }
       }
+#endif /* ETIMER_HEAP */
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
+#if ETIMER_HEAP
+    /* The expired timers are always at the root of the heap. */
+    while(timerlist != NULL && timer_expired(&timerlist->timer)) {
+      t = timerlist;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+        etimer_request_poll();
+        break;
+      }
+      heap_remove(t);
+      t->p = PROCESS_NONE;
+    }
+    update_time();
+#else /* ETIMER_HEAP */
 again:
 
     u = NULL;
@@ -136,6 +318,7 @@ again:
       }
       u = t;
     }
+#endif /* ETIMER_HEAP */
   }
 
   PROCESS_END();
@@ -147,13 +330,34 @@ etimer_request_poll(void)
   process_poll(&etimer_process);
 }
 /*---------------------------------------------------------------------------*/
+/* Called before the expiration time of a timer that is about to be added
+   changes. With the heap backend, a timer that is still pending leaves the
+   heap, and is inserted again by add_timer(). */
+static void
+prepare_timer(struct etimer *timer)
+{
+#if ETIMER_HEAP
+  if(heap_contains(timer)) {
+    heap_remove(timer);
+  }
+#endif /* ETIMER_HEAP */
+}
+/*---------------------------------------------------------------------------*/
 static void
 add_timer(struct etimer *timer)
 {
+#if !ETIMER_HEAP
   struct etimer *t;
+#endif /* !ETIMER_HEAP */
 
   etimer_request_poll();
 
+#if ETIMER_HEAP
+  /* prepare_timer() took the timer out of the heap */
+  timer->p = PROCESS_CURRENT();
+  heap_insert(timer);
+  update_time();
+#else /* ETIMER_HEAP */
   if(timer->p != PROCESS_NONE) {
     for(t = timerlist; t != NULL; t = t->next) {
       if(t == timer) {
@@ -171,11 +375,13 @@ add_timer(struct etimer *timer)
   timerlist = timer;
 
   update_time();
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 void
 etimer_set(struct etimer *et, clock_time_t interval)
 {
+  prepare_timer(et);
   timer_set(&et->timer, interval);
   add_timer(et);
 }
@@ -183,6 +389,7 @@ etimer_set(struct etimer *et, clock_time_t interval)
 void
 etimer_reset_with_new_interval(struct etimer *et, clock_time_t interval)
 {
+  prepare_timer(et);
   timer_reset(&et->timer);
   et->timer.interval = interval;
   add_timer(et);
@@ -191,6 +398,7 @@ etimer_reset_with_new_interval(struct etimer *et, clock_time_t interval)
 void
 etimer_reset(struct etimer *et)
 {
+  prepare_timer(et);
   timer_reset(&et->timer);
   add_timer(et);
 }
@@ -198,6 +406,7 @@ etimer_reset(struct etimer *et)
 void
 etimer_restart(struct etimer *et)
 {
+  prepare_timer(et);
   timer_restart(&et->timer);
   add_timer(et);
 }
@@ -205,7 +414,17 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+#if ETIMER_HEAP
+  if(heap_contains(et)) {
+    heap_remove(et);
+    et->timer.start += timediff;
+    heap_insert(et);
+  } else {
+    et->timer.start += timediff;
+  }
+#else /* ETIMER_HEAP */
   et->timer.start += timediff;
+#endif /* ETIMER_HEAP */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -242,6 +461,12 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_HEAP
+  if(heap_contains(et)) {
+    heap_remove(et);
+    update_time();
+  }
+#else /* ETIMER_HEAP */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -266,6 +491,7 @@ etimer_stop(struct etimer *et)
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
+#endif /* ETIMER_HEAP */
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
@@ -65,6 +65,30 @@
 
 #include "contiki.h"
 
+/**
+ * \brief      Select the pairing heap backend for pending event timers.
+ *
+ *             By default, pending event timers are kept in an
+ *             unsorted list, which makes every timer operation O(n) in
+ *             the number of pending timers. When this is set to
+ *             non-zero, the timers are instead kept in a pairing heap
+ *             ordered by expiration time, giving O(1) insertion and
+ *             next-expiration lookup, and O(log n) amortized removal.
+ *             This costs two extra pointers per event timer.
+ *
+ *             With the heap backend, an event timer must either have
+ *             been set before, or be zero-initialized (as timers with
+ *             static storage duration are), as whether it is pending
+ *             is told by its process alone. The list backend also
+ *             accepts a timer in uninitialized memory in etimer_set(),
+ *             at the cost of a walk through the list.
+ */
+#ifdef ETIMER_CONF_HEAP
+#define ETIMER_HEAP ETIMER_CONF_HEAP
+#else
+#define ETIMER_HEAP 0
+#endif
+
 /**
  * A timer.
  *
@@ -77,6 +101,10 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+#endif /* ETIMER_HEAP */
 };
 
 /**
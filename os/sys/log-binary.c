@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A binary logging backend that stores log records in a ring
+ *         buffer, and drains them in a low-priority process.
+ */
+
+/** \addtogroup log-binary
+ * @{ */
+
+#include "contiki.h"
+#include "sys/critical.h"
+#include "sys/log.h"
+#include "sys/log-binary.h"
+#include "sys/rtimer.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if LOG_WITH_BINARY
+
+const char log_binary_base[] = "log-binary";
+
+static uint8_t ring[LOG_BINARY_BUFFER_SIZE];
+static unsigned ring_head;
+static unsigned ring_tail;
+static unsigned ring_used;
+static uint32_t dropped;
+static uint32_t reported_dropped;
+
+PROCESS(log_binary_process, "Binary log");
+/*---------------------------------------------------------------------------*/
+static int32_t
+offset_of(const char *str)
+{
+  return str == NULL ? 0 : (int32_t)(str - log_binary_base);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put(uint8_t *p, const void *value, size_t size)
+{
+  memcpy(p, value, size);
+  return p + size;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put_header(uint8_t *p, uint8_t flags, const char *module, const char *fmt)
+{
+  uint32_t timestamp = RTIMER_NOW();
+  int32_t offset;
+
+  /* The length is filled in when the record is complete. */
+  *p++ = 0;
+  *p++ = flags;
+  p = put(p, &timestamp, sizeof(timestamp));
+  offset = offset_of(module);
+  p = put(p, &offset, sizeof(offset));
+  offset = offset_of(fmt);
+  return put(p, &offset, sizeof(offset));
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Store the arguments of a format string. Only the conversion
+ * specifications are parsed, so this is much cheaper than formatting
+ * the message. The arguments that do not fit are left out, and are
+ * shown as missing by the decoder.
+ */
+static uint8_t *
+put_arguments(uint8_t *p, const uint8_t *end, const char *fmt, va_list ap)
+{
+  while(*fmt != '\0') {
+    if(*fmt++ != '%') {
+      continue;
+    }
+
+    /* Flags. */
+    while(*fmt != '\0' && strchr("-+ #0", *fmt) != NULL) {
+      fmt++;
+    }
+
+    /* Width and precision, which may be given as int arguments. */
+    for(int field = 0; field < 2; field++) {
+      if(field == 1) {
+        if(*fmt != '.') {
+          break;
+        }
+        fmt++;
+      }
+      if(*fmt == '*') {
+        int32_t value = va_arg(ap, int);
+        if(end - p < (int)sizeof(value)) {
+          return p;
+        }
+        p = put(p, &value, sizeof(value));
+        fmt++;
+      } else {
+        while(*fmt >= '0' && *fmt <= '9') {
+          fmt++;
+        }
+      }
+    }
+
+    /* Length modifiers. */
+    char length = 0;
+    while(*fmt != '\0' && strchr("hlLqjzt", *fmt) != NULL) {
+      length = *fmt == 'h' && length == 'h' ? 'H' :
+        *fmt == 'l' && length == 'l' ? 'q' : *fmt;
+      fmt++;
+    }
+
+    char conversion = *fmt;
+    if(conversion == '\0') {
+      break;
+    }
+    fmt++;
+
+    switch(conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+      if(length == 0 || length == 'h' || length == 'H') {
+        int32_t value = va_arg(ap, int);
+        if(end - p < (int)sizeof(value)) {
+          return p;
+        }
+        p = put(p, &value, sizeof(value));
+      } else {
+        int64_t value;
+        switch(length) {
+        case 'l':
+          value = va_arg(ap, long);
+          break;
+        case 'z':
+          value = va_arg(ap, size_t);
+          break;
+        case 't':
+          value = va_arg(ap, ptrdiff_t);
+          break;
+        case 'j':
+          value = va_arg(ap, intmax_t);
+          break;
+        default:
+          value = va_arg(ap, long long);
+          break;
+        }
+        if(end - p < (int)sizeof(value)) {
+          return p;
+        }
+        p = put(p, &value, sizeof(value));
+      }
+      break;
+    case 'p':
+      {
+        uint64_t value = (uintptr_t)va_arg(ap, void *);
+        if(end - p < (int)sizeof(value)) {
+          return p;
+        }
+        p = put(p, &value, sizeof(value));
+      }
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      {
+        double value = length == 'L' ?
+          (double)va_arg(ap, long double) : va_arg(ap, double);
+        if(end - p < (int)sizeof(value)) {
+          return p;
+        }
+        p = put(p, &value, sizeof(value));
+      }
+      break;
+    case 's':
+      {
+        const char *str = va_arg(ap, const char *);
+        if(str == NULL) {
+          str = "(null)";
+        }
+        size_t len = strnlen(str, LOG_BINARY_MAX_STRING);
+        if(end - p < (int)len + 1) {
+          return p;
+        }
+        p = put(p, str, len);
+        *p++ = '\0';
+      }
+      break;
+    case 'n':
+      (void)va_arg(ap, void *);
+      break;
+    default:
+      /* Either "%%" or an unknown conversion, which takes no argument. */
+      break;
+    }
+  }
+
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+/* Copy a complete record into the ring buffer, or drop it. */
+static void
+store(const uint8_t *record, unsigned length)
+{
+  int_master_status_t status;
+  bool stored = false;
+
+  status = critical_enter();
+  if(length <= LOG_BINARY_BUFFER_SIZE - ring_used) {
+    unsigned first = MIN(length, LOG_BINARY_BUFFER_SIZE - ring_head);
+    memcpy(&ring[ring_head], record, first);
+    memcpy(ring, record + first, length - first);
+    ring_head = (ring_head + length) % LOG_BINARY_BUFFER_SIZE;
+    ring_used += length;
+    stored = true;
+  } else {
+    dropped++;
+  }
+  critical_exit(status);
+
+  if(stored) {
+    process_poll(&log_binary_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Take the oldest record out of the ring buffer. */
+static unsigned
+fetch(uint8_t *record)
+{
+  int_master_status_t status;
+  unsigned length = 0;
+
+  status = critical_enter();
+  if(ring_used > 0) {
+    length = ring[ring_tail];
+    unsigned first = MIN(length, LOG_BINARY_BUFFER_SIZE - ring_tail);
+    memcpy(record, &ring[ring_tail], first);
+    memcpy(record + first, ring, length - first);
+    ring_tail = (ring_tail + length) % LOG_BINARY_BUFFER_SIZE;
+    ring_used -= length;
+  }
+  critical_exit(status);
+
+  return length;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_record(uint8_t flags, const char *module, const char *fmt, ...)
+{
+  uint8_t record[LOG_BINARY_MAX_RECORD];
+  uint8_t *p;
+  va_list ap;
+
+  p = put_header(record, flags, module, fmt);
+  va_start(ap, fmt);
+  p = put_arguments(p, record + sizeof(record), fmt, ap);
+  va_end(ap);
+
+  record[0] = p - record;
+  store(record, p - record);
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+log_binary_dropped(void)
+{
+  return dropped;
+}
+/*---------------------------------------------------------------------------*/
+unsigned
+log_binary_pending(void)
+{
+  return ring_used;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_output_hex(const uint8_t *record, unsigned length)
+{
+  printf(LOG_BINARY_LINE_PREFIX);
+  for(unsigned i = 0; i < length; i++) {
+    printf("%02x", record[i]);
+  }
+  printf("\n");
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_init(void)
+{
+  process_start(&log_binary_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(log_binary_process, ev, data)
+{
+  static uint8_t record[LOG_BINARY_MAX_RECORD];
+  unsigned length;
+  unsigned count;
+
+  PROCESS_BEGIN();
+
+  /* Drain the records that were stored before the process started. */
+  process_poll(&log_binary_process);
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL ||
+                             ev == PROCESS_EVENT_CONTINUE);
+
+    /* Output a bounded number of records at a time, so that other
+       processes get to run in between. */
+    for(count = 0; count < 8; count++) {
+      length = fetch(record);
+      if(length == 0) {
+        break;
+      }
+      LOG_BINARY_OUTPUT(record, length);
+    }
+    if(length > 0) {
+      /* Continue after the events that are already queued. A poll would
+         run again before them. */
+      if(process_post(&log_binary_process, PROCESS_EVENT_CONTINUE,
+                      NULL) != PROCESS_ERR_OK) {
+        process_poll(&log_binary_process);
+      }
+    } else if(dropped != reported_dropped) {
+      /* Once the stored records have been output, report the records
+         that were dropped, in a record without a format string. */
+      uint32_t lost = dropped - reported_dropped;
+      uint8_t *p = put_header(record, LOG_LEVEL_WARN, NULL, NULL);
+      p = put(p, &lost, sizeof(lost));
+      record[0] = p - record;
+      LOG_BINARY_OUTPUT(record, p - record);
+      reported_dropped += lost;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+#endif /* LOG_WITH_BINARY */
+/** @} */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the binary logging backend.
+ */
+
+/** \addtogroup log
+ * @{ */
+
+/**
+ * \defgroup log-binary Binary logging backend
+ *
+ * When LOG_CONF_WITH_BINARY is enabled, the LOG_* macros no longer
+ * format their messages at the call site. Each message is instead
+ * stored as a compact record in a RAM ring buffer, which holds the
+ * log level, the addresses of the module name and the format string,
+ * and the raw arguments. A low-priority process drains the ring
+ * buffer to the serial output, and the host-side decoder in
+ * tools/log-binary rebuilds the text by reading the format strings
+ * from the firmware ELF file.
+ *
+ * The per-module log levels work as usual. The color and location
+ * options of the text backend are not supported.
+ *
+ * A record consists of the following fields, in the byte order of
+ * the target:
+ *
+ * - Length of the whole record (1 byte)
+ * - Log level, with the top bit set for continuation records,
+ *   which do not start a new line (1 byte)
+ * - Timestamp in rtimer ticks (4 bytes)
+ * - Offset of the module name from log_binary_base (4 bytes)
+ * - Offset of the format string from log_binary_base (4 bytes)
+ * - The arguments: integers of int size and smaller as 4 bytes,
+ *   all other integers, pointers and floating-point numbers as 8
+ *   bytes, and strings as NUL-terminated copies.
+ *
+ * Addresses are stored as offsets so that they can be resolved also
+ * in position-independent executables. A record without a format
+ * string reports the number of records that were dropped because
+ * the ring buffer was full.
+ *
+ * @{
+ */
+
+#ifndef LOG_BINARY_H_
+#define LOG_BINARY_H_
+
+#include <stdint.h>
+
+/* The size of the ring buffer in bytes. */
+#ifdef LOG_CONF_BINARY_BUFFER_SIZE
+#define LOG_BINARY_BUFFER_SIZE LOG_CONF_BINARY_BUFFER_SIZE
+#else /* LOG_CONF_BINARY_BUFFER_SIZE */
+#define LOG_BINARY_BUFFER_SIZE 1024
+#endif /* LOG_CONF_BINARY_BUFFER_SIZE */
+
+/* The longest string argument that is copied into a record. */
+#ifdef LOG_CONF_BINARY_MAX_STRING
+#define LOG_BINARY_MAX_STRING LOG_CONF_BINARY_MAX_STRING
+#else /* LOG_CONF_BINARY_MAX_STRING */
+#define LOG_BINARY_MAX_STRING 32
+#endif /* LOG_CONF_BINARY_MAX_STRING */
+
+/*
+ * Custom output function for drained records. The default function
+ * prints each record as a line with a hexadecimal dump of the record,
+ * prefixed by LOG_BINARY_LINE_PREFIX.
+ */
+#ifdef LOG_CONF_BINARY_OUTPUT
+#define LOG_BINARY_OUTPUT(record, length) LOG_CONF_BINARY_OUTPUT(record, length)
+#else /* LOG_CONF_BINARY_OUTPUT */
+#define LOG_BINARY_OUTPUT(record, length) log_binary_output_hex(record, length)
+#endif /* LOG_CONF_BINARY_OUTPUT */
+
+#define LOG_BINARY_LINE_PREFIX "#L:"
+
+/* The largest record that can be stored. */
+#define LOG_BINARY_MAX_RECORD 255
+
+/* The flag for records that continue the line of the previous one. */
+#define LOG_BINARY_CONTINUATION 0x80
+
+/**
+ * The symbol from which the offsets of the module names and format
+ * strings are calculated.
+ */
+extern const char log_binary_base[];
+
+/**
+ * \brief Initialize the binary logging backend, and start the
+ *        process that drains the ring buffer.
+ */
+void log_binary_init(void);
+
+/**
+ * \brief Store a log record in the ring buffer.
+ * \param flags The log level, possibly ORed with LOG_BINARY_CONTINUATION.
+ * \param module The module name, or NULL.
+ * \param fmt The printf-style format string, which must be a string
+ *        constant that is present in the firmware image.
+ *
+ *        This function can be called from interrupt context. The
+ *        record is dropped if there is not enough space in the ring
+ *        buffer.
+ */
+void log_binary_record(uint8_t flags, const char *module,
+                       const char *fmt, ...);
+
+/**
+ * \brief Get the number of records dropped because the ring buffer
+ *        was full.
+ */
+uint32_t log_binary_dropped(void);
+
+/**
+ * \brief Get the number of bytes waiting in the ring buffer.
+ */
+unsigned log_binary_pending(void);
+
+/**
+ * \brief Print a record as a line of hexadecimal digits.
+ * \param record The record.
+ * \param length The length of the record.
+ */
+void log_binary_output_hex(const uint8_t *record, unsigned length);
+
+#endif /* LOG_BINARY_H_ */
+
+/** @} */
+/** @} */
@@ -75,9 +75,19 @@
 #define LOG_WITH_ANNOTATE 0
 #endif /* LOG_CONF_WITH_ANNOTATE */
 
-/* Custom output function -- default is printf */
+/* Store logs as binary records instead of formatting them as text */
+#ifdef LOG_CONF_WITH_BINARY
+#define LOG_WITH_BINARY LOG_CONF_WITH_BINARY
+#else /* LOG_CONF_WITH_BINARY */
+#define LOG_WITH_BINARY 0
+#endif /* LOG_CONF_WITH_BINARY */
+
+/* Custom output function -- default is printf, or a continuation
+   record with the binary backend */
 #ifdef LOG_CONF_OUTPUT
 #define LOG_OUTPUT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
+#elif LOG_WITH_BINARY
+#define LOG_OUTPUT(...) log_binary_record(LOG_BINARY_CONTINUATION, NULL, __VA_ARGS__)
 #else /* LOG_CONF_OUTPUT */
 #define LOG_OUTPUT(...) printf(__VA_ARGS__)
 #endif /* LOG_CONF_OUTPUT */
@@ -52,6 +52,7 @@
 #include "net/ipv6/ip64-addr.h"
 #include "net/ipv6/uiplib.h"
 #include "deployment/deployment.h"
+#include "lib/hexconv.h"
 
 int curr_log_level_rpl = LOG_CONF_LEVEL_RPL;
 int curr_log_level_tcpip = LOG_CONF_LEVEL_TCPIP;
@@ -131,13 +132,18 @@ log_lladdr(const linkaddr_t *lladdr)
     LOG_OUTPUT("(NULL LL addr)");
     return;
   } else {
-    unsigned int i;
-    for(i = 0; i < LINKADDR_SIZE; i++) {
-      if(i > 0 && i % 2 == 0) {
-        LOG_OUTPUT(".");
+    /* Built in one buffer and printed with a single call */
+    char buf[LINKADDR_SIZE * 3];
+    unsigned int i, n = 0;
+    for(i = 0; i < LINKADDR_SIZE; i += 2) {
+      if(i > 0) {
+        buf[n++] = '.';
       }
-      LOG_OUTPUT("%02x", lladdr->u8[i]);
+      n += hexconv_hexlify(&lladdr->u8[i], MIN(2, LINKADDR_SIZE - i),
+                           &buf[n], sizeof(buf) - n);
     }
+    buf[n] = '\0';
+    LOG_OUTPUT("%s", buf);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -163,9 +169,13 @@ void
 log_bytes(const void *data, size_t length)
 {
   const uint8_t *u8data = (const uint8_t *)data;
+  char buf[33];
   size_t i;
-  for(i = 0; i != length; ++i) {
-    LOG_OUTPUT("%02x", u8data[i]);
+  int n;
+  for(i = 0; i < length; i += n / 2) {
+    n = hexconv_hexlify(&u8data[i], MIN(16, length - i), buf, sizeof(buf));
+    buf[n] = '\0';
+    LOG_OUTPUT("%s", buf);
   }
 }
 /*---------------------------------------------------------------------------*/
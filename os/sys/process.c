@@ -47,6 +47,16 @@
 
 #include "contiki.h"
 #include "sys/process.h"
+#if PROCESS_CONF_PRIORITIES || PROCESS_CONF_NUMEVENTS_ISR
+#include "sys/critical.h"
+#endif /* PROCESS_CONF_PRIORITIES || PROCESS_CONF_NUMEVENTS_ISR */
+#if PROCESS_CONF_NUMEVENTS_ISR
+#include "sys/atomic.h"
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+#if PROCESS_CONF_PROFILE
+#include "sys/rtimer.h"
+#include <string.h>
+#endif /* PROCESS_CONF_PROFILE */
 
 /*
  * Pointer to the currently running process structure.
@@ -63,6 +73,9 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_CONF_PROFILE
+  rtimer_clock_t posted;
+#endif /* PROCESS_CONF_PROFILE */
 };
 
 static process_num_events_t nevents, fevent;
@@ -70,16 +83,93 @@ static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+#if PROCESS_CONF_PRIORITIES
+/* Peak of the high-priority queue, which process_maxevents excludes */
+process_num_events_t process_maxevents_high;
+#endif /* PROCESS_CONF_PRIORITIES */
 #endif
 
 static volatile unsigned char poll_requested;
 
+#if PROCESS_CONF_NUMEVENTS_ISR
+#if PROCESS_CONF_NUMEVENTS_ISR > 128 || \
+    (PROCESS_CONF_NUMEVENTS_ISR & (PROCESS_CONF_NUMEVENTS_ISR - 1)) != 0
+#error "PROCESS_CONF_NUMEVENTS_ISR must be a power of two no larger than 128"
+#endif
+
+/*
+ * Events posted from interrupt context. Producers reserve a slot by
+ * advancing isr_head with a compare-and-swap, fill it in, and then set
+ * its ready flag. The slot is only written by the producer that
+ * reserved it, and only process_run() advances isr_tail, so the
+ * kernel itself stays single-threaded. The indices are free-running
+ * and wrap at 256.
+ */
+struct isr_event_data {
+  struct event_data event;
+  volatile uint8_t ready;
+};
+
+static struct isr_event_data isr_events[PROCESS_CONF_NUMEVENTS_ISR];
+static volatile uint8_t isr_head, isr_tail;
+volatile uint32_t process_isr_overflows;
+
+/*
+ * Orders the accesses to a slot with those to its ready flag. The
+ * platform's memory barrier orders them for the CPU, and the compiler
+ * barrier keeps the compiler from moving the accesses to the slot,
+ * which is not volatile, across the flag on platforms that define no
+ * memory barrier.
+ */
+#define ISR_EVENT_BARRIER() do {            \
+    memory_barrier();                       \
+    __asm__ volatile("" : : : "memory");    \
+  } while(0)
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+
+#if PROCESS_CONF_PRIORITIES
+/*
+ * Events posted to high-priority processes, which are dispatched
+ * before those in the regular event queue.
+ */
+static process_num_events_t nevents_high, fevent_high;
+static struct event_data events_high[PROCESS_CONF_NUMEVENTS_HIGH];
+/*
+ * The number of events to high-priority processes that went to the
+ * regular queue because the high-priority queue was full. Until they
+ * are dispatched, later events to high-priority processes follow them
+ * there, so that they cannot overtake them.
+ */
+static process_num_events_t nevents_deferred;
+
+/*
+ * Queues of processes that have requested to be polled, linked
+ * through their poll_next pointers. Processes are added from
+ * process_poll(), which may be called from interrupt context.
+ */
+struct poll_queue {
+  struct process *head;
+  struct process *tail;
+};
+static struct poll_queue poll_queue_high, poll_queue_normal;
+#endif /* PROCESS_CONF_PRIORITIES */
+
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
 #define PROCESS_STATE_CALLED      2
 
 static void call_process(struct process *p, process_event_t ev, process_data_t data);
 
+#if PROCESS_CONF_PROFILE
+static void call_queued_process(struct process *p, process_event_t ev,
+                                process_data_t data, rtimer_clock_t posted);
+/* Call a process with an event or poll that was queued at posted. */
+#define CALL_QUEUED_PROCESS(p, ev, data, posted) \
+  call_queued_process(p, ev, data, posted)
+#else /* PROCESS_CONF_PROFILE */
+#define CALL_QUEUED_PROCESS(p, ev, data, posted) call_process(p, ev, data)
+#endif /* PROCESS_CONF_PROFILE */
+
 #define DEBUG 0
 #if DEBUG
 #include <stdio.h>
@@ -175,6 +265,10 @@ static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
   int ret;
+#if PROCESS_CONF_PROFILE
+  rtimer_clock_t start;
+  uint32_t elapsed;
+#endif /* PROCESS_CONF_PROFILE */
 
 #if DEBUG
   if(p->state == PROCESS_STATE_CALLED) {
@@ -187,7 +281,18 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if PROCESS_CONF_PROFILE
+    start = RTIMER_NOW();
     ret = p->thread(&p->pt, ev, data);
+    elapsed = (rtimer_clock_t)(RTIMER_NOW() - start);
+    p->profile.calls++;
+    p->profile.run_time += elapsed;
+    if(elapsed > p->profile.max_run_time) {
+      p->profile.max_run_time = elapsed;
+    }
+#else /* PROCESS_CONF_PROFILE */
+    ret = p->thread(&p->pt, ev, data);
+#endif /* PROCESS_CONF_PROFILE */
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -198,6 +303,35 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PROFILE
+static void
+call_queued_process(struct process *p, process_event_t ev,
+                    process_data_t data, rtimer_clock_t posted)
+{
+  uint32_t wait;
+
+  if((p->state & PROCESS_STATE_RUNNING) && p->thread != NULL) {
+    wait = (rtimer_clock_t)(RTIMER_NOW() - posted);
+    p->profile.waits++;
+    p->profile.wait_time += wait;
+    if(wait > p->profile.max_wait_time) {
+      p->profile.max_wait_time = wait;
+    }
+  }
+  call_process(p, ev, data);
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profile_reset(void)
+{
+  struct process *p;
+
+  for(p = process_list; p != NULL; p = p->next) {
+    memset(&p->profile, 0, sizeof(p->profile));
+  }
+}
+#endif /* PROCESS_CONF_PROFILE */
+/*---------------------------------------------------------------------------*/
 void
 process_exit(struct process *p)
 {
@@ -210,17 +344,93 @@ process_init(void)
   lastevent = PROCESS_EVENT_MAX;
 
   nevents = fevent = 0;
+#if PROCESS_CONF_PRIORITIES
+  nevents_high = fevent_high = nevents_deferred = 0;
+  poll_queue_high.head = poll_queue_high.tail = NULL;
+  poll_queue_normal.head = poll_queue_normal.tail = NULL;
+#endif /* PROCESS_CONF_PRIORITIES */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+#if PROCESS_CONF_PRIORITIES
+  process_maxevents_high = 0;
+#endif /* PROCESS_CONF_PRIORITIES */
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_NUMEVENTS_ISR
+/*
+ * Move the events posted from interrupt context to the event queue.
+ */
+static void
+do_isr_events(void)
+{
+  struct isr_event_data *e;
+
+  while(isr_tail != isr_head) {
+    e = &isr_events[isr_tail % PROCESS_CONF_NUMEVENTS_ISR];
+    if(!e->ready) {
+      /* The slot is reserved but not yet filled in. */
+      break;
+    }
+    /* Read the slot only after its ready flag */
+    ISR_EVENT_BARRIER();
+    if(process_post(e->event.p, e->event.ev, e->event.data) !=
+       PROCESS_ERR_OK) {
+      /* Keep the event until there is room in the event queue. */
+      break;
+    }
+    e->ready = 0;
+    /* Free the slot only after it has been read */
+    ISR_EVENT_BARRIER();
+    isr_tail++;
+  }
+}
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+/*---------------------------------------------------------------------------*/
 /*
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+static void
+run_poll_queue(struct process *p)
+{
+  struct process *next;
+
+  for(; p != NULL; p = next) {
+    next = p->poll_next;
+    p->poll_next = NULL;
+    p->needspoll = 0;
+    /* The process may have exited after requesting the poll. */
+    if(p->state != PROCESS_STATE_NONE) {
+      p->state = PROCESS_STATE_RUNNING;
+      CALL_QUEUED_PROCESS(p, PROCESS_EVENT_POLL, NULL, p->poll_time);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+do_poll(void)
+{
+  struct process *high, *normal;
+  int_master_status_t status;
+
+  /* Take the current queues, so that processes that poll themselves
+     are run on the next call, as with the process list walk. */
+  status = critical_enter();
+  poll_requested = 0;
+  high = poll_queue_high.head;
+  normal = poll_queue_normal.head;
+  poll_queue_high.head = poll_queue_high.tail = NULL;
+  poll_queue_normal.head = poll_queue_normal.tail = NULL;
+  critical_exit(status);
+
+  run_poll_queue(high);
+  run_poll_queue(normal);
+}
+#else /* PROCESS_CONF_PRIORITIES */
 static void
 do_poll(void)
 {
@@ -232,10 +442,11 @@ do_poll(void)
     if(p->needspoll) {
       p->state = PROCESS_STATE_RUNNING;
       p->needspoll = 0;
-      call_process(p, PROCESS_EVENT_POLL, NULL);
+      CALL_QUEUED_PROCESS(p, PROCESS_EVENT_POLL, NULL, p->poll_time);
     }
   }
 }
+#endif /* PROCESS_CONF_PRIORITIES */
 /*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
@@ -249,6 +460,9 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
+#if PROCESS_CONF_PROFILE
+  rtimer_clock_t posted;
+#endif /* PROCESS_CONF_PROFILE */
 
   /*
    * If there are any events in the queue, take the first one and walk
@@ -258,6 +472,27 @@ do_event(void)
    * call the poll handlers inbetween.
    */
 
+#if PROCESS_CONF_PRIORITIES
+  if(nevents_high > 0) {
+    /* Events for high-priority processes are never broadcast. */
+    ev = events_high[fevent_high].ev;
+    data = events_high[fevent_high].data;
+    receiver = events_high[fevent_high].p;
+#if PROCESS_CONF_PROFILE
+    posted = events_high[fevent_high].posted;
+#endif /* PROCESS_CONF_PROFILE */
+
+    fevent_high = (fevent_high + 1) % PROCESS_CONF_NUMEVENTS_HIGH;
+    --nevents_high;
+
+    if(ev == PROCESS_EVENT_INIT) {
+      receiver->state = PROCESS_STATE_RUNNING;
+    }
+    CALL_QUEUED_PROCESS(receiver, ev, data, posted);
+    return;
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
+
   if(nevents > 0) {
 
     /* There are events that we should deliver. */
@@ -265,11 +500,23 @@ do_event(void)
 
     data = events[fevent].data;
     receiver = events[fevent].p;
+#if PROCESS_CONF_PROFILE
+    posted = events[fevent].posted;
+#endif /* PROCESS_CONF_PROFILE */
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
     fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
     --nevents;
+#if PROCESS_CONF_PRIORITIES
+    if(nevents == 0) {
+      /* Also recovers from priority changes while events were queued */
+      nevents_deferred = 0;
+    } else if(nevents_deferred > 0 && receiver != PROCESS_BROADCAST &&
+              receiver->priority == PROCESS_PRIORITY_HIGH) {
+      --nevents_deferred;
+    }
+#endif /* PROCESS_CONF_PRIORITIES */
 
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
@@ -281,7 +528,7 @@ do_event(void)
         if(poll_requested) {
           do_poll();
         }
-        call_process(p, ev, data);
+        CALL_QUEUED_PROCESS(p, ev, data, posted);
       }
     } else {
       /* This is not a broadcast event, so we deliver it to the
@@ -293,7 +540,7 @@ do_event(void)
       }
 
       /* Make sure that the process actually is running. */
-      call_process(receiver, ev, data);
+      CALL_QUEUED_PROCESS(receiver, ev, data, posted);
     }
   }
 }
@@ -301,6 +548,12 @@ do_event(void)
 int
 process_run(void)
 {
+#if PROCESS_CONF_NUMEVENTS_ISR
+  if(isr_tail != isr_head) {
+    do_isr_events();
+  }
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+
   /* Process poll events. */
   if(poll_requested) {
     do_poll();
@@ -309,19 +562,31 @@ process_run(void)
   /* Process one event from the queue */
   do_event();
 
-  return nevents + poll_requested;
+  return process_nevents();
 }
 /*---------------------------------------------------------------------------*/
 int
 process_nevents(void)
 {
-  return nevents + poll_requested;
+  int n;
+
+  n = nevents + poll_requested;
+#if PROCESS_CONF_PRIORITIES
+  n += nevents_high;
+#endif /* PROCESS_CONF_PRIORITIES */
+#if PROCESS_CONF_NUMEVENTS_ISR
+  n += (uint8_t)(isr_head - isr_tail);
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+  return n;
 }
 /*---------------------------------------------------------------------------*/
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
   process_num_events_t snum;
+#if PROCESS_CONF_PRIORITIES
+  bool deferred = false;
+#endif /* PROCESS_CONF_PRIORITIES */
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
@@ -332,6 +597,30 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
            p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p), nevents);
   }
 
+#if PROCESS_CONF_PRIORITIES
+  if(p != PROCESS_BROADCAST && p->priority == PROCESS_PRIORITY_HIGH &&
+     nevents_deferred == 0 && nevents_high < PROCESS_CONF_NUMEVENTS_HIGH) {
+    snum = (process_num_events_t)(fevent_high + nevents_high) %
+      PROCESS_CONF_NUMEVENTS_HIGH;
+    events_high[snum].ev = ev;
+    events_high[snum].data = data;
+    events_high[snum].p = p;
+#if PROCESS_CONF_PROFILE
+    events_high[snum].posted = RTIMER_NOW();
+#endif /* PROCESS_CONF_PROFILE */
+    ++nevents_high;
+#if PROCESS_CONF_STATS
+    if(nevents_high > process_maxevents_high) {
+      process_maxevents_high = nevents_high;
+    }
+#endif /* PROCESS_CONF_STATS */
+    return PROCESS_ERR_OK;
+  }
+  /* The high-priority queue is full, or events to high-priority
+     processes are already waiting in the regular queue */
+  deferred = p != PROCESS_BROADCAST && p->priority == PROCESS_PRIORITY_HIGH;
+#endif /* PROCESS_CONF_PRIORITIES */
+
   if(nevents == PROCESS_CONF_NUMEVENTS) {
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
@@ -347,7 +636,15 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
+#if PROCESS_CONF_PROFILE
+  events[snum].posted = RTIMER_NOW();
+#endif /* PROCESS_CONF_PROFILE */
   ++nevents;
+#if PROCESS_CONF_PRIORITIES
+  if(deferred) {
+    ++nevents_deferred;
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
 
 #if PROCESS_CONF_STATS
   if(nevents > process_maxevents) {
@@ -358,6 +655,37 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_NUMEVENTS_ISR
+int
+process_post_isr(struct process *p, process_event_t ev, process_data_t data)
+{
+  uint8_t head;
+  struct isr_event_data *e;
+  int_master_status_t status;
+
+  /* Reserve a slot. */
+  do {
+    head = isr_head;
+    if((uint8_t)(head - isr_tail) >= PROCESS_CONF_NUMEVENTS_ISR) {
+      status = critical_enter();
+      process_isr_overflows++;
+      critical_exit(status);
+      return PROCESS_ERR_FULL;
+    }
+  } while(!atomic_cas_uint8((uint8_t *)&isr_head, head, head + 1));
+
+  e = &isr_events[head % PROCESS_CONF_NUMEVENTS_ISR];
+  e->event.ev = ev;
+  e->event.data = data;
+  e->event.p = p;
+  /* Publish the slot only once it is filled in */
+  ISR_EVENT_BARRIER();
+  e->ready = 1;
+
+  return PROCESS_ERR_OK;
+}
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+/*---------------------------------------------------------------------------*/
 void
 process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 {
@@ -370,15 +698,54 @@ process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 void
 process_poll(struct process *p)
 {
+#if PROCESS_CONF_PRIORITIES
+  struct poll_queue *queue;
+  int_master_status_t status;
+#endif /* PROCESS_CONF_PRIORITIES */
+
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_CONF_PRIORITIES
+      status = critical_enter();
+      if(!p->needspoll) {
+#if PROCESS_CONF_PROFILE
+        p->poll_time = RTIMER_NOW();
+#endif /* PROCESS_CONF_PROFILE */
+        queue = p->priority == PROCESS_PRIORITY_HIGH ?
+          &poll_queue_high : &poll_queue_normal;
+        p->poll_next = NULL;
+        if(queue->tail == NULL) {
+          queue->head = p;
+        } else {
+          queue->tail->poll_next = p;
+        }
+        queue->tail = p;
+      }
       p->needspoll = 1;
       poll_requested = 1;
+      critical_exit(status);
+#else /* PROCESS_CONF_PRIORITIES */
+#if PROCESS_CONF_PROFILE
+      if(!p->needspoll) {
+        p->poll_time = RTIMER_NOW();
+      }
+#endif /* PROCESS_CONF_PROFILE */
+      p->needspoll = 1;
+      poll_requested = 1;
+#endif /* PROCESS_CONF_PRIORITIES */
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  p->priority = priority;
+}
+#endif /* PROCESS_CONF_PRIORITIES */
+/*---------------------------------------------------------------------------*/
 int
 process_is_running(struct process *p)
 {
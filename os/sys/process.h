@@ -88,6 +88,62 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * When PROCESS_CONF_PRIORITIES is enabled, the kernel keeps the
+ * processes that have requested a poll in a queue, so that a poll
+ * only touches those processes instead of walking the whole process
+ * list. Processes can also be marked as high priority with
+ * process_set_priority(): their polls are handled first, and events
+ * posted to them are kept in a separate queue of
+ * PROCESS_CONF_NUMEVENTS_HIGH events that is dispatched ahead of the
+ * regular event queue. When that queue is full, events to high-priority
+ * processes go to the regular queue, as do later ones until those have
+ * been dispatched, so that each process still receives its events in
+ * order. With PROCESS_CONF_STATS, the peak of that queue is in
+ * process_maxevents_high, apart from process_maxevents.
+ */
+#ifndef PROCESS_CONF_PRIORITIES
+#define PROCESS_CONF_PRIORITIES 0
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#ifndef PROCESS_CONF_NUMEVENTS_HIGH
+#define PROCESS_CONF_NUMEVENTS_HIGH 8
+#endif /* PROCESS_CONF_NUMEVENTS_HIGH */
+
+/*
+ * The number of events that can be posted from interrupt context with
+ * process_post_isr() before they are moved to the event queue by
+ * process_run(). This must be a power of two no larger than 128, or
+ * zero to disable process_post_isr().
+ */
+#ifndef PROCESS_CONF_NUMEVENTS_ISR
+#define PROCESS_CONF_NUMEVENTS_ISR 0
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+
+/*
+ * When PROCESS_CONF_PROFILE is enabled, the kernel keeps a struct
+ * process_profile in each process with the number of times the
+ * process has been called, the time spent in its thread, and the
+ * time its events and polls waited before being dispatched. All
+ * times are in rtimer ticks. This adds two rtimer reads to each
+ * process call, so it is disabled by default.
+ */
+#ifndef PROCESS_CONF_PROFILE
+#define PROCESS_CONF_PROFILE 0
+#endif /* PROCESS_CONF_PROFILE */
+
+#if PROCESS_CONF_PROFILE
+#include "sys/rtimer.h"
+#endif /* PROCESS_CONF_PROFILE */
+
+/**
+ * \name Process priorities
+ * @{
+ */
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   1
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -312,6 +368,24 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
 
 /** @} */
 
+#if PROCESS_CONF_PROFILE
+/**
+ * Run-time statistics of a process. The run time of a process
+ * includes the time spent in processes that it calls synchronously,
+ * e.g., with process_post_synch(). The wait time is measured from
+ * process_post() or process_poll() until the process is called, and
+ * is only recorded for events and polls taken from the queues.
+ */
+struct process_profile {
+  uint32_t calls;
+  uint32_t run_time;
+  uint32_t max_run_time;
+  uint32_t waits;
+  uint32_t wait_time;
+  uint32_t max_wait_time;
+};
+#endif /* PROCESS_CONF_PROFILE */
+
 struct process {
   struct process *next;
 #if PROCESS_CONF_NO_PROCESS_NAMES
@@ -323,6 +397,14 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_CONF_PRIORITIES
+  unsigned char priority;
+  struct process *poll_next;
+#endif /* PROCESS_CONF_PRIORITIES */
+#if PROCESS_CONF_PROFILE
+  rtimer_clock_t poll_time;
+  struct process_profile profile;
+#endif /* PROCESS_CONF_PROFILE */
 };
 
 /**
@@ -364,6 +446,39 @@ void process_start(struct process *p, process_data_t data);
  */
 int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+#if PROCESS_CONF_NUMEVENTS_ISR
+/**
+ * Post an asynchronous event from interrupt context.
+ *
+ * This function does the same as process_post(), but it may be called
+ * from interrupt handlers, including nested ones. The event is stored
+ * in a separate queue whose slots are reserved with an atomic
+ * compare-and-swap, and is moved to the event queue the next time
+ * process_run() is called. Events posted from interrupt context are
+ * delivered in the order in which their slots were reserved.
+ *
+ * \param p The process to which the event should be posted, or
+ * PROCESS_BROADCAST if the event should be posted to all processes.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \retval PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval PROCESS_ERR_FULL The queue was full and the event could not
+ * be posted. This is counted in process_isr_overflows.
+ */
+int process_post_isr(struct process *p, process_event_t ev,
+                     process_data_t data);
+
+/**
+ * The number of events that process_post_isr() failed to post because
+ * its queue was full.
+ */
+extern volatile uint32_t process_isr_overflows;
+#endif /* PROCESS_CONF_NUMEVENTS_ISR */
+
 /**
  * Post a synchronous event to a process.
  *
@@ -389,6 +504,34 @@ void process_post_synch(struct process *p,
  */
 void process_exit(struct process *p);
 
+/**
+ * \brief      Set the scheduling priority of a process
+ * \param p    The process
+ * \param priority PROCESS_PRIORITY_NORMAL or PROCESS_PRIORITY_HIGH
+ *
+ *             Polls of high-priority processes are handled before
+ *             those of other processes, and events posted to them
+ *             are dispatched ahead of the regular event queue. This
+ *             is intended for processes that must react quickly,
+ *             such as radio drivers. The priority is ignored unless
+ *             PROCESS_CONF_PRIORITIES is enabled.
+ */
+#if PROCESS_CONF_PRIORITIES
+void process_set_priority(struct process *p, unsigned char priority);
+#else /* PROCESS_CONF_PRIORITIES */
+#define process_set_priority(p, priority) do { } while(0)
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#if PROCESS_CONF_PROFILE
+/**
+ * \brief      Clear the profiles of all running processes
+ *
+ *             This only touches the processes in the process list,
+ *             and may be called at any time to start a new
+ *             measurement period.
+ */
+void process_profile_reset(void);
+#endif /* PROCESS_CONF_PROFILE */
 
 /**
  * Get a pointer to the currently running process.
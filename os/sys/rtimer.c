@@ -104,5 +104,17 @@ rtimer_run_next(void)
   return;
 }
 /*---------------------------------------------------------------------------*/
+int
+rtimer_pending(void)
+{
+  return next_rtimer != NULL;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_clock_t
+rtimer_next_expiration_time(void)
+{
+  return next_rtimer != NULL ? next_rtimer->time : 0;
+}
+/*---------------------------------------------------------------------------*/
 
 /** @}*/
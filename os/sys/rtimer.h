@@ -53,9 +53,10 @@
 #ifndef RTIMER_H_
 #define RTIMER_H_
 
-#include "contiki.h"
-#include "dev/watchdog.h"
-#include <stdbool.h>
+/* The clock type is defined before contiki.h is included, as
+   sys/process.h uses it when PROCESS_CONF_PROFILE is set */
+#include "contiki-conf.h"
+#include <stdint.h>
 
 /*---------------------------------------------------------------------------*/
 
@@ -89,6 +90,10 @@ typedef uint64_t rtimer_clock_t;
 #define RTIMER_CLOCK_MAX           ((rtimer_clock_t)-1)
 #define RTIMER_CLOCK_LT(a, b)      (RTIMER_CLOCK_DIFF((a),(b)) < 0)
 
+#include "contiki.h"
+#include "dev/watchdog.h"
+#include <stdbool.h>
+
 #include "rtimer-arch.h"
 
 
@@ -172,6 +177,19 @@ int rtimer_set(struct rtimer *task, rtimer_clock_t time,
  */
 void rtimer_run_next(void);
 
+/**
+ * \brief      Check if a real-time task is scheduled
+ * \return     Non-zero if a task is scheduled, zero otherwise.
+ */
+int rtimer_pending(void);
+
+/**
+ * \brief      Get the execution time of the scheduled real-time task
+ * \return     The time at which the scheduled task will be executed,
+ *             or zero if no task is scheduled.
+ */
+rtimer_clock_t rtimer_next_expiration_time(void);
+
 /**
  * \brief      Get the current clock time
  * \return     The current time
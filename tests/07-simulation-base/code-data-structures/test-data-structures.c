@@ -31,6 +31,7 @@
 /*---------------------------------------------------------------------------*/
 #include "contiki.h"
 #include "lib/list.h"
+#include "lib/tail-list.h"
 #include "lib/stack.h"
 #include "lib/queue.h"
 #include "lib/circular-list.h"
@@ -214,6 +215,118 @@ UNIT_TEST(test_list)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_tail_list, "Singly-linked list with tail pointer");
+UNIT_TEST(test_tail_list)
+{
+  demo_struct_t *head, *tail;
+
+  TAIL_LIST(lst);
+
+  UNIT_TEST_BEGIN();
+
+  memset(elements, 0, sizeof(elements));
+  tail_list_init(lst);
+
+  /* Starts from empty */
+  UNIT_TEST_ASSERT(tail_list_is_empty(lst) == true);
+  UNIT_TEST_ASSERT(tail_list_head(lst) == NULL);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == NULL);
+  UNIT_TEST_ASSERT(tail_list_pop(lst) == NULL);
+  UNIT_TEST_ASSERT(tail_list_chop(lst) == NULL);
+  UNIT_TEST_ASSERT(tail_list_length(lst) == 0);
+
+  /*
+   * Add an item. Should be head and tail
+   * 0 --> NULL
+   */
+  tail_list_add(lst, &elements[0]);
+  UNIT_TEST_ASSERT(tail_list_head(lst) == &elements[0]);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == &elements[0]);
+  UNIT_TEST_ASSERT(elements[0].next == NULL);
+  UNIT_TEST_ASSERT(tail_list_length(lst) == 1);
+
+  /*
+   * Add at both ends
+   * 1 --> 0 --> 2 --> NULL
+   */
+  tail_list_push(lst, &elements[1]);
+  tail_list_add(lst, &elements[2]);
+  UNIT_TEST_ASSERT(tail_list_head(lst) == &elements[1]);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == &elements[2]);
+  UNIT_TEST_ASSERT(elements[1].next == &elements[0]);
+  UNIT_TEST_ASSERT(elements[0].next == &elements[2]);
+  UNIT_TEST_ASSERT(tail_list_length(lst) == 3);
+
+  /*
+   * Insert after the tail. Should become the new tail
+   * 1 --> 0 --> 2 --> 3 --> NULL
+   */
+  tail_list_insert(lst, tail_list_tail(lst), &elements[3]);
+  tail = tail_list_tail(lst);
+  UNIT_TEST_ASSERT(tail == &elements[3]);
+  UNIT_TEST_ASSERT(tail->next == NULL);
+  UNIT_TEST_ASSERT(elements[2].next == tail);
+
+  /*
+   * Insert in the middle and at the head
+   * 4 --> 1 --> 5 --> 0 --> 2 --> 3 --> NULL
+   */
+  tail_list_insert(lst, &elements[1], &elements[5]);
+  tail_list_insert(lst, NULL, &elements[4]);
+  UNIT_TEST_ASSERT(tail_list_head(lst) == &elements[4]);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == &elements[3]);
+  UNIT_TEST_ASSERT(tail_list_item_next(&elements[1]) == &elements[5]);
+  UNIT_TEST_ASSERT(tail_list_item_next(&elements[5]) == &elements[0]);
+  UNIT_TEST_ASSERT(tail_list_length(lst) == 6);
+  UNIT_TEST_ASSERT(tail_list_contains(lst, &elements[5]));
+  UNIT_TEST_ASSERT(!tail_list_contains(lst, &elements[6]));
+
+  /*
+   * Remove the tail. The element before it becomes the tail
+   * 4 --> 1 --> 5 --> 0 --> 2 --> NULL
+   */
+  tail_list_remove(lst, &elements[3]);
+  tail = tail_list_tail(lst);
+  UNIT_TEST_ASSERT(tail == &elements[2]);
+  UNIT_TEST_ASSERT(tail->next == NULL);
+
+  /* Removing an element that is not on the list does nothing */
+  tail_list_remove(lst, &elements[3]);
+  UNIT_TEST_ASSERT(tail_list_length(lst) == 5);
+
+  /*
+   * Chop the tail and pop the head
+   * 1 --> 5 --> 0 --> NULL
+   */
+  UNIT_TEST_ASSERT(tail_list_chop(lst) == &elements[2]);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == &elements[0]);
+  UNIT_TEST_ASSERT(tail_list_pop(lst) == &elements[4]);
+  UNIT_TEST_ASSERT(elements[4].next == NULL);
+  head = tail_list_head(lst);
+  UNIT_TEST_ASSERT(head == &elements[1]);
+  UNIT_TEST_ASSERT(tail_list_length(lst) == 3);
+
+  /* Appending after a removal must use the updated tail */
+  tail_list_remove(lst, &elements[0]);
+  tail_list_add(lst, &elements[6]);
+  UNIT_TEST_ASSERT(elements[5].next == &elements[6]);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == &elements[6]);
+
+  /* Ends empty */
+  UNIT_TEST_ASSERT(tail_list_pop(lst) == &elements[1]);
+  UNIT_TEST_ASSERT(tail_list_pop(lst) == &elements[5]);
+  UNIT_TEST_ASSERT(tail_list_chop(lst) == &elements[6]);
+  UNIT_TEST_ASSERT(tail_list_is_empty(lst) == true);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == NULL);
+
+  /* An emptied list accepts new elements */
+  tail_list_add(lst, &elements[7]);
+  UNIT_TEST_ASSERT(tail_list_head(lst) == &elements[7]);
+  UNIT_TEST_ASSERT(tail_list_tail(lst) == &elements[7]);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 UNIT_TEST_REGISTER(test_stack, "Stack Push/Pop");
 UNIT_TEST(test_stack)
 {
@@ -723,6 +836,63 @@ UNIT_TEST(test_dll)
   UNIT_TEST_ASSERT(dbl_list_head(dll) == NULL);
   UNIT_TEST_ASSERT(dbl_list_tail(dll) == NULL);
 
+  /*
+   * Unlink the head, the tail and a middle element without searching
+   * NULL <-- 0 <--> 1 <--> 2 <--> 3 --> NULL
+   */
+  dbl_list_add_tail(dll, &elements[0]);
+  dbl_list_add_tail(dll, &elements[1]);
+  dbl_list_add_tail(dll, &elements[2]);
+  dbl_list_add_tail(dll, &elements[3]);
+  UNIT_TEST_ASSERT(dbl_list_length(dll) == 4);
+
+  dbl_list_unlink(dll, &elements[1]);
+  UNIT_TEST_ASSERT(elements[0].next == &elements[2]);
+  UNIT_TEST_ASSERT(elements[2].previous == &elements[0]);
+  UNIT_TEST_ASSERT(elements[1].next == NULL);
+  UNIT_TEST_ASSERT(elements[1].previous == NULL);
+
+  dbl_list_unlink(dll, &elements[0]);
+  head = dbl_list_head(dll);
+  UNIT_TEST_ASSERT(head == &elements[2]);
+  UNIT_TEST_ASSERT(head->previous == NULL);
+
+  dbl_list_unlink(dll, &elements[3]);
+  tail = dbl_list_tail(dll);
+  UNIT_TEST_ASSERT(tail == &elements[2]);
+  UNIT_TEST_ASSERT(tail->next == NULL);
+
+  dbl_list_unlink(dll, &elements[2]);
+  UNIT_TEST_ASSERT(dbl_list_is_empty(dll) == true);
+
+  /*
+   * Link at the start, at the end and in the middle without searching
+   * NULL <-- 7 <--> 4 <--> 6 <--> 5 --> NULL
+   */
+  dbl_list_link_after(dll, NULL, &elements[4]);
+  head = dbl_list_head(dll);
+  UNIT_TEST_ASSERT(head == &elements[4]);
+  UNIT_TEST_ASSERT(head->previous == NULL);
+  UNIT_TEST_ASSERT(head->next == NULL);
+
+  dbl_list_link_after(dll, &elements[4], &elements[5]);
+  tail = dbl_list_tail(dll);
+  UNIT_TEST_ASSERT(tail == &elements[5]);
+  UNIT_TEST_ASSERT(tail->previous == &elements[4]);
+  UNIT_TEST_ASSERT(tail->next == NULL);
+
+  dbl_list_link_after(dll, &elements[4], &elements[6]);
+  UNIT_TEST_ASSERT(dbl_list_length(dll) == 3);
+  UNIT_TEST_ASSERT(elements[4].next == &elements[6]);
+  UNIT_TEST_ASSERT(elements[6].previous == &elements[4]);
+  UNIT_TEST_ASSERT(elements[6].next == &elements[5]);
+  UNIT_TEST_ASSERT(elements[5].previous == &elements[6]);
+
+  dbl_list_link_after(dll, NULL, &elements[7]);
+  UNIT_TEST_ASSERT(dbl_list_head(dll) == &elements[7]);
+  UNIT_TEST_ASSERT(elements[4].previous == &elements[7]);
+  UNIT_TEST_ASSERT(dbl_list_length(dll) == 4);
+
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
@@ -1034,6 +1204,7 @@ PROCESS_THREAD(data_structure_test_process, ev, data)
   memset(elements, 0, sizeof(elements));
 
   UNIT_TEST_RUN(test_list);
+  UNIT_TEST_RUN(test_tail_list);
   UNIT_TEST_RUN(test_stack);
   UNIT_TEST_RUN(test_queue);
   UNIT_TEST_RUN(test_csll);
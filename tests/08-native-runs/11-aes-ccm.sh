@@ -1,3 +1,5 @@
 #!/bin/bash -e
 
+# Run the test with the byte-oriented AES, and then with the T-table.
 ./run-one.sh 11-aes-ccm
+DEFINES=AES_128_CONF_WITH_TTABLE=1 ./run-one.sh 11-aes-ccm
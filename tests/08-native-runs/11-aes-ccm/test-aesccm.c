@@ -31,11 +31,14 @@
 #include "contiki.h"
 #include "lib/random.h"
 #include "unit-test.h"
+#include "lib/aes-128.h"
 #include "lib/ccm-star.h"
 #include "lib/hexconv.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 
 #define MICLEN 8
 
@@ -52,6 +55,12 @@ static const char *testcases[][3] = {
 #define NUM_TESTSCASES (sizeof(testcases)/sizeof(testcases[0]))
 #define MAXLEN 65536
 
+/* A maximum-size 802.15.4 frame: 127 bytes, including the MIC and the
+   2-byte FCS. */
+#define FRAME_A_LEN 23
+#define FRAME_M_LEN (127 - 2 - FRAME_A_LEN - MICLEN)
+#define FRAME_ROUNDS 20000
+
 /*---------------------------------------------------------------------------*/
 UNIT_TEST_REGISTER(aesccm_encrypt, "AES-CCM encryption");
 UNIT_TEST(aesccm_encrypt)
@@ -166,6 +175,83 @@ UNIT_TEST(aesccm_decrypt)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+cycles_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aesccm_frame, "AES-CCM cost per 127-byte frame");
+UNIT_TEST(aesccm_frame)
+{
+  static uint8_t key_bytes[16];
+  static uint8_t nonce_bytes[13];
+  static uint8_t plaintext[FRAME_A_LEN + FRAME_M_LEN];
+  static uint8_t ciphertext[FRAME_A_LEN + FRAME_M_LEN + MICLEN];
+  static uint8_t frame[FRAME_A_LEN + FRAME_M_LEN + MICLEN];
+  uint8_t generated_mic[MICLEN];
+  uint64_t start_ns, start_cycles;
+  int i, forward;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(key, strlen(key), key_bytes, sizeof(key_bytes));
+  hexconv_unhexlify(nonce, strlen(nonce), nonce_bytes, sizeof(nonce_bytes));
+  for(i = 0; i < sizeof(plaintext); i++) {
+    plaintext[i] = random_rand();
+  }
+  memcpy(ciphertext, plaintext, sizeof(plaintext));
+  CCM_STAR.set_key(key_bytes);
+  CCM_STAR.aead(nonce_bytes,
+                ciphertext + FRAME_A_LEN, FRAME_M_LEN,
+                ciphertext, FRAME_A_LEN,
+                ciphertext + FRAME_A_LEN + FRAME_M_LEN, MICLEN, 1);
+
+  printf("AES T-table is %s\n", AES_128_WITH_TTABLE ? "enabled" : "disabled");
+
+  /* Set the key for every frame, as the MAC layers do. */
+  for(forward = 1; forward >= 0; forward--) {
+    start_ns = nsec_now();
+    start_cycles = cycles_now();
+    for(i = 0; i < FRAME_ROUNDS; i++) {
+      memcpy(frame, forward ? plaintext : ciphertext, sizeof(frame));
+      CCM_STAR.set_key(key_bytes);
+      CCM_STAR.aead(nonce_bytes,
+                    frame + FRAME_A_LEN, FRAME_M_LEN,
+                    frame, FRAME_A_LEN,
+                    forward ? frame + FRAME_A_LEN + FRAME_M_LEN : generated_mic,
+                    MICLEN, forward);
+    }
+    printf("%s: %lu ns, %lu cycles per frame\n",
+           forward ? "Encryption" : "Decryption",
+           (unsigned long)((nsec_now() - start_ns) / FRAME_ROUNDS),
+           (unsigned long)((cycles_now() - start_cycles) / FRAME_ROUNDS));
+    if(forward) {
+      UNIT_TEST_ASSERT(!memcmp(frame, ciphertext, sizeof(frame)));
+    } else {
+      UNIT_TEST_ASSERT(!memcmp(frame, plaintext, sizeof(plaintext)));
+      UNIT_TEST_ASSERT(!memcmp(generated_mic,
+                               ciphertext + FRAME_A_LEN + FRAME_M_LEN,
+                               MICLEN));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -175,6 +261,14 @@ PROCESS_THREAD(test_process, ev, data)
 
   UNIT_TEST_RUN(aesccm_encrypt);
   UNIT_TEST_RUN(aesccm_decrypt);
+  UNIT_TEST_RUN(aesccm_frame);
+
+  if(!UNIT_TEST_PASSED(aesccm_encrypt) ||
+     !UNIT_TEST_PASSED(aesccm_decrypt) ||
+     !UNIT_TEST_PASSED(aesccm_frame)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
 
   printf("=check-me= DONE\n");
   printf("---\n");
@@ -1,3 +1,5 @@
 #!/bin/bash -e
 
+# Run the test with a single free list, and then with size classes.
 ./run-one.sh 12-heapmem
+DEFINES=HEAPMEM_CONF_SIZE_CLASSES=1 ./run-one.sh 12-heapmem
@@ -32,6 +32,6 @@
 
 #define HEAPMEM_CONF_ARENA_SIZE 1000000
 #define HEAPMEM_CONF_REALLOC 1
-#define HEAPMEM_CONF_MAX_ZONES 2
+#define HEAPMEM_CONF_MAX_ZONES 3
 
 #endif /* !PROJECT_CONF_H */
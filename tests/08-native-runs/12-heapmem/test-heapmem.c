@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "contiki.h"
 #include "lib/heapmem.h"
@@ -67,6 +68,24 @@
 #define TEST_MAX_SIZE       200
 #endif
 /*****************************************************************************/
+/* Configuration for the fragmentation benchmark. */
+
+/* Total number of allocations. */
+#define FRAG_LIMIT       200000
+
+/* Number of short-lived and long-lived objects allocated concurrently. */
+#define FRAG_SHORT_LIVED    400
+#define FRAG_LONG_LIVED      50
+
+/* Allocation size ranges of the short-lived and long-lived objects. */
+#define FRAG_SHORT_MIN       16
+#define FRAG_SHORT_MAX      256
+#define FRAG_LONG_MIN       256
+#define FRAG_LONG_MAX      2048
+
+/* Number of allocations between samples of the fragmentation. */
+#define FRAG_SAMPLE_INTERVAL 1000
+/*****************************************************************************/
 PROCESS(test_heapmem_process, "Heapmem test process");
 AUTOSTART_PROCESSES(&test_heapmem_process);
 /*****************************************************************************/
@@ -180,6 +199,10 @@ UNIT_TEST(max_alloc)
   heapmem_stats_t stats_after;
   heapmem_stats(&stats_after);
 
+  /* The peak usage is the only statistic that should have changed. */
+  UNIT_TEST_ASSERT(stats_after.peak_allocated >= stats_before.available / 2);
+  stats_before.peak_allocated = stats_after.peak_allocated;
+
   UNIT_TEST_ASSERT(memcmp(&stats_before, &stats_after,
                           sizeof(heapmem_stats_t)) == 0);
 
@@ -277,6 +300,188 @@ UNIT_TEST(zones)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+UNIT_TEST_REGISTER(scratch_arenas, "Scratch arenas");
+UNIT_TEST(scratch_arenas)
+{
+#define SCRATCH_SIZE 1000
+
+  UNIT_TEST_BEGIN();
+
+  heapmem_scratch_t scratch;
+  heapmem_stats_t stats;
+  size_t alignment = heapmem_alignment();
+
+  heapmem_zone_t zone = heapmem_zone_register("Scratch", SCRATCH_SIZE * 2);
+  UNIT_TEST_ASSERT(zone != HEAPMEM_ZONE_INVALID);
+
+  /* The arena must fit in its zone. */
+  UNIT_TEST_ASSERT(!heapmem_scratch_init(&scratch, zone, SCRATCH_SIZE * 2));
+  UNIT_TEST_ASSERT(heapmem_scratch_init(&scratch, zone, SCRATCH_SIZE));
+
+  /* Objects are aligned, do not overlap, and are taken in order. */
+  char *a = heapmem_scratch_alloc(&scratch, 1);
+  char *b = heapmem_scratch_alloc(&scratch, 100);
+  char *c = heapmem_scratch_alloc(&scratch, 0);
+  UNIT_TEST_ASSERT(a != NULL && b != NULL && c != NULL);
+  UNIT_TEST_ASSERT(((uintptr_t)a & (alignment - 1)) == 0);
+  UNIT_TEST_ASSERT(((uintptr_t)b & (alignment - 1)) == 0);
+  UNIT_TEST_ASSERT(((uintptr_t)c & (alignment - 1)) == 0);
+  UNIT_TEST_ASSERT(b >= a + 1);
+  UNIT_TEST_ASSERT(c >= b + 100);
+  memset(a, 'a', 1);
+  memset(b, 'b', 100);
+
+  /* Allocations fail once the arena is full, also for sizes that
+     would wrap around. */
+  UNIT_TEST_ASSERT(heapmem_scratch_alloc(&scratch, SCRATCH_SIZE) == NULL);
+  UNIT_TEST_ASSERT(heapmem_scratch_alloc(&scratch, (size_t)-1) == NULL);
+  while(heapmem_scratch_alloc(&scratch, 10) != NULL) {
+  }
+  UNIT_TEST_ASSERT(scratch.used <= scratch.size);
+  UNIT_TEST_ASSERT(scratch.size - scratch.used < 10);
+
+  /* A reset releases all objects at once, and the space is reused. */
+  size_t peak = scratch.used;
+  heapmem_scratch_reset(&scratch);
+  UNIT_TEST_ASSERT(heapmem_scratch_alloc(&scratch, 1) == a);
+  UNIT_TEST_ASSERT(scratch.peak == peak);
+
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.peak_scratch >= peak);
+  UNIT_TEST_ASSERT(stats.allocated >= SCRATCH_SIZE);
+
+  /* The space of the arena is given back to the zone. */
+  heapmem_scratch_deinit(&scratch);
+  UNIT_TEST_ASSERT(heapmem_scratch_alloc(&scratch, 1) == NULL);
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+  UNIT_TEST_ASSERT(heapmem_scratch_init(&scratch, zone, SCRATCH_SIZE));
+  heapmem_scratch_deinit(&scratch);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static size_t
+random_size(size_t min, size_t max)
+{
+  return min + rand() % (max - min + 1);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fragmentation, "Fragmentation benchmark");
+UNIT_TEST(fragmentation)
+{
+  UNIT_TEST_BEGIN();
+
+  static char *short_lived[FRAG_SHORT_LIVED];
+  static char *long_lived[FRAG_LONG_LIVED];
+  uint64_t start, elapsed, total_time = 0, worst_time = 0;
+  unsigned failed_allocations = 0;
+  unsigned failed_deallocations = 0;
+  unsigned peak_fragmentation = 0;
+  size_t peak_footprint = 0;
+  heapmem_stats_t stats;
+
+#if HEAPMEM_SIZE_CLASSES
+  printf("Using segregated size classes\n");
+#else
+  printf("Using a single free list\n");
+#endif
+
+  /*
+   * Replace random short-lived objects, which are typical of packet
+   * and message buffers, and now and then a long-lived object, which
+   * splits the heap into regions that cannot be coalesced.
+   */
+  for(unsigned count = 0; count < FRAG_LIMIT; count++) {
+    char **slot;
+    size_t size;
+
+    if(count % 16 == 0) {
+      slot = &long_lived[rand() % FRAG_LONG_LIVED];
+      size = random_size(FRAG_LONG_MIN, FRAG_LONG_MAX);
+    } else {
+      slot = &short_lived[rand() % FRAG_SHORT_LIVED];
+      size = random_size(FRAG_SHORT_MIN, FRAG_SHORT_MAX);
+    }
+
+    if(*slot != NULL && !heapmem_free(*slot)) {
+      failed_deallocations++;
+    }
+
+    start = nsec_now();
+    *slot = heapmem_alloc(size);
+    elapsed = nsec_now() - start;
+
+    total_time += elapsed;
+    if(elapsed > worst_time) {
+      worst_time = elapsed;
+    }
+
+    if(*slot == NULL) {
+      failed_allocations++;
+    } else {
+      memset(*slot, '!', size);
+    }
+
+    /* The fragmentation is the share of the heap footprint that is
+       held by free chunks. */
+    if(count % FRAG_SAMPLE_INTERVAL == FRAG_SAMPLE_INTERVAL - 1) {
+      heapmem_stats(&stats);
+      if(stats.footprint > 0) {
+        unsigned fragmentation = 100 *
+          (stats.footprint - stats.allocated - stats.overhead) /
+          stats.footprint;
+        if(fragmentation > peak_fragmentation) {
+          peak_fragmentation = fragmentation;
+        }
+      }
+      if(stats.footprint > peak_footprint) {
+        peak_footprint = stats.footprint;
+      }
+    }
+  }
+
+  for(unsigned i = 0; i < FRAG_SHORT_LIVED; i++) {
+    if(short_lived[i] != NULL && !heapmem_free(short_lived[i])) {
+      failed_deallocations++;
+    }
+  }
+  for(unsigned i = 0; i < FRAG_LONG_LIVED; i++) {
+    if(long_lived[i] != NULL && !heapmem_free(long_lived[i])) {
+      failed_deallocations++;
+    }
+  }
+
+  printf("Allocation time: mean %lu ns, worst %lu ns\n",
+         (unsigned long)(total_time / FRAG_LIMIT),
+         (unsigned long)worst_time);
+  printf("Peak fragmentation: %u%%, peak footprint: %zu bytes\n",
+         peak_fragmentation, peak_footprint);
+  printf("Failed allocations: %u\n", failed_allocations);
+  printf("Failed deallocations: %u\n", failed_deallocations);
+
+#if HEAPMEM_SIZE_CLASSES
+  UNIT_TEST_ASSERT(failed_allocations == 0);
+#endif /* HEAPMEM_SIZE_CLASSES */
+  /* A single free list may get too fragmented to serve every request,
+     but every object that was allocated must be possible to free. */
+  UNIT_TEST_ASSERT(failed_deallocations == 0);
+
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 PROCESS_THREAD(test_heapmem_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -294,12 +499,16 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
   UNIT_TEST_RUN(reallocations);
   UNIT_TEST_RUN(stats_check);
   UNIT_TEST_RUN(zones);
+  UNIT_TEST_RUN(scratch_arenas);
+  UNIT_TEST_RUN(fragmentation);
 
   if(!UNIT_TEST_PASSED(do_many_allocations) ||
      !UNIT_TEST_PASSED(max_alloc) ||
      !UNIT_TEST_PASSED(invalid_freeing) ||
      !UNIT_TEST_PASSED(stats_check) ||
-     !UNIT_TEST_PASSED(zones)) {
+     !UNIT_TEST_PASSED(zones) ||
+     !UNIT_TEST_PASSED(scratch_arenas) ||
+     !UNIT_TEST_PASSED(fragmentation)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# Run the test with the default list backend, and then with the heap backend.
+./run-one.sh 14-etimer
+DEFINES=ETIMER_CONF_HEAP=1 ./run-one.sh 14-etimer
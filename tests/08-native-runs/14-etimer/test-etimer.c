@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and a micro-benchmark for the event timer backends.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The largest number of concurrently pending timers in the tests. */
+#define MAX_TIMERS          1000
+
+/* The number of timers used in the expiration test. */
+#define EXPIRATION_TIMERS    200
+
+/* The number of operations measured for each benchmark size. */
+#define BENCHMARK_ROUNDS   20000
+/*****************************************************************************/
+PROCESS(test_etimer_process, "Etimer test process");
+PROCESS(stale_process, "Process that exits with a pending timer");
+AUTOSTART_PROCESSES(&test_etimer_process);
+/*****************************************************************************/
+static struct etimer timers[MAX_TIMERS];
+static uint8_t fired[MAX_TIMERS];
+static uint8_t stopped[MAX_TIMERS];
+static unsigned early_expirations;
+/* A timer that was never set: in uninitialized memory, as on the stack
+   or from malloc(), with the list backend, and zeroed with the heap
+   backend, which requires it */
+static struct etimer *garbage;
+static uint8_t garbage_fired;
+/* A timer left pending by a process that exited */
+static struct etimer stale;
+static uint8_t stale_expired;
+static uint8_t stale_fired;
+/* A zero-initialized timer that is never set */
+static struct etimer never_set;
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+benchmark(unsigned n)
+{
+  uint64_t start, set_time, stop_time, next_time;
+  clock_time_t next;
+  unsigned i, r;
+
+  for(i = 0; i < n; i++) {
+    etimer_set(&timers[i], 100 * CLOCK_SECOND + rand() % (10 * CLOCK_SECOND));
+  }
+
+  /* Rearm random pending timers. */
+  start = nsec_now();
+  for(r = 0; r < BENCHMARK_ROUNDS; r++) {
+    i = rand() % n;
+    etimer_set(&timers[i], 100 * CLOCK_SECOND + rand() % (10 * CLOCK_SECOND));
+  }
+  set_time = nsec_now() - start;
+
+  /* Stop and restart random pending timers. */
+  start = nsec_now();
+  for(r = 0; r < BENCHMARK_ROUNDS; r++) {
+    i = rand() % n;
+    etimer_stop(&timers[i]);
+    etimer_set(&timers[i], 100 * CLOCK_SECOND + rand() % (10 * CLOCK_SECOND));
+  }
+  stop_time = nsec_now() - start;
+
+  start = nsec_now();
+  next = 0;
+  for(r = 0; r < BENCHMARK_ROUNDS; r++) {
+    next += etimer_next_expiration_time();
+  }
+  next_time = nsec_now() - start;
+
+  for(i = 0; i < n; i++) {
+    etimer_stop(&timers[i]);
+  }
+
+  printf("%4u timers: set %4lu ns, stop+set %4lu ns, next expiration %4lu ns"
+         " (checksum %lu)\n",
+         n, (unsigned long)(set_time / BENCHMARK_ROUNDS),
+         (unsigned long)(stop_time / BENCHMARK_ROUNDS),
+         (unsigned long)(next_time / BENCHMARK_ROUNDS),
+         (unsigned long)next);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(benchmark_timers, "Event timer operation cost");
+UNIT_TEST(benchmark_timers)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("Using the %s backend\n", ETIMER_HEAP ? "heap" : "list");
+
+  benchmark(10);
+  benchmark(100);
+  benchmark(1000);
+
+  for(unsigned i = 0; i < MAX_TIMERS; i++) {
+    UNIT_TEST_ASSERT(etimer_expired(&timers[i]));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(expirations, "Event timer expirations");
+UNIT_TEST(expirations)
+{
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < EXPIRATION_TIMERS; i++) {
+    UNIT_TEST_ASSERT(fired[i] == !stopped[i]);
+  }
+  UNIT_TEST_ASSERT(early_expirations == 0);
+  UNIT_TEST_ASSERT(garbage_fired == 1);
+  UNIT_TEST_ASSERT(stale_expired);
+  UNIT_TEST_ASSERT(stale_fired == 1);
+  UNIT_TEST_ASSERT(etimer_expired(&never_set));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(stale_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  etimer_set(&stale, CLOCK_SECOND);
+
+  PROCESS_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_etimer_process, ev, data)
+{
+  static unsigned i;
+  static unsigned remaining;
+  struct etimer *et;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  srand(500);
+
+  UNIT_TEST_RUN(benchmark_timers);
+
+  /* Set a number of short timers, rearm and adjust some of them, and
+     stop every fifth one. */
+  remaining = 0;
+  for(i = 0; i < EXPIRATION_TIMERS; i++) {
+    etimer_set(&timers[i], 1 + rand() % (CLOCK_SECOND / 4));
+    if(i % 3 == 0) {
+      etimer_set(&timers[i], 1 + rand() % (CLOCK_SECOND / 4));
+    }
+    if(i % 7 == 0) {
+      etimer_adjust(&timers[i], rand() % 10);
+    }
+    remaining++;
+  }
+  for(i = 0; i < EXPIRATION_TIMERS; i += 5) {
+    etimer_stop(&timers[i]);
+    stopped[i] = 1;
+    remaining--;
+  }
+
+  garbage = malloc(sizeof(*garbage));
+  memset(garbage, ETIMER_HEAP ? 0 : 0xa5, sizeof(*garbage));
+  etimer_set(garbage, 1 + rand() % (CLOCK_SECOND / 4));
+  remaining++;
+
+  etimer_stop(&never_set);
+  etimer_adjust(&never_set, 1);
+
+  /* The timer of an exited process is no longer pending, and can be
+     stopped, adjusted and set again */
+  process_start(&stale_process, NULL);
+  stale_expired = etimer_expired(&stale);
+  etimer_stop(&stale);
+  etimer_adjust(&stale, 1);
+  etimer_set(&stale, 1 + rand() % (CLOCK_SECOND / 4));
+  remaining++;
+
+  while(remaining > 0) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    et = data;
+    i = et - timers;
+    if(i < EXPIRATION_TIMERS) {
+      fired[i]++;
+      remaining--;
+      if(!etimer_expired(et) ||
+         (clock_time_t)(clock_time() - etimer_start_time(et)) <
+         et->timer.interval) {
+        early_expirations++;
+      }
+    } else if(et == garbage) {
+      garbage_fired++;
+      remaining--;
+    } else if(et == &stale) {
+      stale_fired++;
+      remaining--;
+    }
+  }
+
+  UNIT_TEST_RUN(expirations);
+  free(garbage);
+
+  if(!UNIT_TEST_PASSED(benchmark_timers) ||
+     !UNIT_TEST_PASSED(expirations)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,7 @@
+#!/bin/bash -e
+
+# Run the test with the default scheduler, with process priorities,
+# and with process profiling.
+./run-one.sh 15-process
+DEFINES=PROCESS_CONF_PRIORITIES=1 ./run-one.sh 15-process
+DEFINES=PROCESS_CONF_PROFILE=1 ./run-one.sh 15-process
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Measurements of the poll-to-run and post-to-run latency of a
+ *      process while the event queue is loaded.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of idle processes in the process list. */
+#define IDLE_PROCESSES       100
+
+/* The number of latency samples of each kind. */
+#define SAMPLES             1000
+
+/* The time spent by the load process in each event handler. */
+#define LOAD_HANDLER_NSEC  10000
+
+/* The number of events posted at once in the order test. */
+#define ORDER_EVENTS       (PROCESS_CONF_NUMEVENTS_HIGH + 4)
+/*****************************************************************************/
+PROCESS(test_process_process, "Process test process");
+PROCESS(load_process, "Load process");
+PROCESS(driver_process, "Driver process");
+PROCESS(order_process, "Order process");
+AUTOSTART_PROCESSES(&test_process_process);
+/*****************************************************************************/
+static struct process idle_processes[IDLE_PROCESSES];
+
+struct latency {
+  uint64_t requested;
+  uint64_t total;
+  uint64_t max;
+  unsigned samples;
+  bool pending;
+};
+static struct latency poll_latency;
+static struct latency post_latency;
+static process_event_t sample_event;
+static unsigned load_events;
+static uintptr_t order_next;
+static uintptr_t order_last;
+static unsigned order_received;
+static unsigned order_errors;
+static unsigned order_refused;
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+add_sample(struct latency *l)
+{
+  uint64_t diff;
+
+  if(!l->pending) {
+    return;
+  }
+  l->pending = false;
+  diff = nsec_now() - l->requested;
+  l->total += diff;
+  if(diff > l->max) {
+    l->max = diff;
+  }
+  l->samples++;
+}
+/*****************************************************************************/
+static void
+request_sample(struct latency *l)
+{
+  l->requested = nsec_now();
+  l->pending = true;
+}
+/*****************************************************************************/
+static void
+print_latency(const char *name, const struct latency *l)
+{
+  printf("%s latency: average %lu ns, max %lu ns (%u samples)\n",
+         name, (unsigned long)(l->total / (l->samples ? l->samples : 1)),
+         (unsigned long)l->max, l->samples);
+}
+/*****************************************************************************/
+static PT_THREAD(idle_thread(struct pt *pt, process_event_t ev,
+                             process_data_t data))
+{
+  PT_BEGIN(pt);
+  while(1) {
+    PT_YIELD(pt);
+  }
+  PT_END(pt);
+}
+/*****************************************************************************/
+PROCESS_THREAD(load_process, ev, data)
+{
+  uint64_t start;
+
+  PROCESS_BEGIN();
+
+  /* Keep the event queue nearly full. */
+  while(process_post(&load_process, PROCESS_EVENT_CONTINUE, NULL) ==
+        PROCESS_ERR_OK &&
+        process_nevents() < PROCESS_CONF_NUMEVENTS - 2);
+
+  while(poll_latency.samples < SAMPLES || post_latency.samples < SAMPLES) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+
+    start = nsec_now();
+    while(nsec_now() - start < LOAD_HANDLER_NSEC);
+
+    load_events++;
+    if(!poll_latency.pending && poll_latency.samples < SAMPLES) {
+      request_sample(&poll_latency);
+      process_poll(&driver_process);
+    }
+    if(!post_latency.pending && post_latency.samples < SAMPLES) {
+      request_sample(&post_latency);
+      process_post(&driver_process, sample_event, NULL);
+    }
+    process_post(&load_process, PROCESS_EVENT_CONTINUE, NULL);
+  }
+
+  process_post(&test_process_process, PROCESS_EVENT_CONTINUE, NULL);
+
+  PROCESS_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(driver_process, ev, data)
+{
+  PROCESS_POLLHANDLER(add_sample(&poll_latency));
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == sample_event) {
+      add_sample(&post_latency);
+    }
+  }
+
+  PROCESS_END();
+}
+/*****************************************************************************/
+/* Checks that the events posted with increasing numbers arrive in order,
+ * and posts one more on the first event, when the queues are still busy */
+PROCESS_THREAD(order_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    if(order_received > 0 && (uintptr_t)data <= order_last) {
+      order_errors++;
+    }
+    if(order_received == 0 &&
+       process_post(&order_process, PROCESS_EVENT_CONTINUE,
+                    (process_data_t)order_next) == PROCESS_ERR_OK) {
+      order_next++;
+    }
+    order_last = (uintptr_t)data;
+    order_received++;
+  }
+
+  PROCESS_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(order, "Order of events to a high-priority process");
+UNIT_TEST(order)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("%u events received out of order, %u in total, %u refused\n",
+         order_errors, order_received, order_refused);
+  UNIT_TEST_ASSERT(order_received >= ORDER_EVENTS);
+  UNIT_TEST_ASSERT(order_errors == 0);
+  UNIT_TEST_ASSERT(order_refused == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(latency, "Poll and post latency under load");
+UNIT_TEST(latency)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("Process priorities are %s\n",
+         PROCESS_CONF_PRIORITIES ? "enabled" : "disabled");
+  printf("%u processes, %u load events\n",
+         IDLE_PROCESSES + 3, load_events);
+  print_latency("Poll-to-run", &poll_latency);
+  print_latency("Post-to-run", &post_latency);
+
+  UNIT_TEST_ASSERT(poll_latency.samples == SAMPLES);
+  UNIT_TEST_ASSERT(post_latency.samples == SAMPLES);
+
+  UNIT_TEST_END();
+}
+#if PROCESS_CONF_PROFILE
+/*****************************************************************************/
+static void
+print_profile(const struct process *p)
+{
+  printf("%s: %lu calls, run %lu ticks (max %lu), %lu waits (avg %lu, max %lu)\n",
+         PROCESS_NAME_STRING(p), (unsigned long)p->profile.calls,
+         (unsigned long)p->profile.run_time,
+         (unsigned long)p->profile.max_run_time,
+         (unsigned long)p->profile.waits,
+         (unsigned long)(p->profile.wait_time /
+                         (p->profile.waits ? p->profile.waits : 1)),
+         (unsigned long)p->profile.max_wait_time);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(profile, "Process profiles");
+UNIT_TEST(profile)
+{
+  UNIT_TEST_BEGIN();
+
+  print_profile(&load_process);
+  print_profile(&driver_process);
+
+  /* The load process is started synchronously, and then only runs on
+     its own events. */
+  UNIT_TEST_ASSERT(load_process.profile.calls >= load_events + 1);
+  UNIT_TEST_ASSERT(load_process.profile.waits ==
+                   load_process.profile.calls - 1);
+  UNIT_TEST_ASSERT(load_process.profile.run_time >=
+                   load_process.profile.max_run_time);
+
+  /* The driver process runs once per poll and once per sample event,
+     and is also called synchronously when it starts and when the load
+     process exits. */
+  UNIT_TEST_ASSERT(driver_process.profile.waits >= 2 * SAMPLES);
+  UNIT_TEST_ASSERT(driver_process.profile.calls ==
+                   driver_process.profile.waits + 2);
+  UNIT_TEST_ASSERT(driver_process.profile.wait_time >=
+                   driver_process.profile.max_wait_time);
+
+  /* The idle processes are never posted to. */
+  UNIT_TEST_ASSERT(idle_processes[0].profile.calls >= 2);
+  UNIT_TEST_ASSERT(idle_processes[0].profile.waits == 0);
+
+  /* Only processes that are still running are cleared. */
+  process_profile_reset();
+  UNIT_TEST_ASSERT(driver_process.profile.calls == 0);
+  UNIT_TEST_ASSERT(driver_process.profile.max_wait_time == 0);
+  UNIT_TEST_ASSERT(load_process.profile.calls != 0);
+
+  UNIT_TEST_END();
+}
+#endif /* PROCESS_CONF_PROFILE */
+/*****************************************************************************/
+PROCESS_THREAD(test_process_process, ev, data)
+{
+  static unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  sample_event = process_alloc_event();
+
+  for(i = 0; i < IDLE_PROCESSES; i++) {
+    memset(&idle_processes[i], 0, sizeof(idle_processes[i]));
+#if !PROCESS_CONF_NO_PROCESS_NAMES
+    idle_processes[i].name = "Idle process";
+#endif /* !PROCESS_CONF_NO_PROCESS_NAMES */
+    idle_processes[i].thread = idle_thread;
+    process_start(&idle_processes[i], NULL);
+  }
+
+  process_set_priority(&driver_process, PROCESS_PRIORITY_HIGH);
+  process_start(&driver_process, NULL);
+  process_start(&load_process, NULL);
+
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+
+  UNIT_TEST_RUN(latency);
+#if PROCESS_CONF_PROFILE
+  UNIT_TEST_RUN(profile);
+  if(!UNIT_TEST_PASSED(profile)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+#endif /* PROCESS_CONF_PROFILE */
+
+  /* Post more events than the high-priority queue holds */
+  process_set_priority(&order_process, PROCESS_PRIORITY_HIGH);
+  process_start(&order_process, NULL);
+  for(i = 0; i < ORDER_EVENTS; i++) {
+    if(process_post(&order_process, PROCESS_EVENT_CONTINUE,
+                    (process_data_t)order_next) == PROCESS_ERR_OK) {
+      order_next++;
+    } else {
+      order_refused++;
+    }
+  }
+  process_post(&test_process_process, PROCESS_EVENT_CONTINUE, NULL);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+  UNIT_TEST_RUN(order);
+
+  if(!UNIT_TEST_PASSED(latency) || !UNIT_TEST_PASSED(order)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      A stress test of process_post_isr(). Events are posted in bursts
+ *      from a signal handler while the main loop drains them.
+ *
+ *      The signal handler interrupts the main loop at arbitrary points,
+ *      like an interrupt handler, but runs on the same core. The test
+ *      therefore covers the reservation of slots and the ordering of
+ *      events, but not the memory barriers of the ready handshake, which
+ *      only matter when the CPU or another core reorders memory accesses.
+ */
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of events posted in each signal handler invocation. A
+   burst larger than the ISR queue causes overflows. */
+#define BURST_SIZE               24
+
+/* The number of events to post in total. */
+#define TOTAL_EVENTS          24000
+
+/* The interval of the profiling timer that triggers the handler. */
+#define SIGNAL_INTERVAL_USEC    100
+/*****************************************************************************/
+PROCESS(test_process_isr_process, "ISR post test process");
+AUTOSTART_PROCESSES(&test_process_isr_process);
+/*****************************************************************************/
+static process_event_t isr_event;
+static volatile uint32_t posted;
+static volatile uint32_t attempted;
+static volatile sig_atomic_t signals;
+static uint32_t received;
+static uint32_t out_of_order;
+/*****************************************************************************/
+static void
+signal_handler(int signo)
+{
+  signals++;
+  for(unsigned i = 0; i < BURST_SIZE && attempted < TOTAL_EVENTS; i++) {
+    /* The sequence number is the number of successfully posted events. */
+    if(process_post_isr(&test_process_isr_process, isr_event,
+                        (process_data_t)(uintptr_t)posted) ==
+       PROCESS_ERR_OK) {
+      posted++;
+    }
+    attempted++;
+  }
+}
+/*****************************************************************************/
+static void
+start_signals(void)
+{
+  struct itimerval val;
+
+  signal(SIGPROF, signal_handler);
+  memset(&val, 0, sizeof(val));
+  val.it_interval.tv_usec = SIGNAL_INTERVAL_USEC;
+  val.it_value.tv_usec = SIGNAL_INTERVAL_USEC;
+  setitimer(ITIMER_PROF, &val, NULL);
+}
+/*****************************************************************************/
+static void
+stop_signals(void)
+{
+  struct itimerval val;
+
+  memset(&val, 0, sizeof(val));
+  setitimer(ITIMER_PROF, &val, NULL);
+  signal(SIGPROF, SIG_DFL);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(isr_posting, "Posting from interrupt context");
+UNIT_TEST(isr_posting)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("%u signals, %lu attempts, %lu posted, %lu received, "
+         "%lu overflows\n", (unsigned)signals,
+         (unsigned long)attempted, (unsigned long)posted,
+         (unsigned long)received, (unsigned long)process_isr_overflows);
+
+  UNIT_TEST_ASSERT(attempted == TOTAL_EVENTS);
+  UNIT_TEST_ASSERT(received == posted);
+  UNIT_TEST_ASSERT(out_of_order == 0);
+  UNIT_TEST_ASSERT(posted + process_isr_overflows == attempted);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_process_isr_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  isr_event = process_alloc_event();
+  start_signals();
+
+  /* Keep the main loop busy so that the profiling timer runs, and
+     check that the events arrive in sequence. */
+  process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+  while(attempted < TOTAL_EVENTS || received < posted) {
+    PROCESS_WAIT_EVENT();
+    if(ev == isr_event) {
+      if((uintptr_t)data != received) {
+        out_of_order++;
+      }
+      received++;
+    } else if(ev == PROCESS_EVENT_CONTINUE) {
+      process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+    }
+  }
+
+  stop_signals();
+
+  UNIT_TEST_RUN(isr_posting);
+
+  if(!UNIT_TEST_PASSED(isr_posting)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
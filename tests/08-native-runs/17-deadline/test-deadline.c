@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the next deadline service.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "sys/deadline.h"
+#include "sys/energest.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+PROCESS(test_deadline_process, "Deadline test process");
+AUTOSTART_PROCESSES(&test_deadline_process);
+/*****************************************************************************/
+static struct etimer et;
+static struct rtimer rt;
+static rtimer_clock_t source_deadline;
+/*****************************************************************************/
+static int
+next_source_deadline(rtimer_clock_t *deadline)
+{
+  *deadline = source_deadline;
+  return 1;
+}
+static struct deadline_source source = { NULL, next_source_deadline };
+/*****************************************************************************/
+static void
+rtimer_callback(struct rtimer *t, void *ptr)
+{
+}
+/*****************************************************************************/
+/* Check that a deadline is ahead by the expected time, with some slack
+   for the time spent in the test. */
+static int
+ahead_by(rtimer_clock_t deadline, rtimer_clock_t expected)
+{
+  rtimer_clock_t ahead = deadline - RTIMER_NOW();
+
+  return ahead <= expected && ahead + RTIMER_SECOND / 20 >= expected;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(next_deadline, "Combined next deadline");
+UNIT_TEST(next_deadline)
+{
+  rtimer_clock_t deadline;
+
+  UNIT_TEST_BEGIN();
+
+  /* Event timers. The system itself may have shorter timers pending,
+     so only an upper bound can be checked here. */
+  etimer_set(&et, CLOCK_SECOND / 2);
+  UNIT_TEST_ASSERT(deadline_next(&deadline));
+  UNIT_TEST_ASSERT((rtimer_clock_t)(deadline - RTIMER_NOW()) <=
+                   RTIMER_SECOND / 2);
+
+  /* A real-time task. */
+  rtimer_set(&rt, RTIMER_NOW() + RTIMER_SECOND / 5, 0, rtimer_callback, NULL);
+  UNIT_TEST_ASSERT(rtimer_pending());
+  UNIT_TEST_ASSERT(deadline_next(&deadline));
+  UNIT_TEST_ASSERT((rtimer_clock_t)(deadline - RTIMER_NOW()) <=
+                   RTIMER_SECOND / 5);
+
+  /* A registered subsystem with an earlier deadline. */
+  source_deadline = RTIMER_NOW() + RTIMER_SECOND / 10;
+  deadline_source_register(&source);
+  UNIT_TEST_ASSERT(deadline_next(&deadline));
+  UNIT_TEST_ASSERT(ahead_by(deadline, RTIMER_SECOND / 10));
+
+  /* Deadlines in the past are due now. */
+  source_deadline = RTIMER_NOW() - RTIMER_SECOND;
+  UNIT_TEST_ASSERT(deadline_next(&deadline));
+  UNIT_TEST_ASSERT(ahead_by(deadline, 0));
+
+  deadline_source_unregister(&source);
+  etimer_stop(&et);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(wakeup_accounting, "Wake-up accounting");
+UNIT_TEST(wakeup_accounting)
+{
+  uint32_t wakeups, avoided;
+
+  UNIT_TEST_BEGIN();
+
+  wakeups = energest_wakeups;
+  avoided = energest_wakeups_avoided;
+
+  deadline_wakeup(100, 100);
+  UNIT_TEST_ASSERT(energest_wakeups == wakeups + 1);
+  UNIT_TEST_ASSERT(energest_wakeups_avoided == avoided);
+
+  deadline_wakeup(350, 100);
+  UNIT_TEST_ASSERT(energest_wakeups == wakeups + 2);
+  UNIT_TEST_ASSERT(energest_wakeups_avoided == avoided + 3);
+
+  deadline_wakeup(350, 0);
+  UNIT_TEST_ASSERT(energest_wakeups == wakeups + 3);
+  UNIT_TEST_ASSERT(energest_wakeups_avoided == avoided + 3);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_deadline_process, ev, data)
+{
+  static uint32_t wakeups, avoided;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(next_deadline);
+  UNIT_TEST_RUN(wakeup_accounting);
+
+  /* Let the node idle for a while, and report the wake-ups. */
+  wakeups = energest_wakeups;
+  avoided = energest_wakeups_avoided;
+  etimer_set(&et, 5 * CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  printf("Idle for 5 seconds: %lu wake-ups, %lu avoided\n",
+         (unsigned long)(energest_wakeups - wakeups),
+         (unsigned long)(energest_wakeups_avoided - avoided));
+
+  if(!UNIT_TEST_PASSED(next_deadline) ||
+     !UNIT_TEST_PASSED(wakeup_accounting)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# Run the test with the default flag array, and then with the bitmap.
+./run-one.sh 18-memb
+DEFINES=MEMB_CONF_BITMAP=1 ./run-one.sh 18-memb
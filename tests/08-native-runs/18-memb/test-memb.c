@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and a micro-benchmark for the memory block allocator.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of fill and drain cycles measured for each pool. */
+#define BENCHMARK_ROUNDS 200
+
+#define MAX_BLOCKS 512
+/*****************************************************************************/
+struct block {
+  uint32_t data[4];
+};
+
+MEMB(pool8, struct block, 8);
+MEMB(pool16, struct block, 16);
+MEMB(pool32, struct block, 32);
+MEMB(pool64, struct block, 64);
+MEMB(pool128, struct block, 128);
+MEMB(pool256, struct block, 256);
+MEMB(pool512, struct block, 512);
+/* An odd size that does not fill the last bitmap word. */
+MEMB(pool_odd, struct block, 37);
+
+static struct block *blocks[MAX_BLOCKS];
+/*****************************************************************************/
+PROCESS(test_memb_process, "Memb test process");
+AUTOSTART_PROCESSES(&test_memb_process);
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+benchmark(struct memb *m)
+{
+  uint64_t start, alloc_time, free_time;
+  unsigned i, r;
+
+  memb_init(m);
+  alloc_time = free_time = 0;
+
+  for(r = 0; r < BENCHMARK_ROUNDS; r++) {
+    start = nsec_now();
+    for(i = 0; i < m->num; i++) {
+      blocks[i] = memb_alloc(m);
+    }
+    alloc_time += nsec_now() - start;
+
+    /* Free the blocks in reverse order, which is the worst case for a
+       linear search from the start of the pool. */
+    start = nsec_now();
+    for(i = m->num; i > 0; i--) {
+      memb_free(m, blocks[i - 1]);
+    }
+    free_time += nsec_now() - start;
+  }
+
+  printf("%3u blocks: alloc %4lu ns, free %4lu ns\n", m->num,
+         (unsigned long)(alloc_time / ((uint64_t)BENCHMARK_ROUNDS * m->num)),
+         (unsigned long)(free_time / ((uint64_t)BENCHMARK_ROUNDS * m->num)));
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(benchmark_memb, "Memb operation cost");
+UNIT_TEST(benchmark_memb)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("Using the %s allocation state\n", MEMB_BITMAP ? "bitmap" : "flag");
+
+  benchmark(&pool8);
+  benchmark(&pool16);
+  benchmark(&pool32);
+  benchmark(&pool64);
+  benchmark(&pool128);
+  benchmark(&pool256);
+  benchmark(&pool512);
+
+  UNIT_TEST_ASSERT(memb_numfree(&pool512) == 512);
+  UNIT_TEST_ASSERT(memb_high_water(&pool512) == 512);
+  UNIT_TEST_ASSERT(memb_failures(&pool512) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(alloc_free, "Memb allocation and release");
+UNIT_TEST(alloc_free)
+{
+  unsigned i, j;
+  struct block *b;
+
+  UNIT_TEST_BEGIN();
+
+  memb_init(&pool_odd);
+  UNIT_TEST_ASSERT(memb_numfree(&pool_odd) == 37);
+
+  /* Every block is handed out once and lies inside the pool. */
+  for(i = 0; i < pool_odd.num; i++) {
+    blocks[i] = memb_alloc(&pool_odd);
+    UNIT_TEST_ASSERT(blocks[i] != NULL);
+    UNIT_TEST_ASSERT(memb_inmemb(&pool_odd, blocks[i]));
+    for(j = 0; j < i; j++) {
+      UNIT_TEST_ASSERT(blocks[i] != blocks[j]);
+    }
+  }
+  UNIT_TEST_ASSERT(memb_numfree(&pool_odd) == 0);
+  UNIT_TEST_ASSERT(memb_alloc(&pool_odd) == NULL);
+  UNIT_TEST_ASSERT(memb_alloc(&pool_odd) == NULL);
+  UNIT_TEST_ASSERT(memb_failures(&pool_odd) == 2);
+  UNIT_TEST_ASSERT(memb_high_water(&pool_odd) == 37);
+
+  /* A freed block is the next one to be allocated. */
+  UNIT_TEST_ASSERT(memb_free(&pool_odd, blocks[20]) == 0);
+  UNIT_TEST_ASSERT(memb_numfree(&pool_odd) == 1);
+  b = memb_alloc(&pool_odd);
+  UNIT_TEST_ASSERT(b == blocks[20]);
+
+  /* Invalid frees are rejected and do not change the state. */
+  UNIT_TEST_ASSERT(memb_free(&pool_odd, blocks[5]) == 0);
+  UNIT_TEST_ASSERT(memb_free(&pool_odd, blocks[5]) == -1);
+  UNIT_TEST_ASSERT(memb_free(&pool_odd, (char *)blocks[6] + 1) == -1);
+  UNIT_TEST_ASSERT(memb_free(&pool_odd, &i) == -1);
+  UNIT_TEST_ASSERT(memb_free(&pool_odd, blocks[36] + 1) == -1);
+  UNIT_TEST_ASSERT(memb_numfree(&pool_odd) == 1);
+
+  for(i = 0; i < pool_odd.num; i++) {
+    if(i != 5) {
+      UNIT_TEST_ASSERT(memb_free(&pool_odd, blocks[i]) == 0);
+    }
+  }
+  UNIT_TEST_ASSERT(memb_numfree(&pool_odd) == 37);
+  UNIT_TEST_ASSERT(memb_high_water(&pool_odd) == 37);
+
+  /* Reinitialization clears the statistics. */
+  memb_init(&pool_odd);
+  UNIT_TEST_ASSERT(memb_high_water(&pool_odd) == 0);
+  UNIT_TEST_ASSERT(memb_failures(&pool_odd) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_memb_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(benchmark_memb);
+  UNIT_TEST_RUN(alloc_free);
+
+  if(!UNIT_TEST_PASSED(benchmark_memb) ||
+     !UNIT_TEST_PASSED(alloc_free)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
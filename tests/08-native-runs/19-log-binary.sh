@@ -0,0 +1,12 @@
+#!/bin/bash -e
+
+./run-one.sh 19-log-binary
+
+# Decode the records with the host-side decoder, and compare the
+# messages with the expected text. Messages from the end of the flood
+# are dropped, which should be reported.
+cd 19-log-binary
+../../../tools/log-binary/decode-log.py test-log-binary.native \
+  test-log-binary.run.log > test-log-binary.decoded.log
+grep "Test " test-log-binary.decoded.log | head -7 | diff expected.log -
+grep -q "log records dropped" test-log-binary.decoded.log
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests for the binary logging backend. The decoded output is
+ *      compared with the expected text by the test script.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "Test"
+#define LOG_LEVEL LOG_LEVEL_INFO
+/*****************************************************************************/
+/* The number of messages logged at once to overflow the ring buffer. */
+#define FLOOD_MESSAGES 200
+
+/* The number of events queued behind the draining of the flood. */
+#define QUEUED_EVENTS 16
+/*****************************************************************************/
+PROCESS(test_log_binary_process, "Binary log test process");
+AUTOSTART_PROCESSES(&test_log_binary_process);
+/*****************************************************************************/
+static unsigned pending_after_events;
+/*****************************************************************************/
+UNIT_TEST_REGISTER(records, "Binary log records");
+UNIT_TEST(records)
+{
+  char name[16];
+  unsigned pending;
+  static const linkaddr_t addr = {{ 0x01, 0x02, 0x03, 0x04,
+                                    0x05, 0x06, 0x07, 0x08 }};
+
+  UNIT_TEST_BEGIN();
+
+  /* Strings are copied, so that buffers can be reused at once. */
+  strcpy(name, "stack");
+
+  pending = log_binary_pending();
+  LOG_INFO("Plain message\n");
+  UNIT_TEST_ASSERT(log_binary_pending() > pending);
+
+  LOG_INFO("Integers %d %u %x %ld %lld %hhu %zu\n",
+           -42, 42u, 0xbeefu, -100000L, 1LL << 40, (unsigned char)255,
+           sizeof(uint32_t));
+  LOG_WARN("String %s and char %c, width %5d|%-5s|\n", name, 'x', 7, "ab");
+  strcpy(name, "overwritten");
+  LOG_ERR("Star width [%*d], percent 100%%\n", 6, 12);
+  LOG_INFO("Float %.2f\n", 3.14159);
+  LOG_INFO("Address ");
+  LOG_INFO_LLADDR(&addr);
+  LOG_INFO_(" done\n");
+
+  /* Messages above the module log level are not stored. */
+  pending = log_binary_pending();
+  LOG_DBG("Debug message\n");
+  UNIT_TEST_ASSERT(log_binary_pending() == pending);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(overflow, "Binary log overflow");
+UNIT_TEST(overflow)
+{
+  UNIT_TEST_BEGIN();
+
+  uint32_t dropped = log_binary_dropped();
+  for(unsigned i = 0; i < FLOOD_MESSAGES; i++) {
+    LOG_INFO("Flood %u\n", i);
+  }
+  UNIT_TEST_ASSERT(log_binary_dropped() > dropped);
+  UNIT_TEST_ASSERT(log_binary_pending() <= LOG_BINARY_BUFFER_SIZE);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fairness, "Draining leaves room for other events");
+UNIT_TEST(fairness)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The events that were queued got through before the flood was
+     drained, a batch of records at a time */
+  UNIT_TEST_ASSERT(pending_after_events > 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_log_binary_process, ev, data)
+{
+  static unsigned i;
+
+  PROCESS_BEGIN();
+
+  /* Wait for the startup messages to be drained. */
+  while(log_binary_pending() > 0) {
+    PROCESS_PAUSE();
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(records);
+  while(log_binary_pending() > 0) {
+    PROCESS_PAUSE();
+  }
+
+  UNIT_TEST_RUN(overflow);
+  for(i = 0; i < QUEUED_EVENTS; i++) {
+    process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+  }
+  for(i = 0; i < QUEUED_EVENTS; i++) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+  }
+  pending_after_events = log_binary_pending();
+  UNIT_TEST_RUN(fairness);
+  while(log_binary_pending() > 0) {
+    PROCESS_PAUSE();
+  }
+  /* Let the drain process report the dropped records. */
+  PROCESS_PAUSE();
+
+  if(!UNIT_TEST_PASSED(records) ||
+     !UNIT_TEST_PASSED(overflow) ||
+     !UNIT_TEST_PASSED(fairness)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,6 @@
+#!/bin/bash -e
+
+# Run the test with one event timer per callback timer, and then with
+# the sorted callback timer queue.
+./run-one.sh 20-ctimer
+DEFINES=CTIMER_CONF_SORTED=1 ./run-one.sh 20-ctimer
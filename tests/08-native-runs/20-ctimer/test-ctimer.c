@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and a dispatch benchmark for the callback timers and
+ *      the deferred work queue.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "sys/ctimer.h"
+#include "sys/deferred.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of periodic timers in the benchmark. */
+#define BENCH_TIMERS        16
+
+/* The duration of the benchmark. */
+#define BENCH_DURATION      (2 * CLOCK_SECOND)
+/*****************************************************************************/
+PROCESS(test_ctimer_process, "Ctimer test process");
+AUTOSTART_PROCESSES(&test_ctimer_process);
+
+PROCESS_NAME(ctimer_process);
+/*****************************************************************************/
+static struct ctimer timers[6];
+static int fired[6];
+static int nfired;
+static int stopped_count;
+static struct deferred work;
+static int work_count;
+static struct ctimer bench_timers[BENCH_TIMERS];
+static unsigned long bench_callbacks;
+/*****************************************************************************/
+static void
+record(void *ptr)
+{
+  fired[nfired++] = (int)(uintptr_t)ptr;
+  if(nfired == 5) {
+    process_poll(&test_ctimer_process);
+  }
+}
+/*****************************************************************************/
+static void
+stop_other(void *ptr)
+{
+  ctimer_stop(ptr);
+  stopped_count++;
+}
+/*****************************************************************************/
+static void
+work_callback(void *ptr)
+{
+  work_count++;
+  if(ptr != NULL && work_count < 5) {
+    deferred_schedule(&work);
+  }
+  if(work_count == (ptr == NULL ? 1 : 5)) {
+    process_poll(&test_ctimer_process);
+  }
+}
+/*****************************************************************************/
+static void
+bench_callback(void *ptr)
+{
+  bench_callbacks++;
+  ctimer_reset(ptr);
+}
+/*****************************************************************************/
+static clock_time_t
+interval_of(int i)
+{
+  static const clock_time_t intervals[] = { 30, 10, 20, 10, 0, 15 };
+
+  return intervals[i] * CLOCK_SECOND / 1000;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(order, "Callback order");
+UNIT_TEST(order)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(nfired == 5);
+  for(i = 1; i < nfired; i++) {
+    UNIT_TEST_ASSERT(interval_of(fired[i - 1]) <= interval_of(fired[i]));
+  }
+#if CTIMER_SORTED
+  /* Timers with the same expiration time are called in order. */
+  UNIT_TEST_ASSERT(fired[1] == 1 && fired[2] == 3);
+#endif /* CTIMER_SORTED */
+  for(i = 0; i < 6; i++) {
+    UNIT_TEST_ASSERT(ctimer_expired(&timers[i]));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(stop, "Stop a due timer from a callback");
+UNIT_TEST(stop)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(stopped_count == 1);
+  UNIT_TEST_ASSERT(ctimer_expired(&timers[0]));
+  UNIT_TEST_ASSERT(ctimer_expired(&timers[1]));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(deferred, "Deferred work");
+UNIT_TEST(deferred)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(work_count == 5);
+  UNIT_TEST_ASSERT(!deferred_is_pending(&work));
+  UNIT_TEST_ASSERT(!deferred_cancel(&work));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Dispatch benchmark");
+UNIT_TEST(bench)
+{
+  unsigned long dispatches;
+
+  UNIT_TEST_BEGIN();
+
+  dispatches = ctimer_process.profile.waits;
+  printf("Sorted callback timers are %s\n",
+         CTIMER_SORTED ? "enabled" : "disabled");
+  printf("%lu callbacks/s, %lu ctimer process events/s\n",
+         bench_callbacks * CLOCK_SECOND / BENCH_DURATION,
+         dispatches * CLOCK_SECOND / BENCH_DURATION);
+
+  UNIT_TEST_ASSERT(bench_callbacks > 0);
+#if CTIMER_SORTED
+  UNIT_TEST_ASSERT(dispatches < bench_callbacks);
+#else /* CTIMER_SORTED */
+  UNIT_TEST_ASSERT(dispatches >= bench_callbacks);
+#endif /* CTIMER_SORTED */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_ctimer_process, ev, data)
+{
+  static struct etimer et;
+  static int i;
+  static bool passed;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  /* Timers 1 and 3 expire at the same time, and 5 is stopped. */
+  for(i = 0; i < 6; i++) {
+    ctimer_set(&timers[i], interval_of(i), record, (void *)(uintptr_t)i);
+  }
+  ctimer_stop(&timers[5]);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  UNIT_TEST_RUN(order);
+
+  /* Each of two due timers stops the other, so only one is called. */
+  ctimer_set(&timers[0], 0, stop_other, &timers[1]);
+  ctimer_set(&timers[1], 0, stop_other, &timers[0]);
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(stop);
+
+  /* A work item is only queued once, and can be cancelled. */
+  deferred_set(&work, work_callback, NULL);
+  passed = deferred_schedule(&work) && !deferred_schedule(&work) &&
+    deferred_is_pending(&work) && deferred_cancel(&work) &&
+    !deferred_is_pending(&work);
+  deferred_schedule(&work);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  passed = passed && work_count == 1;
+
+  /* A work item that schedules itself runs once per poll. */
+  work_count = 0;
+  deferred_set(&work, work_callback, &work);
+  deferred_schedule(&work);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  if(!passed) {
+    work_count = 0;
+  }
+  UNIT_TEST_RUN(deferred);
+
+  /* Periodic timers with a few common intervals, set at the same
+     time, as many protocol timers are. */
+  process_profile_reset();
+  for(i = 0; i < BENCH_TIMERS; i++) {
+    ctimer_set(&bench_timers[i], (i % 4 + 1) * CLOCK_SECOND / 8,
+               bench_callback, &bench_timers[i]);
+  }
+  etimer_set(&et, BENCH_DURATION);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  for(i = 0; i < BENCH_TIMERS; i++) {
+    ctimer_stop(&bench_timers[i]);
+  }
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(order) || !UNIT_TEST_PASSED(stop) ||
+     !UNIT_TEST_PASSED(deferred) || !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,6 @@
+#!/bin/bash -e
+
+# Run the test with each of the CRC16 implementations.
+for impl in 0 1 2 3; do
+  DEFINES=CRC16_CONF_IMPL=$impl ./run-one.sh 21-crc16
+done
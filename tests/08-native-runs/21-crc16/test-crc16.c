@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Cross-check and throughput benchmark of the CRC16 implementations.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of random buffers in the cross-check. */
+#define CHECK_BUFFERS     2000
+
+/* The maximum length of a random buffer. */
+#define CHECK_MAX_LENGTH   300
+
+/* The size of the benchmark buffer, and the number of passes over it. */
+#define BENCH_SIZE        4096
+#define BENCH_PASSES      2000
+/*****************************************************************************/
+PROCESS(test_crc16_process, "CRC16 test process");
+AUTOSTART_PROCESSES(&test_crc16_process);
+/*****************************************************************************/
+static unsigned char buffer[BENCH_SIZE];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+/* The original bitwise implementation. */
+static unsigned short
+reference_add(unsigned char b, unsigned short acc)
+{
+  acc ^= b;
+  acc  = (acc >> 8) | (acc << 8);
+  acc ^= (acc & 0xff00) << 4;
+  acc ^= (acc >> 8) >> 4;
+  acc ^= (acc & 0xff00) >> 5;
+  return acc;
+}
+/*****************************************************************************/
+static unsigned short
+reference_data(const unsigned char *data, int len, unsigned short acc)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    acc = reference_add(data[i], acc);
+  }
+  return acc;
+}
+/*****************************************************************************/
+static void
+fill_random(unsigned char *data, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    data[i] = rand() & 0xff;
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(known, "Known checksums");
+UNIT_TEST(known)
+{
+  UNIT_TEST_BEGIN();
+
+  /* CRC-16/KERMIT check value. */
+  UNIT_TEST_ASSERT(crc16_data((const unsigned char *)"123456789", 9, 0) ==
+                   0x2189);
+  UNIT_TEST_ASSERT(crc16_data(buffer, 0, 0x1234) == 0x1234);
+  UNIT_TEST_ASSERT(crc16_add(0x31, 0) == reference_add(0x31, 0));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(random, "Cross-check on random buffers");
+UNIT_TEST(random)
+{
+  int i, j, len, split;
+  unsigned short acc, crc;
+  unsigned mismatches;
+
+  UNIT_TEST_BEGIN();
+
+  mismatches = 0;
+  srand(1);
+  for(i = 0; i < CHECK_BUFFERS; i++) {
+    len = rand() % (CHECK_MAX_LENGTH + 1);
+    acc = rand() & 0xffff;
+    fill_random(buffer, len);
+    crc = reference_data(buffer, len, acc);
+
+    if(crc16_data(buffer, len, acc) != crc) {
+      mismatches++;
+    }
+
+    /* The same checksum in two parts. */
+    split = len > 0 ? rand() % len : 0;
+    if(crc16_data(buffer + split, len - split,
+                  crc16_data(buffer, split, acc)) != crc) {
+      mismatches++;
+    }
+
+    /* The same checksum one byte at a time. */
+    for(j = 0; j < len; j++) {
+      acc = crc16_add(buffer[j], acc);
+    }
+    if(acc != crc) {
+      mismatches++;
+    }
+  }
+
+  printf("%u mismatches in %u buffers\n", mismatches, CHECK_BUFFERS);
+  UNIT_TEST_ASSERT(mismatches == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static unsigned long
+throughput(unsigned short (*f)(const unsigned char *, int, unsigned short),
+           volatile unsigned short *result)
+{
+  uint64_t start, elapsed;
+  unsigned short acc;
+  int i;
+
+  acc = 0;
+  start = nsec_now();
+  for(i = 0; i < BENCH_PASSES; i++) {
+    acc = f(buffer, BENCH_SIZE, acc);
+  }
+  elapsed = nsec_now() - start;
+  *result = acc;
+
+  /* In MB/s, with 1 MB being 10^6 bytes. */
+  return (unsigned long)((uint64_t)BENCH_SIZE * BENCH_PASSES * 1000 /
+                         (elapsed ? elapsed : 1));
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Throughput");
+UNIT_TEST(bench)
+{
+  static const char *names[] = { "bitwise", "nibble", "table", "slice-by-4" };
+  volatile unsigned short crc, reference;
+  unsigned long mbps, reference_mbps;
+
+  UNIT_TEST_BEGIN();
+
+  fill_random(buffer, BENCH_SIZE);
+  reference_mbps = throughput(reference_data, &reference);
+  mbps = throughput(crc16_data, &crc);
+
+  printf("Implementation: %s\n", names[CRC16_IMPL]);
+  printf("crc16_data(): %lu MB/s, reference: %lu MB/s\n",
+         mbps, reference_mbps);
+
+  UNIT_TEST_ASSERT(crc == reference);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_crc16_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(known);
+  UNIT_TEST_RUN(random);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(known) || !UNIT_TEST_PASSED(random) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the bulk and region operations of ringbuf and
+ *      ringbufindex, and a benchmark of per-byte against bulk copying
+ *      at serial line rates.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/ringbuf.h"
+#include "lib/ringbufindex.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define RINGBUF_SIZE      128
+
+/* The number of seconds of traffic simulated at each rate. */
+#define BENCH_SECONDS     100
+/*****************************************************************************/
+PROCESS(test_ringbuf_process, "Ringbuf test process");
+AUTOSTART_PROCESSES(&test_ringbuf_process);
+/*****************************************************************************/
+static struct ringbuf rb;
+static uint8_t rb_data[RINGBUF_SIZE];
+static uint8_t in[1024];
+static uint8_t out[1024];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bulk, "ringbuf_put_n() and ringbuf_get_n()");
+UNIT_TEST(bulk)
+{
+  int i, n;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(in); i++) {
+    in[i] = i * 7;
+  }
+  ringbuf_init(&rb, rb_data, RINGBUF_SIZE);
+
+  /* The buffer holds one byte less than its size. */
+  UNIT_TEST_ASSERT(ringbuf_put_n(&rb, in, 200) == RINGBUF_SIZE - 1);
+  UNIT_TEST_ASSERT(ringbuf_put(&rb, 0) == 0);
+  UNIT_TEST_ASSERT(ringbuf_get_n(&rb, out, 100) == 100);
+  UNIT_TEST_ASSERT(!memcmp(in, out, 100));
+
+  /* Wrap around the end of the buffer. */
+  UNIT_TEST_ASSERT(ringbuf_put_n(&rb, in + RINGBUF_SIZE - 1, 90) == 90);
+  UNIT_TEST_ASSERT(ringbuf_elements(&rb) == RINGBUF_SIZE - 1 - 100 + 90);
+  UNIT_TEST_ASSERT(ringbuf_get(&rb) == in[100]);
+  n = ringbuf_get_n(&rb, out, sizeof(out));
+  UNIT_TEST_ASSERT(n == RINGBUF_SIZE - 1 - 101 + 90);
+  UNIT_TEST_ASSERT(!memcmp(in + 101, out, n));
+  UNIT_TEST_ASSERT(ringbuf_get_n(&rb, out, 10) == 0);
+  UNIT_TEST_ASSERT(ringbuf_get(&rb) == -1);
+
+  /* Mix with the per-byte calls at every offset. */
+  for(i = 0; i < RINGBUF_SIZE; i++) {
+    UNIT_TEST_ASSERT(ringbuf_put(&rb, 0xaa));
+    UNIT_TEST_ASSERT(ringbuf_put_n(&rb, in, 50) == 50);
+    UNIT_TEST_ASSERT(ringbuf_get(&rb) == 0xaa);
+    UNIT_TEST_ASSERT(ringbuf_get_n(&rb, out, 50) == 50);
+    UNIT_TEST_ASSERT(!memcmp(in, out, 50));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(region, "ringbuf regions");
+UNIT_TEST(region)
+{
+  uint8_t *wptr;
+  const uint8_t *rptr;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  ringbuf_init(&rb, rb_data, RINGBUF_SIZE);
+  n = ringbuf_peek_put_region(&rb, &wptr);
+  UNIT_TEST_ASSERT(n == RINGBUF_SIZE - 1 && wptr == rb_data);
+  UNIT_TEST_ASSERT(ringbuf_peek_get_region(&rb, &rptr) == 0);
+
+  /* Fill part of the region, as DMA would. */
+  memcpy(wptr, in, 100);
+  ringbuf_commit_put(&rb, 100);
+  UNIT_TEST_ASSERT(ringbuf_elements(&rb) == 100);
+  UNIT_TEST_ASSERT(ringbuf_peek_put_region(&rb, &wptr) == RINGBUF_SIZE - 101);
+
+  n = ringbuf_peek_get_region(&rb, &rptr);
+  UNIT_TEST_ASSERT(n == 100 && rptr == rb_data);
+  UNIT_TEST_ASSERT(!memcmp(rptr, in, 100));
+  ringbuf_commit_get(&rb, 60);
+
+  /* The free space now wraps: the region ends at the end of the
+     buffer, and the rest follows after the commit. */
+  n = ringbuf_peek_put_region(&rb, &wptr);
+  UNIT_TEST_ASSERT(n == RINGBUF_SIZE - 100 && wptr == rb_data + 100);
+  ringbuf_commit_put(&rb, n);
+  n = ringbuf_peek_put_region(&rb, &wptr);
+  UNIT_TEST_ASSERT(n == 59 && wptr == rb_data);
+
+  n = ringbuf_peek_get_region(&rb, &rptr);
+  UNIT_TEST_ASSERT(n == RINGBUF_SIZE - 60 && rptr == rb_data + 60);
+
+  /* Lengths beyond the regions are rejected and change nothing. */
+  UNIT_TEST_ASSERT(!ringbuf_commit_put(&rb, 60));
+  UNIT_TEST_ASSERT(!ringbuf_commit_put(&rb, -1));
+  UNIT_TEST_ASSERT(!ringbuf_commit_get(&rb, n + 1));
+  UNIT_TEST_ASSERT(!ringbuf_commit_get(&rb, -1));
+  UNIT_TEST_ASSERT(ringbuf_elements(&rb) == RINGBUF_SIZE - 60);
+  UNIT_TEST_ASSERT(ringbuf_commit_get(&rb, n));
+  UNIT_TEST_ASSERT(ringbuf_elements(&rb) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(index_region, "ringbufindex regions");
+UNIT_TEST(index_region)
+{
+  struct ringbufindex ri;
+  int first, n;
+
+  UNIT_TEST_BEGIN();
+
+  ringbufindex_init(&ri, 16);
+  UNIT_TEST_ASSERT(ringbufindex_peek_get_region(&ri, &n) == -1 && n == 0);
+  first = ringbufindex_peek_put_region(&ri, &n);
+  UNIT_TEST_ASSERT(first == 0 && n == 15);
+  UNIT_TEST_ASSERT(ringbufindex_commit_put(&ri, 16) == 0);
+  UNIT_TEST_ASSERT(ringbufindex_commit_put(&ri, 12) == 1);
+  UNIT_TEST_ASSERT(ringbufindex_elements(&ri) == 12);
+
+  first = ringbufindex_peek_get_region(&ri, &n);
+  UNIT_TEST_ASSERT(first == 0 && n == 12);
+  UNIT_TEST_ASSERT(ringbufindex_commit_get(&ri, 13) == 0);
+  UNIT_TEST_ASSERT(ringbufindex_commit_get(&ri, 10) == 1);
+  UNIT_TEST_ASSERT(ringbufindex_peek_get(&ri) == 10);
+
+  /* Wrap around the end. */
+  first = ringbufindex_peek_put_region(&ri, &n);
+  UNIT_TEST_ASSERT(first == 12 && n == 4);
+  UNIT_TEST_ASSERT(ringbufindex_commit_put(&ri, 4) == 1);
+  first = ringbufindex_peek_put_region(&ri, &n);
+  UNIT_TEST_ASSERT(first == 0 && n == 9);
+  UNIT_TEST_ASSERT(ringbufindex_put(&ri) == 1);
+  first = ringbufindex_peek_get_region(&ri, &n);
+  UNIT_TEST_ASSERT(first == 10 && n == 6);
+  UNIT_TEST_ASSERT(ringbufindex_elements(&ri) == 7);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+/*
+ * Simulate a serial line at the given rate, with the bytes arriving in
+ * bursts once per millisecond, as from a UART FIFO or a DMA transfer,
+ * and being drained after each burst. Returns the CPU time in
+ * nanoseconds that each second of traffic takes.
+ */
+static uint64_t
+feed(unsigned long baud, int bulk)
+{
+  unsigned long bytes_per_ms;
+  uint64_t start;
+  unsigned s, ms;
+  int i, c, n;
+  volatile uint8_t sink;
+
+  /* 10 bits per byte on the line. */
+  bytes_per_ms = (baud / 10 + 999) / 1000;
+  ringbuf_init(&rb, rb_data, RINGBUF_SIZE);
+
+  start = nsec_now();
+  for(s = 0; s < BENCH_SECONDS; s++) {
+    for(ms = 0; ms < 1000; ms++) {
+      if(bulk) {
+        ringbuf_put_n(&rb, in, bytes_per_ms);
+        n = ringbuf_get_n(&rb, out, sizeof(out));
+      } else {
+        for(i = 0; i < bytes_per_ms; i++) {
+          ringbuf_put(&rb, in[i]);
+        }
+        for(n = 0; (c = ringbuf_get(&rb)) != -1; n++) {
+          out[n] = c;
+        }
+      }
+      sink = out[n - 1];
+    }
+  }
+  (void)sink;
+  return (nsec_now() - start) / BENCH_SECONDS;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Per-byte and bulk copying");
+UNIT_TEST(bench)
+{
+  static const unsigned long rates[] = { 115200, 1000000 };
+  uint64_t per_byte, bulk;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 2; i++) {
+    per_byte = feed(rates[i], 0);
+    bulk = feed(rates[i], 1);
+    printf("%lu baud: per-byte %lu us/s, bulk %lu us/s of CPU time\n",
+           rates[i], (unsigned long)(per_byte / 1000),
+           (unsigned long)(bulk / 1000));
+    UNIT_TEST_ASSERT(per_byte > 0 && bulk > 0);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_ringbuf_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(bulk);
+  UNIT_TEST_RUN(region);
+  UNIT_TEST_RUN(index_region);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(bulk) || !UNIT_TEST_PASSED(region) ||
+     !UNIT_TEST_PASSED(index_region) || !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the streaming JSON parser, a fuzzer that checks
+ *      that chunking does not change the result, and a benchmark
+ *      against jsonparse.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "jsonparse.h"
+#include "jsonsax.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define LOG_SIZE          4096
+#define FUZZ_ROUNDS       20000
+#define BENCH_DOC_SIZE    8192
+#define BENCH_ROUNDS      2000
+/* A typical CoAP block size */
+#define BENCH_BLOCK_SIZE  64
+/*****************************************************************************/
+PROCESS(test_jsonsax_process, "JSON SAX test process");
+AUTOSTART_PROCESSES(&test_jsonsax_process);
+/*****************************************************************************/
+/* An LwM2M JSON payload using every token type */
+static const char sample[] =
+  "{\"bn\":\"/3/0/\",\"e\":[\n"
+  "  {\"n\":\"0\",\"sv\":\"Contiki-NG \\\"native\\\"\"},\n"
+  "  {\"n\":\"9\",\"v\":87},\n"
+  "  {\"n\":\"10\",\"v\":-15.25},\n"
+  "  {\"n\":\"13\",\"bv\":true},\n"
+  "  {\"n\":\"14\",\"bv\":false},\n"
+  "  {\"n\":\"15\",\"sv\":null},\n"
+  "  {\"n\":\"6/0\",\"v\":[1, 2, [], {}]},\n"
+  "  {\"n\":\"\\u00e9\\\\path\",\"sv\":\"\"}\n"
+  "]}";
+
+struct log {
+  char buf[LOG_SIZE];
+  int len;
+  /* the last string token was partial */
+  bool continued;
+};
+
+static struct log log_a;
+static struct log log_b;
+static char doc[BENCH_DOC_SIZE + 1];
+static int doc_len;
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+log_append(struct log *log, const char *s, int len)
+{
+  if(log->len + len < LOG_SIZE) {
+    memcpy(&log->buf[log->len], s, len);
+    log->len += len;
+  }
+}
+/*****************************************************************************/
+static void
+log_token(struct log *log, int type, const char *value, int len, bool last)
+{
+  char c = type;
+
+  log_append(log, &c, 1);
+  if(value != NULL) {
+    log_append(log, value, len);
+  }
+  if(last) {
+    log_append(log, "|", 1);
+  }
+}
+/*****************************************************************************/
+/* Records tokens; string fragments are joined so chunking does not show */
+static int
+log_callback(struct jsonsax_state *state, int type, const char *value,
+             int len)
+{
+  struct log *log = state->user_data;
+  bool string = type == JSON_TYPE_STRING || type == JSON_TYPE_PAIR_NAME;
+
+  if(log->continued) {
+    log_append(log, value, len);
+  } else {
+    log_token(log, type, value, len, false);
+  }
+  log->continued = string && jsonsax_is_partial(state);
+  if(!log->continued) {
+    log_append(log, "|", 1);
+  }
+  return 0;
+}
+/*****************************************************************************/
+/* Parse in chunks of the given size (0 for a random size every time) */
+static int
+parse(struct jsonsax_state *state, struct log *log, const char *json,
+      int len, int chunk)
+{
+  int pos, n, r = JSONSAX_MORE;
+
+  log->len = 0;
+  log->continued = false;
+  jsonsax_init(state, log_callback, log);
+  for(pos = 0; pos < len && (r == JSONSAX_MORE || r == JSONSAX_DONE);
+      pos += n) {
+    n = chunk ? chunk : 1 + random_rand() % 32;
+    if(n > len - pos) {
+      n = len - pos;
+    }
+    r = jsonsax_feed(state, &json[pos], n);
+  }
+  if(r == JSONSAX_MORE || r == JSONSAX_DONE) {
+    r = jsonsax_finish(state);
+  }
+  return r;
+}
+/*****************************************************************************/
+/* The same token log, produced by jsonparse */
+static int
+parse_reference(struct log *log, const char *json, int len)
+{
+  struct jsonparse_state js;
+  int type;
+
+  log->len = 0;
+  jsonparse_setup(&js, json, len);
+  while((type = jsonparse_next(&js)) != JSON_TYPE_ERROR) {
+    if(type == ',') {
+      continue;
+    }
+    if(type == '{' || type == '[' || type == '}' || type == ']') {
+      log_token(log, type, NULL, 0, true);
+    } else {
+      log_token(log, type, &json[js.vstart], js.vlen, true);
+    }
+  }
+  return js.error;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(tokens, "Tokens match jsonparse in any chunking");
+UNIT_TEST(tokens)
+{
+  struct jsonsax_state state;
+  int len = strlen(sample);
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(parse_reference(&log_b, sample, len) == JSON_ERROR_OK);
+  UNIT_TEST_ASSERT(parse(&state, &log_a, sample, len, len) == JSONSAX_DONE);
+  UNIT_TEST_ASSERT(log_a.len == log_b.len);
+  UNIT_TEST_ASSERT(memcmp(log_a.buf, log_b.buf, log_a.len) == 0);
+  UNIT_TEST_ASSERT(jsonsax_get_depth(&state) == 0);
+  UNIT_TEST_ASSERT(state.offset == len);
+
+  for(i = 1; i <= len; i++) {
+    UNIT_TEST_ASSERT(parse(&state, &log_a, sample, len, i) == JSONSAX_DONE);
+    UNIT_TEST_ASSERT(log_a.len == log_b.len);
+    UNIT_TEST_ASSERT(memcmp(log_a.buf, log_b.buf, log_a.len) == 0);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(errors, "Rejects malformed documents");
+UNIT_TEST(errors)
+{
+  static const char *const bad[] = {
+    "{\"a\" 1}", "[1,]", "{\"a\":1,}", "[1 2]", "tru", "truex", "{\"a\":01}",
+    "\"\\x\"", "\"\\u12g4\"", "[}", "{]", "{} x", "\"a\nb\"", "-", "1.",
+    "1e", "{1:2}", "[[[[[[[[[[[1]]]]]]]]]]]", "", "{\"a\":1"
+  };
+  static const char *const good[] = {
+    "42", " -0.5e+3 ", "\"\"", "[]", "{}", "null", "[[[[[[[[[[]]]]]]]]]]",
+    "\t{ \"a\" : [ true , false ] }\r\n"
+  };
+  struct jsonsax_state state;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    UNIT_TEST_ASSERT(parse(&state, &log_a, bad[i], strlen(bad[i]), 1)
+                     == JSONSAX_ERROR);
+    UNIT_TEST_ASSERT(jsonsax_get_error(&state) != JSON_ERROR_OK);
+  }
+  for(i = 0; i < sizeof(good) / sizeof(good[0]); i++) {
+    UNIT_TEST_ASSERT(parse(&state, &log_a, good[i], strlen(good[i]), 1)
+                     == JSONSAX_DONE);
+  }
+
+  /* The error offset points at the offending character */
+  parse(&state, &log_a, "[1, 2 3]", 8, 8);
+  UNIT_TEST_ASSERT(state.offset == 6);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static int
+stop_at_sv(struct jsonsax_state *state, int type, const char *value, int len)
+{
+  int *count = state->user_data;
+
+  (*count)++;
+  return type == JSON_TYPE_PAIR_NAME && len == 2 && memcmp(value, "sv", 2) == 0;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(stop, "Callback stops the parser");
+UNIT_TEST(stop)
+{
+  struct jsonsax_state state;
+  int count = 0;
+
+  UNIT_TEST_BEGIN();
+
+  jsonsax_init(&state, stop_at_sv, &count);
+  UNIT_TEST_ASSERT(jsonsax_feed(&state, sample, strlen(sample))
+                   == JSONSAX_STOPPED);
+  /* {, bn, /3/0/, e, [, {, n, 0, sv */
+  UNIT_TEST_ASSERT(count == 9);
+  UNIT_TEST_ASSERT(jsonsax_feed(&state, "]}", 2) == JSONSAX_STOPPED);
+  UNIT_TEST_ASSERT(count == 9);
+  UNIT_TEST_ASSERT(jsonsax_finish(&state) == JSONSAX_STOPPED);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(unescape, "jsonsax_unescape()");
+UNIT_TEST(unescape)
+{
+  static const char raw[] = "a\\\"b\\\\c\\/\\n\\u00e9\\u20ac\\ud83d\\ude00";
+  static const char expected[] = "a\"b\\c/\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+  char out[32];
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  n = jsonsax_unescape(out, sizeof(out), raw, strlen(raw));
+  UNIT_TEST_ASSERT(n == strlen(expected));
+  UNIT_TEST_ASSERT(strcmp(out, expected) == 0);
+
+  /* Truncation never splits a UTF-8 sequence */
+  n = jsonsax_unescape(out, 10, raw, strlen(raw));
+  UNIT_TEST_ASSERT(n == 9);
+  UNIT_TEST_ASSERT(memcmp(out, expected, 9) == 0 && out[9] == '\0');
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fuzz, "Mutated documents parse the same in any chunking");
+UNIT_TEST(fuzz)
+{
+  static const char alphabet[] = "{}[]:,\"\\-.0123456789eEtrufalsn \n";
+  static char mutant[sizeof(sample) + 8];
+  struct jsonsax_state whole, chunked;
+  int round, i, len, r1, r2;
+  int accepted = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(round = 0; round < FUZZ_ROUNDS; round++) {
+    len = strlen(sample);
+    memcpy(mutant, sample, len);
+    for(i = 1 + random_rand() % 3; i > 0 && len > 1; i--) {
+      int pos = random_rand() % len;
+      switch(random_rand() % 4) {
+      case 0:
+        mutant[pos] = alphabet[random_rand() % (sizeof(alphabet) - 1)];
+        break;
+      case 1:
+        memmove(&mutant[pos], &mutant[pos + 1], len - pos - 1);
+        len--;
+        break;
+      case 2:
+        if(len < sizeof(mutant) - 1) {
+          memmove(&mutant[pos + 1], &mutant[pos], len - pos);
+          mutant[pos] = alphabet[random_rand() % (sizeof(alphabet) - 1)];
+          len++;
+        }
+        break;
+      default:
+        len = pos + 1;
+        break;
+      }
+    }
+
+    r1 = parse(&whole, &log_a, mutant, len, len);
+    r2 = parse(&chunked, &log_b, mutant, len, 0);
+    UNIT_TEST_ASSERT(r1 == r2);
+    UNIT_TEST_ASSERT(r1 == JSONSAX_DONE || r1 == JSONSAX_ERROR);
+    if(r1 == JSONSAX_DONE) {
+      accepted++;
+      UNIT_TEST_ASSERT(log_a.len == log_b.len);
+      UNIT_TEST_ASSERT(memcmp(log_a.buf, log_b.buf, log_a.len) == 0);
+    } else {
+      UNIT_TEST_ASSERT(whole.offset == chunked.offset);
+      UNIT_TEST_ASSERT(whole.error == chunked.error);
+    }
+  }
+  printf("fuzz: %d of %d mutants accepted\n", accepted, FUZZ_ROUNDS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static int
+count_callback(struct jsonsax_state *state, int type, const char *value,
+               int len)
+{
+  (*(int *)state->user_data)++;
+  return 0;
+}
+/*****************************************************************************/
+static void
+build_doc(void)
+{
+  int i;
+
+  doc_len = snprintf(doc, sizeof(doc), "{\"bn\":\"/3303/\",\"e\":[");
+  for(i = 0; doc_len < BENCH_DOC_SIZE - 64; i++) {
+    doc_len += snprintf(&doc[doc_len], sizeof(doc) - doc_len,
+                        "%s{\"n\":\"%d/5700\",\"v\":%d.%d,\"sv\":\"sensor %d\"}",
+                        i ? "," : "", i, 20 + i % 10, i % 100, i);
+  }
+  doc_len += snprintf(&doc[doc_len], sizeof(doc) - doc_len, "]}");
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Throughput against jsonparse");
+UNIT_TEST(bench)
+{
+  struct jsonparse_state js;
+  struct jsonsax_state state;
+  char value[32];
+  uint64_t start, t_ref, t_whole, t_block;
+  int i, pos, n, type, ref_tokens = 0, sax_tokens = 0;
+
+  UNIT_TEST_BEGIN();
+
+  build_doc();
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    ref_tokens = 0;
+    jsonparse_setup(&js, doc, doc_len);
+    while((type = jsonparse_next(&js)) != JSON_TYPE_ERROR) {
+      if(type == JSON_TYPE_STRING || type == JSON_TYPE_PAIR_NAME) {
+        jsonparse_copy_value(&js, value, sizeof(value));
+      }
+      ref_tokens += type != ',';
+    }
+  }
+  t_ref = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    sax_tokens = 0;
+    jsonsax_init(&state, count_callback, &sax_tokens);
+    UNIT_TEST_ASSERT(jsonsax_feed(&state, doc, doc_len) == JSONSAX_DONE);
+  }
+  t_whole = nsec_now() - start;
+  UNIT_TEST_ASSERT(sax_tokens == ref_tokens);
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    jsonsax_init(&state, count_callback, &sax_tokens);
+    for(pos = 0; pos < doc_len; pos += n) {
+      n = doc_len - pos < BENCH_BLOCK_SIZE ? doc_len - pos : BENCH_BLOCK_SIZE;
+      jsonsax_feed(&state, &doc[pos], n);
+    }
+    UNIT_TEST_ASSERT(jsonsax_finish(&state) == JSONSAX_DONE);
+  }
+  t_block = nsec_now() - start;
+
+  printf("%d byte document, %d tokens\n", doc_len, ref_tokens);
+  printf("jsonparse:          %lu MB/s, %u bytes of state + document\n",
+         (unsigned long)((uint64_t)doc_len * BENCH_ROUNDS * 1000 / t_ref),
+         (unsigned)(sizeof(js) + doc_len));
+  printf("jsonsax whole:      %lu MB/s\n",
+         (unsigned long)((uint64_t)doc_len * BENCH_ROUNDS * 1000 / t_whole));
+  printf("jsonsax %d B blocks: %lu MB/s, %u bytes of state + block\n",
+         BENCH_BLOCK_SIZE,
+         (unsigned long)((uint64_t)doc_len * BENCH_ROUNDS * 1000 / t_block),
+         (unsigned)(sizeof(state) + BENCH_BLOCK_SIZE));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_jsonsax_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(tokens);
+  UNIT_TEST_RUN(errors);
+  UNIT_TEST_RUN(stop);
+  UNIT_TEST_RUN(unescape);
+  UNIT_TEST_RUN(fuzz);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(tokens) || !UNIT_TEST_PASSED(errors) ||
+     !UNIT_TEST_PASSED(stop) || !UNIT_TEST_PASSED(unescape) ||
+     !UNIT_TEST_PASSED(fuzz) || !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
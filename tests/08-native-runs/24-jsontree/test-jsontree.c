@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for buffered, resumable jsontree output, and a
+ *      benchmark against putchar output.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "jsontree.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define OUT_SIZE          1024
+#define BENCH_ROUNDS      20000
+/*****************************************************************************/
+PROCESS(test_jsontree_process, "JSON tree test process");
+AUTOSTART_PROCESSES(&test_jsontree_process);
+/*****************************************************************************/
+static char reference[OUT_SIZE];
+static int reference_len;
+static char out[OUT_SIZE];
+static int out_len;
+static int out_pos;
+static int window_start;
+static int history_calls;
+
+static int16_t temperature = -1250;
+static uint32_t uptime = 4000000000UL;
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static int
+out_putchar(int c)
+{
+  if(out_len < OUT_SIZE) {
+    out[out_len++] = c;
+  }
+  return c;
+}
+/*****************************************************************************/
+/* Keeps only the bytes in [window_start, window_start + OUT_SIZE) */
+static int
+window_putchar(int c)
+{
+  if(out_pos >= window_start && out_pos - window_start < OUT_SIZE) {
+    out[out_pos - window_start] = c;
+  }
+  out_pos++;
+  return c;
+}
+/*****************************************************************************/
+/* Writes three entries, one per call, to exercise callback_state */
+static int
+history_output(struct jsontree_context *js_ctx)
+{
+  static const int samples[] = { 21, -3, 2147483647 };
+
+  history_calls++;
+  jsontree_write_atom(js_ctx, js_ctx->callback_state == 0 ? "[" : ",");
+  jsontree_write_int(js_ctx, samples[js_ctx->callback_state]);
+  if(++js_ctx->callback_state == 3) {
+    jsontree_write_atom(js_ctx, "]");
+    return 0;
+  }
+  return 1;
+}
+/*****************************************************************************/
+static struct jsontree_string name = JSONTREE_STRING("Contiki-NG \"native\"");
+static struct jsontree_string unit = JSONTREE_STRING("Cel");
+static struct jsontree_int min_value = { JSON_TYPE_INT, -2147483647 - 1 };
+static struct jsontree_ptr temperature_ptr = { JSON_TYPE_S16PTR, &temperature };
+static struct jsontree_ptr uptime_ptr = { JSON_TYPE_U32PTR, &uptime };
+static struct jsontree_callback history = JSONTREE_CALLBACK(history_output, NULL);
+
+JSONTREE_OBJECT(sensor,
+                JSONTREE_PAIR("n", &unit),
+                JSONTREE_PAIR("v", &temperature_ptr),
+                JSONTREE_PAIR("min", &min_value),
+                JSONTREE_PAIR("history", &history));
+JSONTREE_ARRAY(sensors, 3);
+JSONTREE_OBJECT(device,
+                JSONTREE_PAIR("name", &name),
+                JSONTREE_PAIR("uptime", &uptime_ptr),
+                JSONTREE_PAIR("sensors", &sensors));
+/*****************************************************************************/
+static int
+print_all(struct jsontree_context *js_ctx)
+{
+  out_len = 0;
+  jsontree_setup(js_ctx, (struct jsontree_value *)&device, out_putchar);
+  while(jsontree_print_next(js_ctx));
+  return out_len;
+}
+/*****************************************************************************/
+static int
+print_blocks(struct jsontree_context *js_ctx, int block_size)
+{
+  int n;
+
+  out_len = 0;
+  jsontree_setup_buffer(js_ctx, (struct jsontree_value *)&device);
+  while(!jsontree_print_done(js_ctx)) {
+    n = jsontree_print_buffer(js_ctx, &out[out_len], block_size);
+    if(n == 0 && !jsontree_print_done(js_ctx)) {
+      return -1;
+    }
+    out_len += n;
+  }
+  return out_len;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(blocks, "Buffered output in blocks of any size");
+UNIT_TEST(blocks)
+{
+  struct jsontree_context js_ctx;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  jsontree_valuesensors[0] = jsontree_valuesensors[1] = jsontree_valuesensors[2] =
+    (struct jsontree_value *)&sensor;
+
+  reference_len = print_all(&js_ctx);
+  memcpy(reference, out, reference_len);
+  reference[reference_len] = '\0';
+  printf("%s\n", reference);
+  UNIT_TEST_ASSERT(strstr(reference, "\"Contiki-NG \\\"native\\\"\"") != NULL);
+  UNIT_TEST_ASSERT(strstr(reference, "\"v\":-1250,\"min\":-2147483648,") != NULL);
+  UNIT_TEST_ASSERT(strstr(reference, "\"uptime\":4000000000,") != NULL);
+  UNIT_TEST_ASSERT(strstr(reference, "\"history\":[21,-3,2147483647]}") != NULL);
+
+  for(i = 1; i <= reference_len + 1; i++) {
+    history_calls = 0;
+    UNIT_TEST_ASSERT(print_blocks(&js_ctx, i) == reference_len);
+    UNIT_TEST_ASSERT(memcmp(out, reference, reference_len) == 0);
+    /* Each history entry fits in the carry, so none is produced twice */
+    UNIT_TEST_ASSERT(history_calls == 3 * 3);
+  }
+
+  /* Nothing more is written once the tree is done */
+  UNIT_TEST_ASSERT(jsontree_print_buffer(&js_ctx, out, 16) == 0);
+
+  /* Sizes outside the range of the output state are clamped */
+  jsontree_setup_buffer(&js_ctx, (struct jsontree_value *)&device);
+  UNIT_TEST_ASSERT(jsontree_print_buffer(&js_ctx, out, -1) == 0);
+  UNIT_TEST_ASSERT(jsontree_print_buffer(&js_ctx, out, 0x10000) == reference_len);
+  UNIT_TEST_ASSERT(jsontree_print_done(&js_ctx));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Buffered output against putchar");
+UNIT_TEST(bench)
+{
+  struct jsontree_context js_ctx;
+  uint64_t start, t_putchar, t_buffer, t_blocks, t_restart;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    print_all(&js_ctx);
+  }
+  t_putchar = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    jsontree_setup_buffer(&js_ctx, (struct jsontree_value *)&device);
+    UNIT_TEST_ASSERT(jsontree_print_buffer(&js_ctx, out, OUT_SIZE)
+                     == reference_len);
+  }
+  t_buffer = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    /* CoAP Block2 with 64-byte blocks */
+    UNIT_TEST_ASSERT(print_blocks(&js_ctx, 64) == reference_len);
+  }
+  t_blocks = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    /* The same blocks, serializing from the start for each of them */
+    for(window_start = 0; window_start < reference_len; window_start += 64) {
+      out_pos = 0;
+      jsontree_setup(&js_ctx, (struct jsontree_value *)&device,
+                     window_putchar);
+      while(jsontree_print_next(&js_ctx) && out_pos < window_start + 64);
+    }
+  }
+  t_restart = nsec_now() - start;
+
+  printf("%d byte document, ns per document:\n", reference_len);
+  printf("  putchar %lu, buffer %lu\n",
+         (unsigned long)(t_putchar / BENCH_ROUNDS),
+         (unsigned long)(t_buffer / BENCH_ROUNDS));
+  printf("  64 B blocks: resumed %lu, restarted %lu\n",
+         (unsigned long)(t_blocks / BENCH_ROUNDS),
+         (unsigned long)(t_restart / BENCH_ROUNDS));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_jsontree_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(blocks);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(blocks) || !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
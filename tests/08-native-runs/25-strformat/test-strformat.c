@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the strformat backend and the address formatting
+ *      used by the log module, and a benchmark of the cost of a
+ *      typical log line.
+ */
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "net/ipv6/uiplib.h"
+#include "net/linkaddr.h"
+#include "strformat.h"
+#include "unit-test/unit-test.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "Test"
+#define LOG_LEVEL LOG_LEVEL_INFO
+/*****************************************************************************/
+#define OUT_SIZE          256
+#define BENCH_ROUNDS      100000
+/*****************************************************************************/
+PROCESS(test_strformat_process, "Strformat test process");
+AUTOSTART_PROCESSES(&test_strformat_process);
+/*****************************************************************************/
+static char out[OUT_SIZE];
+static unsigned int out_len;
+static unsigned int write_calls;
+static int fail_writes;
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static uint64_t
+cycles_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+/*****************************************************************************/
+static strformat_result
+write_out(void *user_data, const char *data, unsigned int len)
+{
+  write_calls++;
+  if(fail_writes) {
+    return STRFORMAT_FAILED;
+  }
+  if(len > OUT_SIZE - 1 - out_len) {
+    len = OUT_SIZE - 1 - out_len;
+  }
+  memcpy(out + out_len, data, len);
+  out_len += len;
+  out[out_len] = '\0';
+  return STRFORMAT_OK;
+}
+/*****************************************************************************/
+static const strformat_context_t out_ctxt = { write_out, NULL };
+/*****************************************************************************/
+int
+test_log_output(const char *format, ...)
+{
+  va_list ap;
+  int res;
+
+  va_start(ap, format);
+  res = format_str_v(&out_ctxt, format, ap);
+  va_end(ap);
+  return res;
+}
+/*****************************************************************************/
+static void
+reset_out(void)
+{
+  out_len = 0;
+  out[0] = '\0';
+  write_calls = 0;
+}
+/*****************************************************************************/
+/* Formats with both strformat and libc, and returns non-zero if they match. */
+static int
+same_as_libc(const char *format, ...)
+{
+  char expected[OUT_SIZE];
+  va_list ap;
+  int res;
+  int expected_res;
+
+  reset_out();
+  va_start(ap, format);
+  res = format_str_v(&out_ctxt, format, ap);
+  va_end(ap);
+
+  va_start(ap, format);
+  expected_res = vsnprintf(expected, sizeof(expected), format, ap);
+  va_end(ap);
+
+  if(res != expected_res || strcmp(out, expected) != 0) {
+    printf("\"%s\": got \"%s\" (%d), expected \"%s\" (%d)\n",
+           format, out, res, expected, expected_res);
+    return 0;
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(integers, "Integer conversions against libc");
+UNIT_TEST(integers)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(same_as_libc("%d %i %u", 0, -1, 4000000000U));
+  UNIT_TEST_ASSERT(same_as_libc("%d %d", INT_MIN, INT_MAX));
+  UNIT_TEST_ASSERT(same_as_libc("%ld %lu", LONG_MIN, ULONG_MAX));
+  UNIT_TEST_ASSERT(same_as_libc("%lld %llu", LLONG_MIN, ULLONG_MAX));
+  UNIT_TEST_ASSERT(same_as_libc("%zu", (size_t)123456789));
+  UNIT_TEST_ASSERT(same_as_libc("%hd %hhu", (short)-1234, 300));
+  UNIT_TEST_ASSERT(same_as_libc("[%5d] [%-5d] [%05d]", 42, 42, -42));
+  UNIT_TEST_ASSERT(same_as_libc("[%+d] [% d] [%+d]", 7, 7, -7));
+  UNIT_TEST_ASSERT(same_as_libc("[%.3d] [%8.3d] [%-8.3d]", 5, -5, 5));
+  UNIT_TEST_ASSERT(same_as_libc("[%.0d] [%3.0u]", 0, 0U));
+  UNIT_TEST_ASSERT(same_as_libc("%x %X %o", 0xdeadbeefU, 0xabcdefU, 0755U));
+  UNIT_TEST_ASSERT(same_as_libc("%#x %#X %#o", 0x1fU, 0x1fU, 8U));
+  UNIT_TEST_ASSERT(same_as_libc("%02x%02x %04X", 0xaU, 0xbU, 0x12U));
+  UNIT_TEST_ASSERT(same_as_libc("%llx %llo", 0x123456789abcdef0ULL,
+                                0x7fffffffffffffffULL));
+  UNIT_TEST_ASSERT(same_as_libc("%lx", ULONG_MAX));
+  UNIT_TEST_ASSERT(same_as_libc("%u%u%u%u", 1U, 22U, 333U, 4444U));
+  UNIT_TEST_ASSERT(same_as_libc("%lu", 1000000000000ULL));
+  UNIT_TEST_ASSERT(same_as_libc("%llu %llu", 9999999999ULL, 10000000000ULL));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(strings, "Characters and strings against libc");
+UNIT_TEST(strings)
+{
+  static const char unterminated[4] = { 'a', 'b', 'c', 'd' };
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(same_as_libc(""));
+  UNIT_TEST_ASSERT(same_as_libc("plain text"));
+  UNIT_TEST_ASSERT(same_as_libc("%c%c%c", 'a', 'b', 'c'));
+  UNIT_TEST_ASSERT(same_as_libc("[%3c] [%-3c]", 'x', 'y'));
+  UNIT_TEST_ASSERT(same_as_libc("[%s] [%10s] [%-10s]", "abc", "def", "ghi"));
+  UNIT_TEST_ASSERT(same_as_libc("[%.2s] [%5.1s]", "abc", "def"));
+  UNIT_TEST_ASSERT(same_as_libc("[%.4s]", unterminated));
+  UNIT_TEST_ASSERT(same_as_libc("100%% %s", "done"));
+  UNIT_TEST_ASSERT(same_as_libc("[%-4s: %-10s] ", "INFO", "Test"));
+  /* Longer than the output buffer */
+  UNIT_TEST_ASSERT(same_as_libc("%s|%80s|%s",
+                                "0123456789012345678901234567890123456789",
+                                "x", "end"));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(writes, "Buffered writes and write failures");
+UNIT_TEST(writes)
+{
+  UNIT_TEST_BEGIN();
+
+  reset_out();
+  UNIT_TEST_ASSERT(format_str(&out_ctxt, "seq %u rssi %d\n", 17U, -72) == 16);
+  UNIT_TEST_ASSERT(strcmp(out, "seq 17 rssi -72\n") == 0);
+#if !defined(STRFORMAT_CONF_BUFFER_SIZE) || STRFORMAT_CONF_BUFFER_SIZE > 0
+  /* A short line is handed over in one piece. */
+  UNIT_TEST_ASSERT(write_calls == 1);
+
+  /* Nothing is handed over for empty output. */
+  reset_out();
+  UNIT_TEST_ASSERT(format_str(&out_ctxt, "%s", "") == 0);
+  UNIT_TEST_ASSERT(write_calls == 0);
+#endif
+
+  fail_writes = 1;
+  reset_out();
+  UNIT_TEST_ASSERT(format_str(&out_ctxt, "seq %u\n", 17U) == -1);
+  reset_out();
+  UNIT_TEST_ASSERT(format_str(&out_ctxt, "%80s", "x") == -1);
+  fail_writes = 0;
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static int
+ipaddr_is(const uip_ipaddr_t *addr, const char *expected)
+{
+  char buf[UIPLIB_IPV6_MAX_STR_LEN];
+  int len;
+
+  len = uiplib_ipaddr_snprint(buf, sizeof(buf), addr);
+  if(len != strlen(expected) || strcmp(buf, expected) != 0) {
+    printf("got \"%s\" (%d), expected \"%s\"\n", buf, len, expected);
+    return 0;
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(addresses, "IPv6 and link-layer address formatting");
+UNIT_TEST(addresses)
+{
+  uip_ipaddr_t addr;
+  linkaddr_t lladdr;
+  char small[8];
+
+  UNIT_TEST_BEGIN();
+
+  uip_create_unspecified(&addr);
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "::"));
+  uip_ip6addr(&addr, 0, 0, 0, 0, 0, 0, 0, 1);
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "::1"));
+  uip_ip6addr(&addr, 0xfe80, 0, 0, 0, 0x212, 0x7401, 1, 0x101);
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "fe80::212:7401:1:101"));
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 1, 0, 0, 0, 0);
+  /* The first run of zeros is the one compressed. */
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "fd00::1:0:0:0:0"));
+  uip_ip6addr(&addr, 0x2001, 0xdb8, 0, 1, 0, 0, 0xabcd, 0xffff);
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "2001:db8::1:0:0:abcd:ffff"));
+  uip_ip6addr(&addr, 1, 2, 3, 4, 5, 6, 7, 8);
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "1:2:3:4:5:6:7:8"));
+  uip_ip6addr(&addr, 0, 0, 0, 0, 0, 0xffff, 0x0102, 0x03ff);
+  UNIT_TEST_ASSERT(ipaddr_is(&addr, "::FFFF:1.2.3.255"));
+
+  /* Truncated output is terminated and reports the full length. */
+  uip_ip6addr(&addr, 0xfe80, 0, 0, 0, 0x212, 0x7401, 1, 0x101);
+  UNIT_TEST_ASSERT(uiplib_ipaddr_snprint(small, sizeof(small), &addr) == 20);
+  UNIT_TEST_ASSERT(strcmp(small, "fe80::2") == 0);
+  UNIT_TEST_ASSERT(uiplib_ipaddr_snprint(small, 0, &addr) == 0);
+  UNIT_TEST_ASSERT(uiplib_ipaddr_snprint(small, sizeof(small), NULL) == 14);
+  UNIT_TEST_ASSERT(strcmp(small, "(NULL I") == 0);
+
+  /* The same line through the log macros */
+  memset(&lladdr, 0, sizeof(lladdr));
+  lladdr.u8[0] = 0x00;
+  lladdr.u8[LINKADDR_SIZE - 1] = 0xab;
+  reset_out();
+  LOG_INFO_("to ");
+  LOG_INFO_6ADDR(&addr);
+  LOG_INFO_(" via ");
+  LOG_INFO_LLADDR(&lladdr);
+#if LINKADDR_SIZE == 8
+  UNIT_TEST_ASSERT(strcmp(out, "to fe80::212:7401:1:101 via "
+                          "0000.0000.0000.00ab") == 0);
+#endif
+  reset_out();
+  LOG_INFO_LLADDR(NULL);
+  UNIT_TEST_ASSERT(strcmp(out, "(NULL LL addr)") == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Cost of a log line");
+UNIT_TEST(bench)
+{
+  uip_ipaddr_t addr;
+  linkaddr_t lladdr;
+  uint64_t start_ns;
+  uint64_t start_cycles;
+  uint64_t t_ns;
+  uint64_t t_cycles;
+  unsigned int calls;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  uip_ip6addr(&addr, 0xfe80, 0, 0, 0, 0x212, 0x7401, 1, 0x101);
+  memset(&lladdr, 0x12, sizeof(lladdr));
+
+  write_calls = 0;
+  start_ns = nsec_now();
+  start_cycles = cycles_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    out_len = 0;
+    LOG_INFO("Sending request %u to ", i);
+    LOG_INFO_6ADDR(&addr);
+    LOG_INFO_(" via ");
+    LOG_INFO_LLADDR(&lladdr);
+    LOG_INFO_(" rssi %d\n", -72);
+  }
+  t_cycles = cycles_now() - start_cycles;
+  t_ns = nsec_now() - start_ns;
+  calls = write_calls;
+
+  printf("%u byte log line: %lu cycles, %lu ns, %u writes\n", out_len,
+         (unsigned long)(t_cycles / BENCH_ROUNDS),
+         (unsigned long)(t_ns / BENCH_ROUNDS),
+         calls / BENCH_ROUNDS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_strformat_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(integers);
+  UNIT_TEST_RUN(strings);
+  UNIT_TEST_RUN(writes);
+  UNIT_TEST_RUN(addresses);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(integers) || !UNIT_TEST_PASSED(strings) ||
+     !UNIT_TEST_PASSED(writes) || !UNIT_TEST_PASSED(addresses) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
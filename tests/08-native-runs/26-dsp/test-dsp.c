@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the fixed-point DSP kernels, checked against a
+ *      double-precision DFT, and a benchmark against ifft().
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/dsp.h"
+#include "lib/ifft.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define FFT_SIZE          256
+#define BENCH_ROUNDS      20000
+/*****************************************************************************/
+PROCESS(test_dsp_process, "DSP test process");
+AUTOSTART_PROCESSES(&test_dsp_process);
+/*****************************************************************************/
+static int16_t x[2 * FFT_SIZE] __attribute__((aligned(4)));
+static int16_t in[2 * FFT_SIZE];
+static double ref_re[FFT_SIZE];
+static double ref_im[FFT_SIZE];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static uint64_t
+cycles_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+/*****************************************************************************/
+/* The DFT of n complex samples, scaled by 1 / n */
+static void
+reference_dft(const int16_t *samples, int complex_input, int n)
+{
+  double re, im, angle;
+  int k, i;
+
+  for(k = 0; k < n; k++) {
+    re = 0;
+    im = 0;
+    for(i = 0; i < n; i++) {
+      double s_re = complex_input ? samples[2 * i] : samples[i];
+      double s_im = complex_input ? samples[2 * i + 1] : 0;
+
+      angle = 2 * M_PI * (double)k * i / n;
+      re += s_re * cos(angle) + s_im * sin(angle);
+      im += s_im * cos(angle) - s_re * sin(angle);
+    }
+    ref_re[k] = re / n;
+    ref_im[k] = im / n;
+  }
+}
+/*****************************************************************************/
+static void
+random_samples(int16_t *samples, int count, int amplitude)
+{
+  int i;
+
+  for(i = 0; i < count; i++) {
+    samples[i] = (rand() % (2 * amplitude + 1)) - amplitude;
+  }
+}
+/*****************************************************************************/
+/* The FFTs saturate bins that do not fit, as the DFT of full-scale complex
+   samples may not */
+static double
+clamp16(double v)
+{
+  return fmin(fmax(v, INT16_MIN), INT16_MAX);
+}
+/*****************************************************************************/
+static double
+bin_error(int k, int16_t re, int16_t im)
+{
+  return fmax(fabs(clamp16(ref_re[k]) - re), fabs(clamp16(ref_im[k]) - im));
+}
+/*****************************************************************************/
+/* Full-scale samples: a tone, a random square wave, or an impulse. For
+   complex samples, the tone is a complex exponential. */
+static void
+full_scale_samples(int16_t *samples, int complex_input, int n, int shape)
+{
+  double angle;
+  int i;
+
+  memset(samples, 0, (complex_input ? 2 : 1) * n * sizeof(int16_t));
+  for(i = 0; i < n; i++) {
+    angle = 2 * M_PI * 3 * i / n + 0.3;
+    if(shape == 0 && complex_input) {
+      samples[2 * i] = (int16_t)lrint(32767 * cos(angle));
+      samples[2 * i + 1] = (int16_t)lrint(-32767 * sin(angle));
+    } else if(shape == 0) {
+      samples[i] = (int16_t)lrint(32767 * sin(angle));
+    } else if(shape == 1 && complex_input) {
+      samples[2 * i] = rand() & 1 ? INT16_MAX : INT16_MIN;
+      samples[2 * i + 1] = rand() & 1 ? INT16_MAX : INT16_MIN;
+    } else if(shape == 1) {
+      samples[i] = rand() & 1 ? INT16_MAX : INT16_MIN;
+    }
+  }
+  if(shape == 2) {
+    samples[complex_input ? 2 : 1] = INT16_MIN;
+    if(complex_input) {
+      samples[3] = INT16_MIN;
+    }
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(cfft, "Complex FFT against a DFT");
+UNIT_TEST(cfft)
+{
+  double err;
+  int n, k, round;
+
+  UNIT_TEST_BEGIN();
+
+  srand(1);
+  for(n = 2; n <= FFT_SIZE; n <<= 1) {
+    err = 0;
+    for(round = 0; round < 4; round++) {
+      random_samples(in, 2 * n, round == 0 ? 32767 : 1000);
+      memcpy(x, in, 2 * n * sizeof(int16_t));
+      UNIT_TEST_ASSERT(dsp_cfft(x, n) == 0);
+      reference_dft(in, 1, n);
+      for(k = 0; k < n; k++) {
+        err = fmax(err, bin_error(k, x[2 * k], x[2 * k + 1]));
+      }
+    }
+    printf("cfft %4d: max error %.2f LSB\n", n, err);
+    UNIT_TEST_ASSERT(err <= 1 + log2(n) / 2);
+  }
+
+  UNIT_TEST_ASSERT(dsp_cfft(x, 0) == -1);
+  UNIT_TEST_ASSERT(dsp_cfft(x, 1) == -1);
+  UNIT_TEST_ASSERT(dsp_cfft(x, 24) == -1);
+  UNIT_TEST_ASSERT(dsp_cfft(x, 2 * DSP_FFT_MAX_SIZE) == -1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(rfft, "Real FFT against a DFT");
+UNIT_TEST(rfft)
+{
+  double err;
+  int n, k, round;
+
+  UNIT_TEST_BEGIN();
+
+  srand(2);
+  for(n = 4; n <= FFT_SIZE; n <<= 1) {
+    err = 0;
+    for(round = 0; round < 4; round++) {
+      random_samples(in, n, round == 0 ? 32767 : 1000);
+      memcpy(x, in, n * sizeof(int16_t));
+      UNIT_TEST_ASSERT(dsp_rfft(x, n) == 0);
+      reference_dft(in, 0, n);
+      err = fmax(err, bin_error(0, x[0], 0));
+      err = fmax(err, bin_error(n / 2, x[1], 0));
+      for(k = 1; k < n / 2; k++) {
+        err = fmax(err, bin_error(k, x[2 * k], x[2 * k + 1]));
+      }
+    }
+    printf("rfft %4d: max error %.2f LSB\n", n, err);
+    UNIT_TEST_ASSERT(err <= 1 + log2(n) / 2);
+  }
+
+  UNIT_TEST_ASSERT(dsp_rfft(x, 2) == -1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(full_scale, "FFTs of full-scale samples");
+UNIT_TEST(full_scale)
+{
+  double cerr, rerr;
+  int n, k, shape;
+
+  UNIT_TEST_BEGIN();
+
+  srand(5);
+  for(n = 4; n <= FFT_SIZE; n <<= 1) {
+    cerr = 0;
+    rerr = 0;
+    for(shape = 0; shape < 3; shape++) {
+      full_scale_samples(in, 1, n, shape);
+      memcpy(x, in, 2 * n * sizeof(int16_t));
+      UNIT_TEST_ASSERT(dsp_cfft(x, n) == 0);
+      reference_dft(in, 1, n);
+      for(k = 0; k < n; k++) {
+        cerr = fmax(cerr, bin_error(k, x[2 * k], x[2 * k + 1]));
+      }
+
+      full_scale_samples(in, 0, n, shape);
+      memcpy(x, in, n * sizeof(int16_t));
+      UNIT_TEST_ASSERT(dsp_rfft(x, n) == 0);
+      reference_dft(in, 0, n);
+      rerr = fmax(rerr, bin_error(0, x[0], 0));
+      rerr = fmax(rerr, bin_error(n / 2, x[1], 0));
+      for(k = 1; k < n / 2; k++) {
+        rerr = fmax(rerr, bin_error(k, x[2 * k], x[2 * k + 1]));
+      }
+    }
+    printf("full scale %4d: max error %.2f LSB (cfft), %.2f LSB (rfft)\n",
+           n, cerr, rerr);
+    UNIT_TEST_ASSERT(cerr <= 1 + log2(n) / 2);
+    UNIT_TEST_ASSERT(rerr <= 1 + log2(n) / 2);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(spectrum, "Window, magnitude and power");
+UNIT_TEST(spectrum)
+{
+  uint16_t mag[FFT_SIZE / 2 + 1];
+  uint32_t power[FFT_SIZE / 2 + 1];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(dsp_sqrt(0) == 0);
+  UNIT_TEST_ASSERT(dsp_sqrt(15) == 3);
+  UNIT_TEST_ASSERT(dsp_sqrt(16) == 4);
+  UNIT_TEST_ASSERT(dsp_sqrt(2UL * 32768 * 32768) == 46340);
+
+  for(i = 0; i < FFT_SIZE; i++) {
+    x[i] = 10000;
+  }
+  dsp_window_hann(x, FFT_SIZE);
+  UNIT_TEST_ASSERT(x[0] == 0);
+  UNIT_TEST_ASSERT(x[FFT_SIZE / 2] == 9999);
+  UNIT_TEST_ASSERT(x[FFT_SIZE / 4] == x[3 * FFT_SIZE / 4]);
+  UNIT_TEST_ASSERT(abs(x[FFT_SIZE / 4] - 5000) <= 1);
+
+  /* A full-scale tone in bin 10 gives a single bin of half its amplitude */
+  for(i = 0; i < FFT_SIZE; i++) {
+    x[i] = (int16_t)lrint(32000 * cos(2 * M_PI * 10 * i / FFT_SIZE + 0.3));
+  }
+  dsp_rfft(x, FFT_SIZE);
+  dsp_magnitude(x, mag, FFT_SIZE);
+  dsp_power(x, power, FFT_SIZE);
+  UNIT_TEST_ASSERT(abs(mag[10] - 16000) <= 4);
+  UNIT_TEST_ASSERT(dsp_sqrt(power[10]) == mag[10]);
+  for(i = 0; i <= FFT_SIZE / 2; i++) {
+    if(i != 10) {
+      UNIT_TEST_ASSERT(mag[i] <= 2);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(psd, "Averaged PSD over a sample stream");
+UNIT_TEST(psd)
+{
+  static int16_t block[FFT_SIZE];
+  static uint32_t power[FFT_SIZE / 2 + 1];
+  static int16_t stream[1000];
+  struct dsp_psd psd;
+  uint16_t blocks = 0;
+  int i, chunk, peak;
+
+  UNIT_TEST_BEGIN();
+
+  srand(3);
+  dsp_psd_init(&psd, block, power, FFT_SIZE, 3);
+
+  /* A 40.5-bin tone in noise, fed in chunks that do not match blocks */
+  for(chunk = 0; chunk < 20; chunk++) {
+    for(i = 0; i < 1000; i++) {
+      int t = chunk * 1000 + i;
+      stream[i] = (int16_t)lrint(20000 * sin(2 * M_PI * 40.5 * t / FFT_SIZE))
+        + (rand() % 2001) - 1000;
+    }
+    blocks += dsp_psd_add(&psd, stream, 1000);
+  }
+  UNIT_TEST_ASSERT(blocks == 20000 / FFT_SIZE);
+  UNIT_TEST_ASSERT(psd.blocks == blocks);
+  UNIT_TEST_ASSERT(psd.fill == 20000 % FFT_SIZE);
+
+  /* The Hann window spreads the tone over bins 40 and 41 */
+  peak = 0;
+  for(i = 1; i <= FFT_SIZE / 2; i++) {
+    if(power[i] > power[peak]) {
+      peak = i;
+    }
+  }
+  UNIT_TEST_ASSERT(peak == 40 || peak == 41);
+  UNIT_TEST_ASSERT(power[40] > 100 * power[60]);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Cost of a 256-sample spectrum");
+UNIT_TEST(bench)
+{
+  static int16_t xre[FFT_SIZE];
+  static int16_t xim[FFT_SIZE];
+  uint16_t mag[FFT_SIZE / 2 + 1];
+  uint64_t start_ns, start_cycles;
+  uint64_t t_ns[3], t_cycles[3];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  srand(4);
+  random_samples(in, FFT_SIZE, 127);
+
+  start_ns = nsec_now();
+  start_cycles = cycles_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    memcpy(xre, in, sizeof(xre));
+    ifft(xre, xim, FFT_SIZE);
+  }
+  t_cycles[0] = cycles_now() - start_cycles;
+  t_ns[0] = nsec_now() - start_ns;
+
+  start_ns = nsec_now();
+  start_cycles = cycles_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    memcpy(x, in, FFT_SIZE * sizeof(int16_t));
+    dsp_rfft(x, FFT_SIZE);
+    dsp_magnitude(x, mag, FFT_SIZE);
+  }
+  t_cycles[1] = cycles_now() - start_cycles;
+  t_ns[1] = nsec_now() - start_ns;
+
+  start_ns = nsec_now();
+  start_cycles = cycles_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    memcpy(x, in, FFT_SIZE * sizeof(int16_t));
+    memset(x + FFT_SIZE, 0, FFT_SIZE * sizeof(int16_t));
+    dsp_cfft(x, FFT_SIZE);
+  }
+  t_cycles[2] = cycles_now() - start_cycles;
+  t_ns[2] = nsec_now() - start_ns;
+
+  printf("%d samples, per transform:\n", FFT_SIZE);
+  printf("  ifft() %lu cycles, %lu ns\n",
+         (unsigned long)(t_cycles[0] / BENCH_ROUNDS),
+         (unsigned long)(t_ns[0] / BENCH_ROUNDS));
+  printf("  dsp_rfft() and dsp_magnitude() %lu cycles, %lu ns\n",
+         (unsigned long)(t_cycles[1] / BENCH_ROUNDS),
+         (unsigned long)(t_ns[1] / BENCH_ROUNDS));
+  printf("  dsp_cfft() %lu cycles, %lu ns\n",
+         (unsigned long)(t_cycles[2] / BENCH_ROUNDS),
+         (unsigned long)(t_ns[2] / BENCH_ROUNDS));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_dsp_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(cfft);
+  UNIT_TEST_RUN(rfft);
+  UNIT_TEST_RUN(full_scale);
+  UNIT_TEST_RUN(spectrum);
+  UNIT_TEST_RUN(psd);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(cfft) || !UNIT_TEST_PASSED(rfft) ||
+     !UNIT_TEST_PASSED(full_scale) || !UNIT_TEST_PASSED(spectrum) ||
+     !UNIT_TEST_PASSED(psd) || !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the pseudo-random streams: reproducibility,
+ *      independence, bounded ranges and basic statistics, and a
+ *      benchmark against rand().
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define SAMPLES           (1UL << 20)
+#define BENCH_ROUNDS      (1UL << 22)
+
+/* Chi-square bounds for 255 degrees of freedom, p = 0.001 at either end */
+#define CHI2_255_LOW      190.0
+#define CHI2_255_HIGH     330.0
+/*****************************************************************************/
+PROCESS(test_random_process, "Random test process");
+AUTOSTART_PROCESSES(&test_random_process);
+/*****************************************************************************/
+static uint32_t counts[4][256];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static double
+chi_square(const uint32_t *observed, int buckets, double expected)
+{
+  double sum = 0;
+  int i;
+
+  for(i = 0; i < buckets; i++) {
+    sum += (observed[i] - expected) * (observed[i] - expected) / expected;
+  }
+  return sum;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(streams, "Reproducible and independent streams");
+UNIT_TEST(streams)
+{
+  uint32_t first[16];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  random_stream_init(42);
+  for(i = 0; i < 16; i++) {
+    first[i] = random_stream_rand(RANDOM_STREAM_CSMA);
+  }
+
+  /* Draws from other streams do not shift the CSMA sequence */
+  random_stream_init(42);
+  for(i = 0; i < 16; i++) {
+    random_stream_rand(RANDOM_STREAM_RPL);
+    random_stream_range(RANDOM_STREAM_TRICKLE, 1000);
+    random_rand();
+    UNIT_TEST_ASSERT(random_stream_rand(RANDOM_STREAM_CSMA) == first[i]);
+  }
+
+  /* Streams and seeds give different sequences */
+  random_stream_init(42);
+  UNIT_TEST_ASSERT(random_stream_rand(RANDOM_STREAM_TSCH) != first[0]);
+  random_stream_init(43);
+  UNIT_TEST_ASSERT(random_stream_rand(RANDOM_STREAM_CSMA) != first[0]);
+
+  /* random_init() seeds random_rand() and the streams */
+  random_init(7);
+  first[0] = random_rand();
+  first[1] = random_stream_rand(RANDOM_STREAM_CSMA);
+  random_init(7);
+  UNIT_TEST_ASSERT(random_rand() == first[0]);
+  UNIT_TEST_ASSERT(random_stream_rand(RANDOM_STREAM_CSMA) == first[1]);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(range, "Bounded ranges without modulo bias");
+UNIT_TEST(range)
+{
+  static const uint32_t bounds[] = { 1, 2, 3, 7, 10, 100, 1000, 65536,
+                                     0x80000001UL, 0xffffffffUL };
+  uint32_t buckets[3] = { 0 };
+  uint32_t v;
+  unsigned long i;
+  int b;
+
+  UNIT_TEST_BEGIN();
+
+  random_stream_init(1);
+  UNIT_TEST_ASSERT(random_stream_range(RANDOM_STREAM_DEFAULT, 0) == 0);
+  for(b = 0; b < sizeof(bounds) / sizeof(bounds[0]); b++) {
+    for(i = 0; i < 10000; i++) {
+      UNIT_TEST_ASSERT(random_stream_range(RANDOM_STREAM_DEFAULT, bounds[b])
+                       < bounds[b]);
+    }
+  }
+
+  /* With a bound of 3 * 2^30, x % bound would put half of the results in
+     the first third of the range. They should be spread evenly. */
+  for(i = 0; i < SAMPLES; i++) {
+    v = random_stream_range(RANDOM_STREAM_DEFAULT, 0xc0000000UL);
+    buckets[v >> 30]++;
+  }
+  printf("thirds of [0, 3 * 2^30): %lu %lu %lu\n", (unsigned long)buckets[0],
+         (unsigned long)buckets[1], (unsigned long)buckets[2]);
+  UNIT_TEST_ASSERT(chi_square(buckets, 3, SAMPLES / 3.0) < 13.8);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(statistics, "Byte frequencies and bit balance");
+UNIT_TEST(statistics)
+{
+  uint32_t rand16[256];
+  uint64_t ones = 0;
+  uint32_t v;
+  unsigned long i;
+  double chi2;
+  int byte;
+
+  UNIT_TEST_BEGIN();
+
+  memset(counts, 0, sizeof(counts));
+  random_stream_init(2);
+  for(i = 0; i < SAMPLES; i++) {
+    v = random_stream_rand(RANDOM_STREAM_RPL);
+    ones += __builtin_popcount(v);
+    for(byte = 0; byte < 4; byte++) {
+      counts[byte][(v >> (8 * byte)) & 0xff]++;
+    }
+  }
+  for(byte = 0; byte < 4; byte++) {
+    chi2 = chi_square(counts[byte], 256, SAMPLES / 256.0);
+    printf("byte %d: chi-square %.1f\n", byte, chi2);
+    UNIT_TEST_ASSERT(chi2 > CHI2_255_LOW && chi2 < CHI2_255_HIGH);
+  }
+
+  /* 32 * SAMPLES bits, with a standard deviation of 2896 ones */
+  printf("ones: %.5f of all bits\n", (double)ones / (32.0 * SAMPLES));
+  UNIT_TEST_ASSERT(ones > 16 * SAMPLES - 15000 && ones < 16 * SAMPLES + 15000);
+
+  /* The low byte of random_rand(), which is the weak part of an LCG */
+  memset(rand16, 0, sizeof(rand16));
+  for(i = 0; i < SAMPLES; i++) {
+    rand16[random_rand() & 0xff]++;
+  }
+  chi2 = chi_square(rand16, 256, SAMPLES / 256.0);
+  printf("random_rand() low byte: chi-square %.1f\n", chi2);
+  UNIT_TEST_ASSERT(chi2 > CHI2_255_LOW && chi2 < CHI2_255_HIGH);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Cost of a random number");
+UNIT_TEST(bench)
+{
+  volatile uint32_t sink = 0;
+  uint64_t start;
+  uint64_t t[4];
+  unsigned long i;
+
+  UNIT_TEST_BEGIN();
+
+  srand(1);
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    sink += (unsigned short)rand() % 1000;
+  }
+  t[0] = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    sink += random_rand() % 1000;
+  }
+  t[1] = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    sink += random_stream_rand(RANDOM_STREAM_CSMA);
+  }
+  t[2] = nsec_now() - start;
+
+  start = nsec_now();
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    sink += random_stream_range(RANDOM_STREAM_CSMA, 1000);
+  }
+  t[3] = nsec_now() - start;
+
+  printf("ps per number: rand() %% n %lu, random_rand() %% n %lu\n",
+         (unsigned long)(t[0] * 1000 / BENCH_ROUNDS),
+         (unsigned long)(t[1] * 1000 / BENCH_ROUNDS));
+  printf("  random_stream_rand() %lu, random_stream_range() %lu\n",
+         (unsigned long)(t[2] * 1000 / BENCH_ROUNDS),
+         (unsigned long)(t[3] * 1000 / BENCH_ROUNDS));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_random_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(streams);
+  UNIT_TEST_RUN(range);
+  UNIT_TEST_RUN(statistics);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(streams) || !UNIT_TEST_PASSED(range) ||
+     !UNIT_TEST_PASSED(statistics) || !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the trickle timer library with many concurrent
+ *      timers: fire times, interval doubling, stopping and resets, and
+ *      a benchmark of rescheduling.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/trickle-timer.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define TIMERS            64
+#define IMIN              16
+#define IMAX_DOUBLINGS    3
+#define RUN_TIME          (CLOCK_SECOND * 2)
+
+/* Nothing calls trickle_timer_consistency(), so no callback is suppressed */
+#define K                 1
+
+/* Ticks that a callback may run late on a busy native host */
+#define LATE_SLACK        8
+
+#define BENCH_ROUNDS      200
+#define BENCH_MAX_TIMERS  256
+/*****************************************************************************/
+PROCESS(test_trickle_process, "Trickle timer test process");
+AUTOSTART_PROCESSES(&test_trickle_process);
+/*****************************************************************************/
+static struct trickle_timer timers[BENCH_MAX_TIMERS];
+static struct trickle_timer stray;
+
+struct fire_stats {
+  unsigned long fired;
+  unsigned long early;
+  unsigned long late;
+  clock_time_t max_interval;
+};
+static struct fire_stats stats[TIMERS];
+static unsigned long fired_after_stop;
+static unsigned long stray_fired;
+static int stopping;
+static clock_time_t inconsistent_i_cur;
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+fired(void *ptr, uint8_t suppress)
+{
+  struct trickle_timer *tt = ptr;
+  struct fire_stats *s = &stats[tt - timers];
+  clock_time_t t = clock_time() - tt->i_start;
+
+  if(stopping) {
+    fired_after_stop++;
+    return;
+  }
+
+  s->fired++;
+  if(t < tt->i_cur / 2) {
+    s->early++;
+  }
+  if(t >= tt->i_cur + LATE_SLACK) {
+    s->late++;
+  }
+  if(tt->i_cur > s->max_interval) {
+    s->max_interval = tt->i_cur;
+  }
+}
+/*****************************************************************************/
+static void
+stray_cb(void *ptr, uint8_t suppress)
+{
+  stray_fired++;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fire_times, "Fire times of concurrent timers");
+UNIT_TEST(fire_times)
+{
+  unsigned long early = 0, late = 0, fired_total = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < TIMERS; i++) {
+    UNIT_TEST_ASSERT(stats[i].fired > 0);
+    UNIT_TEST_ASSERT(stats[i].max_interval == IMIN << IMAX_DOUBLINGS);
+    early += stats[i].early;
+    late += stats[i].late;
+    fired_total += stats[i].fired;
+  }
+  printf("%lu callbacks, %lu early, %lu late\n", fired_total, early, late);
+  UNIT_TEST_ASSERT(early == 0);
+  UNIT_TEST_ASSERT(late == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(stop_reset, "Stopping and resetting timers");
+UNIT_TEST(stop_reset)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(inconsistent_i_cur == IMIN);
+  UNIT_TEST_ASSERT(fired_after_stop == 0);
+  UNIT_TEST_ASSERT(stray_fired == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Cost of rescheduling");
+UNIT_TEST(bench)
+{
+  uint64_t start;
+  int n, i, round;
+
+  UNIT_TEST_BEGIN();
+
+  printf("sizeof(struct trickle_timer) %u\n",
+         (unsigned)sizeof(struct trickle_timer));
+
+  for(n = 8; n <= BENCH_MAX_TIMERS; n <<= 1) {
+    /* Long intervals, so that nothing fires while we measure */
+    for(i = 0; i < n; i++) {
+      trickle_timer_config(&timers[i], CLOCK_SECOND * 60, 2, K);
+      trickle_timer_set(&timers[i], stray_cb, NULL);
+    }
+
+    start = nsec_now();
+    for(round = 0; round < BENCH_ROUNDS; round++) {
+      for(i = 0; i < n; i++) {
+        trickle_timer_set(&timers[i], stray_cb, NULL);
+      }
+    }
+    printf("%3d timers: %lu ns per reschedule\n", n,
+           (unsigned long)((nsec_now() - start) / (BENCH_ROUNDS * n)));
+
+    for(i = 0; i < n; i++) {
+      trickle_timer_stop(&timers[i]);
+    }
+  }
+
+  UNIT_TEST_ASSERT(stray_fired == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_trickle_process, ev, data)
+{
+  static struct etimer et;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  /* A timer that is stopped before it ever fires */
+  trickle_timer_config(&stray, IMIN, IMAX_DOUBLINGS, K);
+  trickle_timer_set(&stray, stray_cb, NULL);
+
+  for(i = 0; i < TIMERS; i++) {
+    trickle_timer_config(&timers[i], IMIN, IMAX_DOUBLINGS, K);
+    trickle_timer_set(&timers[i], fired, &timers[i]);
+  }
+  trickle_timer_stop(&stray);
+
+  etimer_set(&et, RUN_TIME);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  /* All timers have reached Imax by now. Reset one of them. */
+  trickle_timer_inconsistency(&timers[0]);
+  inconsistent_i_cur = timers[0].i_cur;
+
+  stopping = 1;
+  for(i = 0; i < TIMERS; i++) {
+    trickle_timer_stop(&timers[i]);
+  }
+  etimer_set(&et, (IMIN << IMAX_DOUBLINGS) * 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(fire_times);
+  UNIT_TEST_RUN(stop_reset);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(fire_times) || !UNIT_TEST_PASSED(stop_reset) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the neighbor table: lookups, replacement of the
+ *      worst entry when full, and a benchmark of lookups against the
+ *      number of neighbors.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define CHURN_ROUNDS      2000
+#define BENCH_LOOKUPS     (1UL << 20)
+/*****************************************************************************/
+PROCESS(test_nbr_table_process, "Neighbor table test process");
+AUTOSTART_PROCESSES(&test_nbr_table_process);
+/*****************************************************************************/
+struct test_nbr {
+  uint32_t id;
+};
+NBR_TABLE(struct test_nbr, test_nbrs);
+
+/* The address of each neighbor in the table, by id */
+static linkaddr_t present[NBR_TABLE_MAX_NEIGHBORS];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+/* Addresses share a vendor prefix and differ in their last bytes, as
+ * EUI-64 addresses of a deployment typically do */
+static void
+make_lladdr(linkaddr_t *lladdr, uint32_t seq)
+{
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    lladdr->u8[i] = 0x12 + i;
+  }
+  lladdr->u8[LINKADDR_SIZE - 1] = seq;
+  lladdr->u8[LINKADDR_SIZE - 2] = seq >> 8;
+  lladdr->u8[LINKADDR_SIZE - 3] = seq >> 16;
+}
+/*****************************************************************************/
+/* Refills the table with n neighbors, numbered from 0 */
+static int
+fill(int n)
+{
+  struct test_nbr *nbr;
+  int i;
+
+  nbr_table_clear();
+  for(i = 0; i < n; i++) {
+    make_lladdr(&present[i], i);
+    nbr = nbr_table_add_lladdr(test_nbrs, &present[i],
+                               NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(nbr == NULL) {
+      return 0;
+    }
+    nbr->id = i;
+  }
+  return 1;
+}
+/*****************************************************************************/
+/* Checks that every neighbor on the key list is found by its address, and
+ * that the table holds exactly the expected neighbors */
+static int
+consistent(int n)
+{
+  nbr_table_key_t *key;
+  struct test_nbr *nbr;
+  int count = 0;
+  int i;
+
+  for(key = nbr_table_key_head(); key != NULL; key = nbr_table_key_next(key)) {
+    nbr = nbr_table_get_from_lladdr(test_nbrs, &key->lladdr);
+    if(nbr == NULL || nbr_table_get_lladdr(test_nbrs, nbr) != &key->lladdr) {
+      return 0;
+    }
+    count++;
+  }
+  if(count != n) {
+    return 0;
+  }
+  for(i = 0; i < n; i++) {
+    nbr = nbr_table_get_from_lladdr(test_nbrs, &present[i]);
+    if(nbr == NULL || nbr->id != i) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(lookup, "Add and look up neighbors");
+UNIT_TEST(lookup)
+{
+  linkaddr_t absent;
+  struct test_nbr *nbr;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(fill(NBR_TABLE_MAX_NEIGHBORS));
+  UNIT_TEST_ASSERT(consistent(NBR_TABLE_MAX_NEIGHBORS));
+  UNIT_TEST_ASSERT(nbr_table_count_entries() == NBR_TABLE_MAX_NEIGHBORS);
+
+  for(i = 0; i < 1000; i++) {
+    make_lladdr(&absent, NBR_TABLE_MAX_NEIGHBORS + i);
+    UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, &absent) == NULL);
+  }
+
+  /* Adding a present neighbor again returns its entry */
+  nbr = nbr_table_add_lladdr(test_nbrs, &present[3],
+                             NBR_TABLE_REASON_UNDEFINED, NULL);
+  UNIT_TEST_ASSERT(nbr == nbr_table_get_from_lladdr(test_nbrs, &present[3]));
+  nbr->id = 3;
+
+  /* The single entry without an address */
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, NULL) == NULL);
+  nbr = nbr_table_add_lladdr(test_nbrs, NULL, NBR_TABLE_REASON_UNDEFINED, NULL);
+  UNIT_TEST_ASSERT(nbr != NULL);
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, NULL) == nbr);
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, &linkaddr_null) == nbr);
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, NULL) == NULL);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(replacement, "Replacement of unlocked neighbors");
+UNIT_TEST(replacement)
+{
+  struct test_nbr *nbr;
+  linkaddr_t evicted;
+  uint32_t seq;
+  int victim;
+  int round;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(fill(NBR_TABLE_MAX_NEIGHBORS));
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    nbr_table_lock(test_nbrs,
+                   nbr_table_get_from_lladdr(test_nbrs, &present[i]));
+  }
+
+  /* When the table is full, a new neighbor must replace the only unlocked
+   * one, wherever it sits in the index */
+  seq = NBR_TABLE_MAX_NEIGHBORS;
+  for(round = 0; round < CHURN_ROUNDS; round++) {
+    victim = random_rand() % NBR_TABLE_MAX_NEIGHBORS;
+    nbr_table_unlock(test_nbrs,
+                     nbr_table_get_from_lladdr(test_nbrs, &present[victim]));
+
+    linkaddr_copy(&evicted, &present[victim]);
+    make_lladdr(&present[victim], seq++);
+    nbr = nbr_table_add_lladdr(test_nbrs, &present[victim],
+                               NBR_TABLE_REASON_UNDEFINED, NULL);
+    UNIT_TEST_ASSERT(nbr != NULL);
+    nbr->id = victim;
+    nbr_table_lock(test_nbrs, nbr);
+
+    UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, &evicted) == NULL);
+    if(round % 100 == 0) {
+      UNIT_TEST_ASSERT(consistent(NBR_TABLE_MAX_NEIGHBORS));
+    }
+  }
+  UNIT_TEST_ASSERT(consistent(NBR_TABLE_MAX_NEIGHBORS));
+
+  /* Nothing can be replaced when all neighbors are locked */
+  make_lladdr(&evicted, seq);
+  UNIT_TEST_ASSERT(nbr_table_add_lladdr(test_nbrs, &evicted,
+                                        NBR_TABLE_REASON_UNDEFINED,
+                                        NULL) == NULL);
+
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(nbr_table_key_head() == NULL);
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_nbrs, &present[0]) == NULL);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Cost of a lookup");
+UNIT_TEST(bench)
+{
+  volatile uintptr_t sink = 0;
+  linkaddr_t absent[16];
+  uint64_t start, hit, miss;
+  unsigned long i;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 16; i++) {
+    make_lladdr(&absent[i], 0x10000 + i);
+  }
+
+  for(n = 8; n <= NBR_TABLE_MAX_NEIGHBORS; n <<= 1) {
+    UNIT_TEST_ASSERT(fill(n));
+
+    start = nsec_now();
+    for(i = 0; i < BENCH_LOOKUPS; i++) {
+      sink += (uintptr_t)nbr_table_get_from_lladdr(test_nbrs,
+                                                   &present[i % n]);
+    }
+    hit = nsec_now() - start;
+
+    start = nsec_now();
+    for(i = 0; i < BENCH_LOOKUPS; i++) {
+      sink += (uintptr_t)nbr_table_get_from_lladdr(test_nbrs, &absent[i % 16]);
+    }
+    miss = nsec_now() - start;
+
+    printf("%3d neighbors: %lu ns per hit, %lu ns per miss\n", n,
+           (unsigned long)(hit / BENCH_LOOKUPS),
+           (unsigned long)(miss / BENCH_LOOKUPS));
+  }
+  nbr_table_clear();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_nbr_table_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  nbr_table_register(test_nbrs, NULL);
+
+  UNIT_TEST_RUN(lookup);
+  UNIT_TEST_RUN(replacement);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(lookup) || !UNIT_TEST_PASSED(replacement) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
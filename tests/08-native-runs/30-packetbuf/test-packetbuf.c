@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the packet buffer pool: held packets, copy-free
+ *      queueing and retransmission, fallback to copies, and a benchmark
+ *      of the link-layer forwarding path.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define FRAME_LEN         80
+#define MAC_HDR_LEN       23
+#define LONG_HDR_LEN      (PACKETBUF_SIZE - FRAME_LEN + MAC_HDR_LEN)
+#define QUEUE_DEPTH       4
+#define BENCH_PACKETS     (1UL << 20)
+/*****************************************************************************/
+PROCESS(test_packetbuf_process, "Packet buffer test process");
+AUTOSTART_PROCESSES(&test_packetbuf_process);
+/*****************************************************************************/
+static uint8_t radio_buf[PACKETBUF_SIZE];
+static uint8_t rx_frame[FRAME_LEN];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+make_receiver(linkaddr_t *addr, uint8_t seed)
+{
+  memset(addr, seed, sizeof(linkaddr_t));
+}
+/*****************************************************************************/
+/* Builds a packet as the network layer does, after a packetbuf_clear() */
+static void
+make_packet(uint8_t seed, uint16_t len)
+{
+  linkaddr_t receiver;
+  uint8_t *p;
+  int i;
+
+  packetbuf_clear();
+  p = packetbuf_dataptr();
+  for(i = 0; i < len; i++) {
+    p[i] = seed + i;
+  }
+  packetbuf_set_datalen(len);
+  make_receiver(&receiver, seed);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &receiver);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, seed);
+}
+/*****************************************************************************/
+static int
+packet_is(const uint8_t *p, uint16_t len, uint8_t seed, uint16_t expected)
+{
+  int i;
+
+  if(len != expected) {
+    return 0;
+  }
+  for(i = 0; i < len; i++) {
+    if(p[i] != (uint8_t)(seed + i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+static int
+queued_is(struct queuebuf *q, uint8_t seed, uint16_t len)
+{
+  linkaddr_t receiver;
+
+  make_receiver(&receiver, seed);
+  return packet_is(queuebuf_dataptr(q), queuebuf_datalen(q), seed, len)
+    && linkaddr_cmp(queuebuf_addr(q, PACKETBUF_ADDR_RECEIVER), &receiver)
+    && queuebuf_attr(q, PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) == seed;
+}
+/*****************************************************************************/
+/* Frames the current packet and hands it to the radio, as CSMA does */
+static void
+transmit(void)
+{
+  uint8_t *hdr;
+
+  packetbuf_hdralloc(MAC_HDR_LEN);
+  hdr = packetbuf_hdrptr();
+  memset(hdr, 0x41, MAC_HDR_LEN);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+  memcpy(radio_buf, packetbuf_hdrptr(), packetbuf_totlen());
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(queueing, "Queue, retransmit and free packets");
+UNIT_TEST(queueing)
+{
+  struct queuebuf *q[QUEUE_DEPTH];
+  struct queuebuf *stripped;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < QUEUE_DEPTH; i++) {
+    make_packet(i, FRAME_LEN - i);
+    q[i] = queuebuf_hold_packetbuf();
+    UNIT_TEST_ASSERT(q[i] != NULL);
+    /* The packetbuf still holds the packet until the next one starts */
+    UNIT_TEST_ASSERT(packet_is(packetbuf_dataptr(), packetbuf_datalen(),
+                               i, FRAME_LEN - i));
+  }
+
+  /* Another packet goes through the packetbuf meanwhile */
+  make_packet(100, FRAME_LEN);
+  for(i = 0; i < QUEUE_DEPTH; i++) {
+    UNIT_TEST_ASSERT(queued_is(q[i], i, FRAME_LEN - i));
+  }
+
+  /* Each transmission frames the packet as it was queued */
+  for(i = 0; i < 3; i++) {
+    queuebuf_to_packetbuf(q[1]);
+    UNIT_TEST_ASSERT(packetbuf_hdrlen() == 0);
+    UNIT_TEST_ASSERT(packet_is(packetbuf_dataptr(), packetbuf_datalen(),
+                               1, FRAME_LEN - 1));
+    transmit();
+    UNIT_TEST_ASSERT(packetbuf_totlen() == FRAME_LEN - 1 + MAC_HDR_LEN);
+    UNIT_TEST_ASSERT(packet_is(radio_buf + MAC_HDR_LEN, packetbuf_datalen(),
+                               1, FRAME_LEN - 1));
+    queuebuf_update_attr_from_packetbuf(q[1]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_attr(q[1], PACKETBUF_ATTR_MAC_ACK) == 1);
+  UNIT_TEST_ASSERT(queued_is(q[1], 1, FRAME_LEN - 1));
+
+  /* A header larger than the headroom moves the packet, but not the queued
+   * one */
+  queuebuf_to_packetbuf(q[2]);
+  UNIT_TEST_ASSERT(packetbuf_hdralloc(PACKETBUF_HEADROOM + 4));
+  memset(packetbuf_hdrptr(), 0x42, PACKETBUF_HEADROOM + 4);
+  UNIT_TEST_ASSERT(packet_is(packetbuf_dataptr(), packetbuf_datalen(),
+                             2, FRAME_LEN - 2));
+  UNIT_TEST_ASSERT(queued_is(q[2], 2, FRAME_LEN - 2));
+
+  /* A packet changed in place after packetbuf_unshare() */
+  queuebuf_to_packetbuf(q[3]);
+#if PACKETBUF_POOL_NUM
+  packetbuf_unshare();
+#endif /* PACKETBUF_POOL_NUM */
+  memset(packetbuf_dataptr(), 0, packetbuf_datalen());
+  UNIT_TEST_ASSERT(queued_is(q[3], 3, FRAME_LEN - 3));
+
+  /* A packet held after its header was stripped starts beyond the
+   * headroom, yet a header that fills the buffer must still fit */
+  make_packet(4, FRAME_LEN);
+  packetbuf_hdrreduce(MAC_HDR_LEN);
+  stripped = queuebuf_hold_packetbuf();
+  UNIT_TEST_ASSERT(stripped != NULL);
+  queuebuf_to_packetbuf(stripped);
+  UNIT_TEST_ASSERT(packetbuf_hdralloc(LONG_HDR_LEN));
+  memset(packetbuf_hdrptr(), 0x43, LONG_HDR_LEN);
+  UNIT_TEST_ASSERT(packetbuf_totlen() == PACKETBUF_SIZE);
+  UNIT_TEST_ASSERT(packet_is(packetbuf_dataptr(), packetbuf_datalen(),
+                             4 + MAC_HDR_LEN, FRAME_LEN - MAC_HDR_LEN));
+  UNIT_TEST_ASSERT(packet_is(queuebuf_dataptr(stripped),
+                             queuebuf_datalen(stripped),
+                             4 + MAC_HDR_LEN, FRAME_LEN - MAC_HDR_LEN));
+  queuebuf_free(stripped);
+
+  /* The packetbuf keeps a freed packet until the next one starts */
+  queuebuf_to_packetbuf(q[0]);
+  for(i = 0; i < QUEUE_DEPTH; i++) {
+    queuebuf_free(q[i]);
+  }
+  UNIT_TEST_ASSERT(packet_is(packetbuf_dataptr(), packetbuf_datalen(),
+                             0, FRAME_LEN));
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(exhaustion, "Copies when the pool is exhausted");
+UNIT_TEST(exhaustion)
+{
+  struct queuebuf *q[QUEUEBUF_NUM];
+  struct queuebuf *copy;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    make_packet(i, FRAME_LEN);
+    q[i] = queuebuf_hold_packetbuf();
+    UNIT_TEST_ASSERT(q[i] != NULL);
+  }
+
+  /* The queue is full. Beyond the first PACKETBUF_POOL_NUM - 1 packets,
+   * the packets were copied. */
+  copy = queuebuf_hold_packetbuf();
+  UNIT_TEST_ASSERT(copy == NULL);
+
+  make_packet(200, FRAME_LEN);
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    UNIT_TEST_ASSERT(queued_is(q[i], i, FRAME_LEN));
+    queuebuf_to_packetbuf(q[i]);
+    transmit();
+    UNIT_TEST_ASSERT(packet_is(radio_buf + MAC_HDR_LEN, FRAME_LEN,
+                               i, FRAME_LEN));
+  }
+
+  /* Copies are independent from the packetbuf */
+  make_packet(201, FRAME_LEN);
+  queuebuf_free(q[0]);
+  copy = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(copy != NULL);
+  memset(packetbuf_dataptr(), 0, FRAME_LEN);
+  UNIT_TEST_ASSERT(queued_is(copy, 201, FRAME_LEN));
+  queuebuf_free(copy);
+
+  for(i = 1; i < QUEUEBUF_NUM; i++) {
+    queuebuf_free(q[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+/* Puts a received frame in the packetbuf, as a radio driver does */
+static void
+receive(void)
+{
+  linkaddr_t receiver;
+
+  make_receiver(&receiver, 1);
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), rx_frame, FRAME_LEN);
+  packetbuf_set_datalen(FRAME_LEN);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &receiver);
+}
+/*****************************************************************************/
+/* Forwards packets through a MAC queue with one retransmission each.
+ * Returns the time taken, in ns. */
+static uint64_t
+forward(struct queuebuf *(*enqueue)(void))
+{
+  struct queuebuf *q[QUEUE_DEPTH];
+  unsigned long i;
+  uint64_t start;
+  int slot;
+
+  memset(q, 0, sizeof(q));
+  start = nsec_now();
+  for(i = 0; i < BENCH_PACKETS; i++) {
+    slot = i % QUEUE_DEPTH;
+    if(q[slot] != NULL) {
+      /* The oldest packet is sent twice, then freed */
+      queuebuf_to_packetbuf(q[slot]);
+      transmit();
+      queuebuf_update_attr_from_packetbuf(q[slot]);
+      queuebuf_to_packetbuf(q[slot]);
+      transmit();
+      queuebuf_free(q[slot]);
+    }
+    receive();
+    q[slot] = enqueue();
+  }
+  for(slot = 0; slot < QUEUE_DEPTH; slot++) {
+    queuebuf_free(q[slot]);
+  }
+  return nsec_now() - start;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Forwarding throughput");
+UNIT_TEST(bench)
+{
+  uint64_t copied, held;
+
+  UNIT_TEST_BEGIN();
+
+  copied = forward(queuebuf_new_from_packetbuf);
+  held = forward(queuebuf_hold_packetbuf);
+
+  printf("PACKETBUF_POOL_NUM %u, headroom %u\n",
+         PACKETBUF_POOL_NUM, PACKETBUF_HEADROOM);
+  printf("kpackets/s: copied %lu, held %lu\n",
+         (unsigned long)(BENCH_PACKETS * 1000000 / copied),
+         (unsigned long)(BENCH_PACKETS * 1000000 / held));
+#if PACKETBUF_POOL_NUM
+  printf("holds %lu, selects %lu, hold failures %lu, unshares %lu\n",
+         (unsigned long)packetbuf_pool_stats.holds,
+         (unsigned long)packetbuf_pool_stats.selects,
+         (unsigned long)packetbuf_pool_stats.hold_failures,
+         (unsigned long)packetbuf_pool_stats.unshares);
+#endif /* PACKETBUF_POOL_NUM */
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_packetbuf_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(queueing);
+  UNIT_TEST_RUN(exhaustion);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(queueing) || !UNIT_TEST_PASSED(exhaustion) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the compact attribute storage of queuebuf: attributes
+ *      and addresses survive queueing, packets whose attributes do not fit
+ *      are refused, and a benchmark of queueing and dequeueing.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define FRAME_LEN         80
+#define BENCH_PACKETS     (1UL << 18)
+#define BENCH_ROUNDS      8
+/*****************************************************************************/
+PROCESS(test_queuebuf_process, "Queuebuf test process");
+AUTOSTART_PROCESSES(&test_queuebuf_process);
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static packetbuf_attr_t
+attr_value(uint8_t seed, uint8_t type)
+{
+  return (seed << 8) + type * 3 + 1;
+}
+/*****************************************************************************/
+/* Builds a packet of len bytes. Every attribute of a type multiple of step
+ * is set, the others are left zero. */
+static void
+make_packet(uint8_t seed, uint16_t len, int step)
+{
+  linkaddr_t addr;
+  uint8_t *p;
+  int i;
+
+  packetbuf_clear();
+  p = packetbuf_dataptr();
+  for(i = 0; i < len; i++) {
+    p[i] = seed + i;
+  }
+  packetbuf_set_datalen(len);
+  for(i = 1; i < PACKETBUF_NUM_ATTRS; i++) {
+    if(i % step == 0) {
+      packetbuf_set_attr(i, attr_value(seed, i));
+    }
+  }
+  memset(&addr, seed, sizeof(addr));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  memset(&addr, seed + 1, sizeof(addr));
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &addr);
+}
+/*****************************************************************************/
+static int
+num_attrs(int step)
+{
+  return (PACKETBUF_NUM_ATTRS - 1) / step;
+}
+/*****************************************************************************/
+static int
+data_is(const uint8_t *p, uint16_t len, uint8_t seed, uint16_t expected)
+{
+  int i;
+
+  if(len != expected) {
+    return 0;
+  }
+  for(i = 0; i < len; i++) {
+    if(p[i] != (uint8_t)(seed + i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+static int
+queued_is(struct queuebuf *q, uint8_t seed, uint16_t len, int step)
+{
+  linkaddr_t addr;
+  int i;
+
+  if(!data_is(queuebuf_dataptr(q), queuebuf_datalen(q), seed, len)) {
+    return 0;
+  }
+  for(i = 1; i < PACKETBUF_NUM_ATTRS; i++) {
+    if(queuebuf_attr(q, i) != (i % step == 0 ? attr_value(seed, i) : 0)) {
+      return 0;
+    }
+  }
+  memset(&addr, seed, sizeof(addr));
+  if(!linkaddr_cmp(queuebuf_addr(q, PACKETBUF_ADDR_RECEIVER), &addr)) {
+    return 0;
+  }
+  memset(&addr, seed + 1, sizeof(addr));
+  return linkaddr_cmp(queuebuf_addr(q, PACKETBUF_ADDR_SENDER), &addr);
+}
+/*****************************************************************************/
+static int
+packetbuf_is(uint8_t seed, uint16_t len, int step)
+{
+  linkaddr_t addr;
+  int i;
+
+  if(!data_is(packetbuf_dataptr(), packetbuf_datalen(), seed, len)) {
+    return 0;
+  }
+  for(i = 1; i < PACKETBUF_NUM_ATTRS; i++) {
+    if(packetbuf_attr(i) != (i % step == 0 ? attr_value(seed, i) : 0)) {
+      return 0;
+    }
+  }
+  memset(&addr, seed, sizeof(addr));
+  return linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &addr);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(attributes, "Attributes survive queueing");
+UNIT_TEST(attributes)
+{
+  struct queuebuf *q[4];
+  static const int steps[4] = { 1, 2, 5, PACKETBUF_ATTR_MAX };
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 4; i++) {
+    make_packet(i, FRAME_LEN - i, steps[i]);
+    q[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(q[i] != NULL);
+  }
+
+  packetbuf_clear();
+  for(i = 0; i < 4; i++) {
+    UNIT_TEST_ASSERT(queued_is(q[i], i, FRAME_LEN - i, steps[i]));
+    queuebuf_to_packetbuf(q[i]);
+    UNIT_TEST_ASSERT(packetbuf_is(i, FRAME_LEN - i, steps[i]));
+  }
+
+  /* A retransmission sets more attributes, then updates the queued copy */
+  queuebuf_to_packetbuf(q[2]);
+  for(i = 1; i < PACKETBUF_NUM_ATTRS; i++) {
+    packetbuf_set_attr(i, attr_value(2, i));
+  }
+  queuebuf_update_attr_from_packetbuf(q[2]);
+  UNIT_TEST_ASSERT(queued_is(q[2], 2, FRAME_LEN - 2, 1));
+
+  /* And clears some */
+  queuebuf_to_packetbuf(q[0]);
+  for(i = 1; i < PACKETBUF_NUM_ATTRS; i++) {
+    if(i % 2 != 0) {
+      packetbuf_set_attr(i, 0);
+    }
+  }
+  queuebuf_update_attr_from_packetbuf(q[0]);
+  UNIT_TEST_ASSERT(queued_is(q[0], 0, FRAME_LEN, 2));
+
+  for(i = 0; i < 4; i++) {
+    queuebuf_free(q[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(limits, "Full-size packets");
+UNIT_TEST(limits)
+{
+  struct queuebuf *q;
+  struct queuebuf *full[QUEUEBUF_FULL_ATTRS_NUM + 1];
+  int step;
+  int i, j;
+
+  UNIT_TEST_BEGIN();
+
+  /* QUEUEBUF_ATTRS_NUM attributes always fit */
+  for(step = 1; num_attrs(step) > QUEUEBUF_ATTRS_NUM; step++);
+  make_packet(7, PACKETBUF_SIZE, step);
+  q = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(q != NULL);
+  UNIT_TEST_ASSERT(queued_is(q, 7, PACKETBUF_SIZE, step));
+  queuebuf_free(q);
+
+  /* More fit in a shorter packet */
+  make_packet(8, PACKETBUF_SIZE - 2 * num_attrs(1), 1);
+  q = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(q != NULL);
+  UNIT_TEST_ASSERT(queued_is(q, 8, PACKETBUF_SIZE - 2 * num_attrs(1), 1));
+  queuebuf_free(q);
+
+  /* Or take a full attribute array, as long as there is one left */
+  for(i = 0; i <= QUEUEBUF_FULL_ATTRS_NUM; i++) {
+    make_packet(9 + i, PACKETBUF_SIZE, 1);
+    full[i] = queuebuf_new_from_packetbuf();
+  }
+  for(i = 0; i < QUEUEBUF_FULL_ATTRS_NUM; i++) {
+    UNIT_TEST_ASSERT(full[i] != NULL);
+    UNIT_TEST_ASSERT(queued_is(full[i], 9 + i, PACKETBUF_SIZE, 1));
+    queuebuf_to_packetbuf(full[i]);
+    UNIT_TEST_ASSERT(packetbuf_is(9 + i, PACKETBUF_SIZE, 1));
+  }
+#if QUEUEBUF_COMPACT_ATTRS
+  UNIT_TEST_ASSERT(num_attrs(1) <= QUEUEBUF_ATTRS_NUM
+                   || full[QUEUEBUF_FULL_ATTRS_NUM] == NULL);
+#else /* QUEUEBUF_COMPACT_ATTRS */
+  UNIT_TEST_ASSERT(full[QUEUEBUF_FULL_ATTRS_NUM] != NULL);
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+  queuebuf_free(full[QUEUEBUF_FULL_ATTRS_NUM]);
+
+  /* An update that fits again gives the array back */
+  queuebuf_to_packetbuf(full[0]);
+  for(j = 1; j < PACKETBUF_NUM_ATTRS; j++) {
+    if(j % step != 0) {
+      packetbuf_set_attr(j, 0);
+    }
+  }
+  queuebuf_update_attr_from_packetbuf(full[0]);
+  UNIT_TEST_ASSERT(queued_is(full[0], 9, PACKETBUF_SIZE, step));
+  make_packet(9 + QUEUEBUF_FULL_ATTRS_NUM, PACKETBUF_SIZE, 1);
+  full[QUEUEBUF_FULL_ATTRS_NUM] = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(full[QUEUEBUF_FULL_ATTRS_NUM] != NULL);
+  UNIT_TEST_ASSERT(queued_is(full[QUEUEBUF_FULL_ATTRS_NUM],
+                             9 + QUEUEBUF_FULL_ATTRS_NUM,
+                             PACKETBUF_SIZE, 1));
+
+  for(i = 0; i <= QUEUEBUF_FULL_ATTRS_NUM; i++) {
+    queuebuf_free(full[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(bench, "Queueing throughput");
+UNIT_TEST(bench)
+{
+  struct queuebuf *q;
+  unsigned long i;
+  uint64_t start, elapsed, best;
+  int round;
+
+  UNIT_TEST_BEGIN();
+
+  /* A typical CSMA frame: frame type, retransmissions, sequence number and
+   * acknowledgement request */
+  packetbuf_clear();
+  packetbuf_set_datalen(FRAME_LEN);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, 1);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, 7);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 42);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+
+  /* The best of several rounds */
+  best = UINT64_MAX;
+  for(round = 0; round < BENCH_ROUNDS; round++) {
+    start = nsec_now();
+    for(i = 0; i < BENCH_PACKETS; i++) {
+      q = queuebuf_new_from_packetbuf();
+      queuebuf_to_packetbuf(q);
+      queuebuf_free(q);
+    }
+    elapsed = nsec_now() - start;
+    if(elapsed < best) {
+      best = elapsed;
+    }
+  }
+
+  printf("QUEUEBUF_COMPACT_ATTRS %u, QUEUEBUF_ATTRS_NUM %u, "
+         "PACKETBUF_NUM_ATTRS %u\n", QUEUEBUF_COMPACT_ATTRS,
+         QUEUEBUF_ATTRS_NUM, PACKETBUF_NUM_ATTRS);
+  printf("%lu ns per queued packet\n",
+         (unsigned long)(best / BENCH_PACKETS));
+  UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == 42);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_queuebuf_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(attributes);
+  UNIT_TEST_RUN(limits);
+  UNIT_TEST_RUN(bench);
+
+  if(!UNIT_TEST_PASSED(attributes) || !UNIT_TEST_PASSED(limits) ||
+     !UNIT_TEST_PASSED(bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the queuebuf swap: a queue much deeper than RAM
+ *      allows, filled while the link is down and drained once it is back,
+ *      updates and frees out of order, and a queue refilled after frees
+ *      that left live packets in every segment.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#ifndef NUM_PACKETS
+#define NUM_PACKETS       10000
+#endif
+#define MIN_LEN           40
+#define MAX_LEN           100
+/*****************************************************************************/
+PROCESS(test_queuebuf_swap_process, "Queuebuf swap test process");
+AUTOSTART_PROCESSES(&test_queuebuf_swap_process);
+/*****************************************************************************/
+static struct queuebuf *queue[QUEUEBUF_NUM];
+/*****************************************************************************/
+static uint64_t
+nsec_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static uint16_t
+packet_len(unsigned seq)
+{
+  return MIN_LEN + seq % (MAX_LEN - MIN_LEN + 1);
+}
+/*****************************************************************************/
+/* Builds packet number seq in the packetbuf */
+static void
+make_packet(unsigned seq)
+{
+  linkaddr_t receiver;
+  uint8_t *p;
+  int i;
+
+  packetbuf_clear();
+  p = packetbuf_dataptr();
+  for(i = 0; i < packet_len(seq); i++) {
+    p[i] = seq + i;
+  }
+  packetbuf_set_datalen(packet_len(seq));
+  memset(&receiver, seq, sizeof(receiver));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &receiver);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seq);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, 3);
+}
+/*****************************************************************************/
+/* Checks that the packetbuf holds packet number seq */
+static int
+packetbuf_is(unsigned seq)
+{
+  linkaddr_t receiver;
+  const uint8_t *p;
+  int i;
+
+  if(packetbuf_datalen() != packet_len(seq)
+     || packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) != (uint16_t)seq
+     || packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) != 3) {
+    return 0;
+  }
+  p = packetbuf_dataptr();
+  for(i = 0; i < packet_len(seq); i++) {
+    if(p[i] != (uint8_t)(seq + i)) {
+      return 0;
+    }
+  }
+  memset(&receiver, seq, sizeof(receiver));
+  return linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &receiver);
+}
+/*****************************************************************************/
+/* Checks queued packet number seq without making it current */
+static int
+queued_is(struct queuebuf *q, unsigned seq)
+{
+  const uint8_t *p;
+  int i;
+
+  if(queuebuf_datalen(q) != packet_len(seq)
+     || queuebuf_attr(q, PACKETBUF_ATTR_MAC_SEQNO) != (uint16_t)seq) {
+    return 0;
+  }
+  p = queuebuf_dataptr(q);
+  for(i = 0; i < packet_len(seq); i++) {
+    if(p[i] != (uint8_t)(seq + i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+/* The number of swap segment files in CFS */
+static int
+num_segment_files(void)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  int n;
+
+  n = 0;
+  if(cfs_opendir(&dir, ".") == 0) {
+    while(cfs_readdir(&dir, &dirent) == 0) {
+      if(strncmp(dirent.name, "qbuf.", 5) == 0) {
+        n++;
+      }
+    }
+    cfs_closedir(&dir);
+  }
+  return n;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(link_down, "Queue 10k packets while the link is down");
+UNIT_TEST(link_down)
+{
+  unsigned i;
+  uint64_t start, queued, drained;
+  int files;
+
+  UNIT_TEST_BEGIN();
+
+  memset(&queuebuf_swap_stats, 0, sizeof(queuebuf_swap_stats));
+
+  start = nsec_now();
+  for(i = 0; i < NUM_PACKETS; i++) {
+    make_packet(i);
+    queue[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(queue[i] != NULL);
+  }
+  queued = nsec_now() - start;
+  files = num_segment_files();
+
+  /* All but the newest QUEUEBUFRAM_NUM packets went to CFS, in batches */
+  UNIT_TEST_ASSERT(queuebuf_swap_stats.records
+                   == NUM_PACKETS - QUEUEBUFRAM_NUM);
+  UNIT_TEST_ASSERT(queuebuf_swap_stats.writes
+                   <= queuebuf_swap_stats.records / QUEUEBUF_SWAP_BATCH
+                   + files);
+  UNIT_TEST_ASSERT(queued_is(queue[0], 0));
+  UNIT_TEST_ASSERT(queued_is(queue[NUM_PACKETS - 1], NUM_PACKETS - 1));
+
+  /* The link is back: the packets go out in order */
+  start = nsec_now();
+  for(i = 0; i < NUM_PACKETS; i++) {
+    queuebuf_to_packetbuf(queue[i]);
+    UNIT_TEST_ASSERT(packetbuf_is(i));
+    queuebuf_free(queue[i]);
+  }
+  drained = nsec_now() - start;
+
+  printf("%u packets, %d segment files, %lu records in %lu writes, "
+         "%lu reads\n", NUM_PACKETS, files,
+         (unsigned long)queuebuf_swap_stats.records,
+         (unsigned long)queuebuf_swap_stats.writes,
+         (unsigned long)queuebuf_swap_stats.reads);
+  printf("queued %lu ns per packet, drained %lu ns per packet\n",
+         (unsigned long)(queued / NUM_PACKETS),
+         (unsigned long)(drained / NUM_PACKETS));
+
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(num_segment_files() == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(out_of_order, "Update and free swapped packets");
+UNIT_TEST(out_of_order)
+{
+  unsigned i;
+  unsigned n = 1000;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < n; i++) {
+    make_packet(i);
+    queue[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(queue[i] != NULL);
+  }
+
+  /* A retransmission updates the attributes of a swapped packet */
+  queuebuf_to_packetbuf(queue[10]);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 4321);
+  queuebuf_update_attr_from_packetbuf(queue[10]);
+  make_packet(0);
+  UNIT_TEST_ASSERT(queuebuf_attr(queue[10], PACKETBUF_ATTR_MAC_SEQNO)
+                   == 4321);
+  queuebuf_to_packetbuf(queue[10]);
+  UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == 4321);
+  queuebuf_free(queue[10]);
+  queue[10] = NULL;
+
+  /* Frees in any order, then more packets */
+  for(i = 0; i < n; i += 3) {
+    queuebuf_free(queue[i]);
+    queue[i] = NULL;
+  }
+  for(i = 0; i < n; i += 3) {
+    make_packet(i);
+    queue[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(queue[i] != NULL);
+  }
+
+  for(i = n; i > 0; i--) {
+    if(queue[i - 1] != NULL) {
+      UNIT_TEST_ASSERT(queued_is(queue[i - 1], i - 1));
+      queuebuf_to_packetbuf(queue[i - 1]);
+      UNIT_TEST_ASSERT(packetbuf_is(i - 1));
+      queuebuf_free(queue[i - 1]);
+    }
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(num_segment_files() == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(refill, "Refill the queue after scattered frees");
+UNIT_TEST(refill)
+{
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  memset(&queuebuf_swap_stats, 0, sizeof(queuebuf_swap_stats));
+
+  /* Every 30th packet stays queued, in every segment */
+  for(i = 0; i < NUM_PACKETS; i++) {
+    make_packet(i);
+    queue[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(queue[i] != NULL);
+  }
+  for(i = 0; i < NUM_PACKETS; i++) {
+    if(i % 30 != 0) {
+      queuebuf_free(queue[i]);
+      queue[i] = NULL;
+    }
+  }
+
+  /* All queuebufs can be used again */
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    if(queue[i] == NULL) {
+      make_packet(i);
+      queue[i] = queuebuf_new_from_packetbuf();
+      UNIT_TEST_ASSERT(queue[i] != NULL);
+    }
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == 0);
+  UNIT_TEST_ASSERT(queuebuf_swap_stats.cleanings > 0);
+
+  printf("%u packets queued, %lu segments cleaned\n", QUEUEBUF_NUM,
+         (unsigned long)queuebuf_swap_stats.cleanings);
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    UNIT_TEST_ASSERT(queued_is(queue[i], i));
+    queuebuf_to_packetbuf(queue[i]);
+    UNIT_TEST_ASSERT(packetbuf_is(i));
+    queuebuf_free(queue[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(num_segment_files() == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_queuebuf_swap_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(link_down);
+  UNIT_TEST_RUN(out_of_order);
+  UNIT_TEST_RUN(refill);
+
+  if(!UNIT_TEST_PASSED(link_down) || !UNIT_TEST_PASSED(out_of_order)
+     || !UNIT_TEST_PASSED(refill)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/*
+ * \file
+ *      Unit tests for the link quality estimators of link-stats: accuracy
+ *      on stationary links, and parent changes and delivery ratio of a
+ *      node that selects the best of two links, MRHOF-style. The links
+ *      and the parent selection are simulated here; the results are not
+ *      those of RPL Lite in Cooja.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/link-stats.h"
+#include "net/packetbuf.h"
+#include "net/mac/mac.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define ETX(x)            ((x) * LINK_STATS_ETX_DIVISOR)
+/* Transmissions per packet, as with the CSMA default of 7 retransmissions */
+#define MAX_TX            8
+/* Freshness counter limit of link-stats */
+#define FRESHNESS_MAX     16
+/* PRR of the links, in 1/1000 */
+#define PRR_SCALE         1000
+/* Hysteresis of MRHOF, in ETX */
+#define SWITCH_THRESHOLD  (ETX(3) / 2)
+/* The node probes the link to its other neighbor every PROBE_PERIOD packets */
+#define PROBE_PERIOD      8
+#define PARENT_RUNS       50
+#define PARENT_ROUNDS     2000
+#define LQI_LOW           60
+#define LQI_HIGH          110
+/*****************************************************************************/
+PROCESS(test_link_stats_process, "Link stats test process");
+AUTOSTART_PROCESSES(&test_link_stats_process);
+/*****************************************************************************/
+static const struct link_stats_estimator *const estimators[] = {
+  &link_stats_estimator_ewma,
+  &link_stats_estimator_packet_count,
+  &link_stats_estimator_window,
+  &link_stats_estimator_kalman,
+};
+#define NUM_ESTIMATORS (sizeof(estimators) / sizeof(estimators[0]))
+/*****************************************************************************/
+/* A link we have heard from once, with the given RSSI */
+static void
+new_link(const struct link_stats_estimator *e, struct link_stats *stats,
+         int16_t rssi)
+{
+  memset(stats, 0, sizeof(*stats));
+  stats->rssi = rssi;
+  e->packet_input(stats, rssi, LQI_LOW);
+}
+/*****************************************************************************/
+/* Sends a packet over a link with the given PRR, and updates the link as
+ * link_stats_packet_sent() does. Returns non-zero if the packet was ACKed. */
+static int
+send(const struct link_stats_estimator *e, struct link_stats *stats, int prr)
+{
+  int numtx;
+
+  for(numtx = 1; numtx <= MAX_TX; numtx++) {
+    if(random_rand() % PRR_SCALE < prr) {
+      break;
+    }
+  }
+
+  stats->last_tx_time = clock_time();
+  stats->freshness = MIN(stats->freshness + MIN(numtx, MAX_TX), FRESHNESS_MAX);
+  if(numtx > MAX_TX) {
+    e->packet_sent(stats, MAC_TX_NOACK, MAX_TX);
+    return 0;
+  }
+  e->packet_sent(stats, MAC_TX_OK, numtx);
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(accuracy, "ETX of stationary links");
+UNIT_TEST(accuracy)
+{
+  static const int prrs[] = { 900, 700, 500, 300 };
+  struct link_stats stats;
+  uint32_t error;
+  uint16_t etx;
+  int i, j, k;
+
+  UNIT_TEST_BEGIN();
+
+  printf("%-12s  PRR   ETX  error\n", "estimator");
+  for(i = 0; i < NUM_ESTIMATORS; i++) {
+    random_init(1);
+    for(j = 0; j < sizeof(prrs) / sizeof(prrs[0]); j++) {
+      etx = ETX(PRR_SCALE) / prrs[j];
+      new_link(estimators[i], &stats, -70);
+      error = 0;
+      for(k = 0; k < 300; k++) {
+        send(estimators[i], &stats, prrs[j]);
+        if(k >= 100) {
+          error += ABS((int)stats.etx - etx);
+        }
+      }
+      /* Mean error over the last 200 packets, in percent */
+      error = error * 100 / 200 / etx;
+      printf("%-12s  %3d  %u.%02u  %4lu%%\n", estimators[i]->name,
+             prrs[j], etx / LINK_STATS_ETX_DIVISOR,
+             (etx % LINK_STATS_ETX_DIVISOR) * 100 / LINK_STATS_ETX_DIVISOR,
+             (unsigned long)error);
+      /* With a PRR of 300, the no-ACK penalty makes the ETX higher */
+      UNIT_TEST_ASSERT(prrs[j] < 500 || error <= 15);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+/* A node sends PARENT_ROUNDS packets to its parent, one of two neighbors
+ * of the given PRRs, and probes the other one every PROBE_PERIOD packets.
+ * It switches parent when the other neighbor is better by more than
+ * SWITCH_THRESHOLD. If prr_after is non-zero, the link to neighbor 0
+ * changes to that PRR after PARENT_ROUNDS / 2 packets. */
+struct parent_result {
+  uint32_t changes;
+  uint32_t reaction;
+  uint32_t sent;
+  uint32_t delivered;
+};
+static void
+parent_run(const struct link_stats_estimator *e, int prr0, int prr1,
+           int prr_after, struct parent_result *result)
+{
+  struct link_stats links[2];
+  int prr[2] = { prr0, prr1 };
+  int parent, other;
+  int round;
+
+  new_link(e, &links[0], -70);
+  new_link(e, &links[1], -70);
+  /* Probe both neighbors until their statistics are fresh, as RPL Lite
+   * does before it selects a parent */
+  while(!link_stats_is_fresh(&links[0]) || !link_stats_is_fresh(&links[1])) {
+    send(e, &links[0], prr[0]);
+    send(e, &links[1], prr[1]);
+  }
+  parent = links[1].etx < links[0].etx;
+
+  for(round = 0; round < PARENT_ROUNDS; round++) {
+    if(prr_after != 0 && round == PARENT_ROUNDS / 2) {
+      prr[0] = prr_after;
+    }
+    result->delivered += send(e, &links[parent], prr[parent]);
+    result->sent++;
+    other = 1 - parent;
+    if(round % PROBE_PERIOD == 0) {
+      send(e, &links[other], prr[other]);
+    }
+    if(links[other].etx + SWITCH_THRESHOLD < links[parent].etx) {
+      parent = other;
+      result->changes++;
+    }
+    if(prr_after != 0 && round >= PARENT_ROUNDS / 2 && parent == 1
+       && result->reaction == 0) {
+      result->reaction = round - PARENT_ROUNDS / 2 + 1;
+    }
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(parent, "Parent changes and delivery ratio");
+UNIT_TEST(parent)
+{
+  struct parent_result similar, degraded;
+  uint32_t changes[NUM_ESTIMATORS];
+  uint32_t reaction;
+  int i, run;
+
+  UNIT_TEST_BEGIN();
+
+  /* Per run: parent changes between two similar lossy links, parent
+   * changes and packets until the switch when the link to the parent
+   * degrades, and delivery ratio over both */
+  printf("%-12s  similar  degraded  reaction  delivery\n", "estimator");
+  for(i = 0; i < NUM_ESTIMATORS; i++) {
+    random_init(2);
+    memset(&similar, 0, sizeof(similar));
+    memset(&degraded, 0, sizeof(degraded));
+    reaction = 0;
+    for(run = 0; run < PARENT_RUNS; run++) {
+      parent_run(estimators[i], 450, 400, 0, &similar);
+      degraded.reaction = 0;
+      parent_run(estimators[i], 700, 500, 200, &degraded);
+      /* The node must leave the degraded link */
+      reaction += degraded.reaction > 0 ? degraded.reaction : PARENT_ROUNDS;
+    }
+    printf("%-12s  %7.2f  %8.2f  %8lu  %7.2f%%\n", estimators[i]->name,
+           (double)similar.changes / PARENT_RUNS,
+           (double)degraded.changes / PARENT_RUNS,
+           (unsigned long)reaction / PARENT_RUNS,
+           (double)(similar.delivered + degraded.delivered) * 100
+           / (similar.sent + degraded.sent));
+    UNIT_TEST_ASSERT(reaction / PARENT_RUNS <= 100);
+    changes[i] = similar.changes;
+  }
+
+  /* The window and Kalman estimators are meant to flap less than EWMA */
+  UNIT_TEST_ASSERT(changes[2] < changes[0]);
+  UNIT_TEST_ASSERT(changes[3] < changes[0]);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(phy, "RSSI and LQI in the Kalman estimator");
+UNIT_TEST(phy)
+{
+  const struct link_stats_estimator *e = &link_stats_estimator_kalman;
+  struct link_stats low, high;
+  int low_count, high_count;
+  uint16_t etx;
+
+  UNIT_TEST_BEGIN();
+
+  /* A weak link is a poor one, until its RSSI improves. The RSSI is
+   * trusted more when receptions have a high LQI. */
+  new_link(e, &low, -89);
+  new_link(e, &high, -89);
+  UNIT_TEST_ASSERT(low.etx >= ETX(3));
+  low.rssi = high.rssi = -60;
+  for(low_count = 0; low.etx > ETX(2); low_count++) {
+    e->packet_input(&low, -60, LQI_LOW);
+    UNIT_TEST_ASSERT(low_count < 100);
+  }
+  for(high_count = 0; high.etx > ETX(2); high_count++) {
+    e->packet_input(&high, -60, LQI_HIGH);
+    UNIT_TEST_ASSERT(high_count < 100);
+  }
+  printf("ETX below 2 after %d receptions with low LQI, %d with high LQI\n",
+         low_count, high_count);
+  UNIT_TEST_ASSERT(high_count < low_count);
+
+  /* Once transmissions tell the ETX, receptions no longer change it */
+  random_init(3);
+  while(!link_stats_is_fresh(&high)) {
+    send(e, &high, 500);
+  }
+  etx = high.etx;
+  high.rssi = -89;
+  e->packet_input(&high, -89, LQI_LOW);
+  UNIT_TEST_ASSERT(high.etx == etx);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(api, "Statistics of neighbors");
+UNIT_TEST(api)
+{
+  static const linkaddr_t sent_to = { { 0x10, 0x01 } };
+  static const linkaddr_t heard = { { 0x10, 0x02 } };
+  const struct link_stats *stats;
+  uint16_t etx;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Estimator: %s\n", LINK_STATS_ESTIMATOR.name);
+
+  /* Failed transmissions do not add neighbors */
+  link_stats_packet_sent(&sent_to, MAC_TX_NOACK, MAX_TX);
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&sent_to) == NULL);
+
+  /* A perfect link */
+  for(i = 0; i < 50; i++) {
+    link_stats_packet_sent(&sent_to, MAC_TX_OK, 1);
+  }
+  stats = link_stats_from_lladdr(&sent_to);
+  UNIT_TEST_ASSERT(stats != NULL);
+  UNIT_TEST_ASSERT(link_stats_get_lladdr(stats) != NULL);
+  UNIT_TEST_ASSERT(linkaddr_cmp(link_stats_get_lladdr(stats), &sent_to));
+  UNIT_TEST_ASSERT(link_stats_is_fresh(stats));
+  UNIT_TEST_ASSERT(stats->etx >= ETX(1) && stats->etx < ETX(5) / 4);
+
+  /* Collisions and drops do not change the ETX */
+  etx = stats->etx;
+  link_stats_packet_sent(&sent_to, MAC_TX_COLLISION, 3);
+  link_stats_packet_sent(&sent_to, MAC_TX_QUEUE_FULL, 0);
+  UNIT_TEST_ASSERT(stats->etx == etx);
+
+  /* Neighbors we hear from get an RSSI and an initial ETX */
+  packetbuf_clear();
+  packetbuf_set_attr(PACKETBUF_ATTR_RSSI, -75);
+  packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY, LQI_HIGH);
+  link_stats_input_callback(&heard);
+  stats = link_stats_from_lladdr(&heard);
+  UNIT_TEST_ASSERT(stats != NULL);
+  UNIT_TEST_ASSERT(stats->rssi == -75);
+  UNIT_TEST_ASSERT(stats->etx >= ETX(1) && stats->etx <= ETX(3));
+  UNIT_TEST_ASSERT(!link_stats_is_fresh(stats));
+
+  link_stats_reset();
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&sent_to) == NULL);
+  UNIT_TEST_ASSERT(link_stats_from_lladdr(&heard) == NULL);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_link_stats_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(accuracy);
+  UNIT_TEST_RUN(parent);
+  UNIT_TEST_RUN(phy);
+  UNIT_TEST_RUN(api);
+
+  if(!UNIT_TEST_PASSED(accuracy) || !UNIT_TEST_PASSED(parent) ||
+     !UNIT_TEST_PASSED(phy) || !UNIT_TEST_PASSED(api)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2026, RISE Research Institutes of Sweden.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+# 3. Neither the name of the Institute nor the names of its contributors
+#    may be used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+# OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+# OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGE.
+
+"""Decode the records of the Contiki-NG binary logging backend.
+
+Reads a serial log, in which the records appear as lines that start
+with "#L:" followed by the record in hexadecimal, and prints the log
+messages as the text backend would have printed them. The module
+names and format strings are read from the firmware ELF file. All
+other lines are passed through unchanged.
+
+Usage: decode-log.py [-t] firmware.elf [serial.log]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LINE_PREFIX = "#L:"
+CONTINUATION = 0x80
+BASE_SYMBOL = "log_binary_base"
+LEVELS = {0: "PRI", 1: "ERR", 2: "WARN", 3: "INFO", 4: "DBG"}
+
+SHF_ALLOC = 0x2
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+
+
+class Elf:
+    """The minimal subset of an ELF reader needed to find strings."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+        self.is64 = self.data[4] == 2
+        self.endian = "<" if self.data[5] == 1 else ">"
+        if self.is64:
+            shoff, = self.unpack("Q", 0x28)
+            shentsize, shnum = self.unpack("HH", 0x3a)
+        else:
+            shoff, = self.unpack("I", 0x20)
+            shentsize, shnum = self.unpack("HH", 0x2e)
+        self.sections = []
+        for i in range(shnum):
+            offset = shoff + i * shentsize
+            if self.is64:
+                (name, type, flags, addr, off, size, link, info, align,
+                 entsize) = self.unpack("IIQQQQIIQQ", offset)
+            else:
+                (name, type, flags, addr, off, size, link, info, align,
+                 entsize) = self.unpack("IIIIIIIIII", offset)
+            self.sections.append((type, flags, addr, off, size, link,
+                                  entsize))
+
+    def unpack(self, fmt, offset):
+        fmt = self.endian + fmt
+        return struct.unpack_from(fmt, self.data, offset)
+
+    def symbol(self, wanted):
+        for type, flags, addr, off, size, link, entsize in self.sections:
+            if type != SHT_SYMTAB:
+                continue
+            strtab = self.sections[link][3]
+            for entry in range(off, off + size, entsize):
+                if self.is64:
+                    name, info, other, shndx, value, _ = \
+                        self.unpack("IBBHQQ", entry)
+                else:
+                    name, value, _, info, other, shndx = \
+                        self.unpack("IIIBBH", entry)
+                end = self.data.index(b"\0", strtab + name)
+                if self.data[strtab + name:end].decode() == wanted:
+                    return value
+        raise ValueError("symbol %s not found; was the firmware built "
+                         "with LOG_CONF_WITH_BINARY?" % wanted)
+
+    def string(self, addr):
+        for type, flags, start, off, size, link, entsize in self.sections:
+            if (flags & SHF_ALLOC and type != SHT_NOBITS and
+                    start <= addr < start + size):
+                pos = off + addr - start
+                end = self.data.index(b"\0", pos)
+                return self.data[pos:end].decode(errors="replace")
+        return "<unknown string at 0x%x>" % addr
+
+
+class Record:
+    """A record, from which arguments are taken in order."""
+
+    def __init__(self, endian, data):
+        self.endian = endian
+        self.data = data
+        (self.length, self.flags, self.timestamp, self.module,
+         self.fmt) = struct.unpack_from(endian + "BBIii", data, 0)
+        self.pos = 14
+
+    def take(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            return None
+        value, = struct.unpack_from(self.endian + fmt, self.data, self.pos)
+        self.pos += size
+        return value
+
+    def take_string(self):
+        end = self.data.find(b"\0", self.pos)
+        if end < 0:
+            return None
+        value = self.data[self.pos:end].decode(errors="replace")
+        self.pos = end + 1
+        return value
+
+
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?"
+                  r"(hh|h|ll|l|L|q|j|z|t)?([diuoxXcpfFeEgGaAsn%])")
+
+
+def format_message(fmt, record):
+    """Format a message in the same way as printf on the target."""
+
+    def convert(match):
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        if width == "*":
+            width = record.take("i")
+            if width is None:
+                return "<?>"
+        if precision == "*":
+            precision = record.take("i")
+            if precision is None:
+                return "<?>"
+        spec = "%" + flags + (str(width) if width is not None else "")
+        if precision is not None:
+            spec += "." + str(precision)
+
+        if conversion in "diuoxXc":
+            if length in (None, "h", "hh"):
+                value = record.take("i")
+            else:
+                value = record.take("q")
+            if value is None:
+                return "<?>"
+            bits = {"hh": 8, "h": 16, None: 32}.get(length, 64)
+            if conversion in "di":
+                value &= (1 << bits) - 1
+                if value >= 1 << (bits - 1):
+                    value -= 1 << bits
+                return (spec + "d") % value
+            value &= (1 << bits) - 1
+            if conversion == "c":
+                return (spec + "c") % chr(value)
+            return (spec + conversion.replace("u", "d")) % value
+        if conversion == "p":
+            value = record.take("Q")
+            return "<?>" if value is None else (spec + "s") % hex(value)
+        if conversion in "fFeEgGaA":
+            value = record.take("d")
+            if value is None:
+                return "<?>"
+            if conversion in "aA":
+                return (spec + "s") % value.hex()
+            return (spec + conversion) % value
+        if conversion == "s":
+            value = record.take_string()
+            return "<?>" if value is None else (spec + "s") % value
+        return ""
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode(elf, base, line, timestamps):
+    data = bytes.fromhex(line[len(LINE_PREFIX):].strip())
+    record = Record(elf.endian, data)
+    if record.fmt == 0:
+        text = "%u log records dropped\n" % record.take("I")
+    else:
+        text = format_message(elf.string(base + record.fmt), record)
+
+    if record.flags & CONTINUATION:
+        return text
+
+    level = record.flags & ~CONTINUATION
+    module = elf.string(base + record.module) if record.module else "LOG"
+    prefix = "[%-4s: %-10s] " % (LEVELS.get(level, "?"), module)
+    if timestamps:
+        prefix = "%10u " % record.timestamp + prefix
+    return prefix + text
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode Contiki-NG binary log records.")
+    parser.add_argument("-t", "--timestamps", action="store_true",
+                        help="prefix messages with the rtimer timestamp")
+    parser.add_argument("elf", help="the firmware ELF file")
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin,
+                        help="the serial log (default: standard input)")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    base = elf.symbol(BASE_SYMBOL)
+    for line in args.log:
+        start = line.find(LINE_PREFIX)
+        if start < 0:
+            sys.stdout.write(line)
+            continue
+        if start > 0:
+            sys.stdout.write(line[:start])
+        sys.stdout.write(decode(elf, base, line[start:], args.timestamps))
+
+
+if __name__ == "__main__":
+    main()
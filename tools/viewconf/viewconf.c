@@ -5,6 +5,7 @@
 #include "os/net/ipv6/uipopt.h"
 #include "os/net/queuebuf.h"
 #include "os/net/nbr-table.h"
+#include "os/net/link-stats.h"
 #include "os/sys/log-conf.h"
 #include "os/sys/energest.h"
 
@@ -110,6 +111,32 @@
 ##### "QUEUEBUF_CONF_NUM": _____________________ -> QUEUEBUF_NUM
 #endif
 
+#ifdef QUEUEBUF_CONF_COMPACT_ATTRS
+##### "QUEUEBUF_CONF_COMPACT_ATTRS": ___________ == QUEUEBUF_CONF_COMPACT_ATTRS
+#else
+##### "QUEUEBUF_CONF_COMPACT_ATTRS": ___________ -> QUEUEBUF_COMPACT_ATTRS
+#endif
+
+#if QUEUEBUF_COMPACT_ATTRS
+#ifdef QUEUEBUF_CONF_ATTRS_NUM
+##### "QUEUEBUF_CONF_ATTRS_NUM": _______________ == QUEUEBUF_CONF_ATTRS_NUM
+#else
+##### "QUEUEBUF_CONF_ATTRS_NUM": _______________ -> QUEUEBUF_ATTRS_NUM
+#endif
+
+#ifdef QUEUEBUF_CONF_FULL_ATTRS_NUM
+##### "QUEUEBUF_CONF_FULL_ATTRS_NUM": __________ == QUEUEBUF_CONF_FULL_ATTRS_NUM
+#else
+##### "QUEUEBUF_CONF_FULL_ATTRS_NUM": __________ -> QUEUEBUF_FULL_ATTRS_NUM
+#endif
+#endif /* QUEUEBUF_COMPACT_ATTRS */
+
+#ifdef LINK_STATS_CONF_ESTIMATOR
+##### "LINK_STATS_CONF_ESTIMATOR": _____________ == LINK_STATS_CONF_ESTIMATOR
+#else
+##### "LINK_STATS_CONF_ESTIMATOR": _____________ -> LINK_STATS_ESTIMATOR
+#endif
+
 #ifdef NBR_TABLE_CONF_MAX_NEIGHBORS
 ##### "NBR_TABLE_CONF_MAX_NEIGHBORS": __________ == NBR_TABLE_CONF_MAX_NEIGHBORS
 #else